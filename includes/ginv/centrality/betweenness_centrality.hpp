@@ -0,0 +1,140 @@
+#ifndef BETWEENNESS_CENTRALITY_HPP_
+#define BETWEENNESS_CENTRALITY_HPP_
+
+#include <algorithm>
+#include <cstdint>
+#include <numeric>
+#include <random>
+#include <vector>
+
+#include <ginv/parallel/parallel_for.hpp>
+#include <osigma/oconnection_index.hpp>
+
+namespace centrality {
+
+// Brandes betweenness over shortest paths by hop count, accumulated from `sample_count` random sources
+// and scaled by n / sample_count; with sample_count >= n it is exact. On an undirected (Both) index
+// every pair is seen from both ends, so the result is halved as for undirected graphs.
+template <typename TQ, typename TId, typename TValue>
+std::vector<TQ> sampled_betweenness_centrality(
+    const ograph::OConnectionIndex<TId, TValue>& index,
+    size_t sample_count,
+    uint64_t seed = 2605,
+    size_t thread_count = 0)
+{
+
+    size_t node_count = index.node_count();
+    sample_count = std::min(sample_count, node_count);
+
+    std::vector<TId> sources(node_count);
+    std::iota(sources.begin(), sources.end(), TId(0));
+
+    std::mt19937_64 random(seed);
+
+    for (size_t i = 0; i < sample_count; i++) {
+
+        std::uniform_int_distribution<size_t> distribution(i, node_count - 1);
+        std::swap(sources[i], sources[distribution(random)]);
+    }
+
+    size_t threads = parallel::resolve_thread_count(thread_count);
+    std::vector<std::vector<TQ>> partial_results(threads);
+
+    parallel::parallel_for_ranges(
+        0, sample_count,
+        [&](size_t begin, size_t end, size_t thread_id) {
+            std::vector<TQ>& result = partial_results[thread_id];
+            std::vector<int64_t> distances(node_count, -1);
+            std::vector<TQ> path_counts(node_count, 0);
+            std::vector<TQ> dependencies(node_count, 0);
+            std::vector<TId> order;
+
+            result.assign(node_count, 0);
+            order.reserve(node_count);
+
+            for (size_t s = begin; s < end; s++) {
+
+                TId source = sources[s];
+
+                order.clear();
+                order.push_back(source);
+                distances[source] = 0;
+                path_counts[source] = 1;
+
+                for (size_t head = 0; head < order.size(); head++) {
+
+                    TId v = order[head];
+
+                    for (TId w : index.neighbours(v)) {
+
+                        if (distances[w] < 0) {
+
+                            distances[w] = distances[v] + 1;
+                            order.push_back(w);
+                        }
+
+                        if (distances[w] == distances[v] + 1) {
+
+                            path_counts[w] += path_counts[v];
+                        }
+                    }
+                }
+
+                for (size_t q = order.size(); q-- > 0;) {
+
+                    TId v = order[q];
+                    TQ dependency = 0;
+
+                    for (TId w : index.neighbours(v)) {
+
+                        if (distances[w] == distances[v] + 1) {
+
+                            dependency += path_counts[v] / path_counts[w] * (1 + dependencies[w]);
+                        }
+                    }
+
+                    dependencies[v] = dependency;
+
+                    if (v != source) {
+
+                        result[v] += dependency;
+                    }
+                }
+
+                for (TId v : order) {
+
+                    distances[v] = -1;
+                    path_counts[v] = 0;
+                    dependencies[v] = 0;
+                }
+            }
+        },
+        threads, 1);
+
+    TQ scale = sample_count > 0 ? TQ(node_count) / TQ(sample_count) : TQ(0);
+
+    if (index.m_direction == ograph::ConnectionDirection::Both) {
+
+        scale /= 2;
+    }
+
+    std::vector<TQ> result(node_count, 0);
+
+    for (auto& partial_result : partial_results) {
+
+        for (size_t v = 0; v < partial_result.size(); v++) {
+
+            result[v] += partial_result[v];
+        }
+    }
+
+    for (auto& value : result) {
+
+        value *= scale;
+    }
+
+    return result;
+}
+}
+
+#endif
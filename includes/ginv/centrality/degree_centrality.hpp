@@ -0,0 +1,39 @@
+#ifndef DEGREE_CENTRALITY_HPP_
+#define DEGREE_CENTRALITY_HPP_
+
+#include <vector>
+
+#include <ginv/parallel/parallel_for.hpp>
+#include <osigma/oconnection_index.hpp>
+
+namespace centrality {
+
+// Sum of the connection weights of every node in the index direction, divided by n - 1 when normalized
+template <typename TQ, typename TId, typename TValue>
+std::vector<TQ> weighted_degree_centrality(const ograph::OConnectionIndex<TId, TValue>& index, bool normalized = true, size_t thread_count = 0)
+{
+
+    size_t node_count = index.node_count();
+    TQ scale = (normalized && node_count > 1) ? TQ(1) / TQ(node_count - 1) : TQ(1);
+
+    std::vector<TQ> result(node_count);
+
+    parallel::parallel_for(
+        0, node_count,
+        [&](size_t v) {
+            TQ sum = 0;
+
+            for (auto value : index.values(v)) {
+
+                sum += TQ(value);
+            }
+
+            result[v] = sum * scale;
+        },
+        thread_count, 4096);
+
+    return result;
+}
+}
+
+#endif
@@ -0,0 +1,167 @@
+#ifndef PAGERANK_HPP_
+#define PAGERANK_HPP_
+
+#include <cmath>
+#include <span>
+#include <stdexcept>
+#include <tuple>
+#include <vector>
+
+#include <ginv/parallel/parallel_for.hpp>
+#include <osigma/oconnection_index.hpp>
+#include <osigma/ograph.hpp>
+
+namespace centrality {
+
+// Weighted PageRank pulled over incoming connections: a node passes its rank to its targets in proportion
+// to the connection weights, and the rank of nodes without outgoing weight is spread over all nodes.
+// Stops when the L1 change of the ranks falls below `tolerance`; returns the ranks and the iteration count.
+template <typename TQ, typename TId, typename TValue>
+std::tuple<std::vector<TQ>, size_t> pagerank(
+    const ograph::OConnectionIndex<TId, TValue>& incoming,
+    TQ damping = 0.85,
+    TQ tolerance = 1e-6,
+    size_t max_iterations = 100,
+    size_t thread_count = 0)
+{
+
+    if (incoming.m_direction == ograph::ConnectionDirection::Outgoing) {
+
+        throw std::invalid_argument("pagerank needs an incoming or undirected connection index");
+    }
+
+    size_t node_count = incoming.node_count();
+
+    if (node_count == 0) {
+
+        return std::make_tuple(std::vector<TQ>(), size_t(0));
+    }
+
+    std::vector<TQ> out_weights(node_count, 0);
+
+    for (size_t v = 0; v < node_count; v++) {
+
+        auto neighbours = incoming.neighbours(v);
+        auto values = incoming.values(v);
+
+        for (size_t q = 0; q < neighbours.size(); q++) {
+
+            out_weights[neighbours[q]] += TQ(values[q]);
+        }
+    }
+
+    size_t threads = parallel::resolve_thread_count(thread_count);
+    size_t min_range_size = 4096;
+
+    std::vector<TQ> ranks(node_count, TQ(1) / TQ(node_count));
+    std::vector<TQ> next_ranks(node_count);
+    std::vector<TQ> contributions(node_count);
+    std::vector<TQ> partial_sums(threads);
+
+    size_t iteration = 0;
+
+    while (iteration < max_iterations) {
+
+        iteration++;
+
+        std::fill(partial_sums.begin(), partial_sums.end(), TQ(0));
+
+        parallel::parallel_for_ranges(
+            0, node_count,
+            [&](size_t begin, size_t end, size_t thread_id) {
+                TQ dangling = 0;
+
+                for (size_t u = begin; u < end; u++) {
+
+                    if (out_weights[u] > 0) {
+
+                        contributions[u] = ranks[u] / out_weights[u];
+                    } else {
+
+                        contributions[u] = 0;
+                        dangling += ranks[u];
+                    }
+                }
+
+                partial_sums[thread_id] = dangling;
+            },
+            threads, min_range_size);
+
+        TQ dangling = 0;
+
+        for (auto sum : partial_sums) {
+
+            dangling += sum;
+        }
+
+        TQ base = (TQ(1) - damping + damping * dangling) / TQ(node_count);
+
+        std::fill(partial_sums.begin(), partial_sums.end(), TQ(0));
+
+        parallel::parallel_for_ranges(
+            0, node_count,
+            [&](size_t begin, size_t end, size_t thread_id) {
+                TQ change = 0;
+
+                for (size_t v = begin; v < end; v++) {
+
+                    auto neighbours = incoming.neighbours(v);
+                    auto values = incoming.values(v);
+                    TQ sum = 0;
+
+                    for (size_t q = 0; q < neighbours.size(); q++) {
+
+                        sum += contributions[neighbours[q]] * TQ(values[q]);
+                    }
+
+                    next_ranks[v] = base + damping * sum;
+                    change += std::abs(next_ranks[v] - ranks[v]);
+                }
+
+                partial_sums[thread_id] = change;
+            },
+            threads, min_range_size);
+
+        ranks.swap(next_ranks);
+
+        TQ change = 0;
+
+        for (auto sum : partial_sums) {
+
+            change += sum;
+        }
+
+        if (change < tolerance) {
+
+            break;
+        }
+    }
+
+    return std::make_tuple(std::move(ranks), iteration);
+}
+
+template <
+    typename TQ,
+    template <typename> typename TAllocator,
+    typename TId,
+    typename TConnectionWeight,
+    typename TCoordinates,
+    typename TZIndex,
+    typename... TNodeFeatures>
+std::tuple<std::vector<TQ>, size_t> pagerank(
+    const ograph::BasicOGraph<TAllocator, TId, TConnectionWeight, TCoordinates, TZIndex, TNodeFeatures...>& graph,
+    bool directed = true,
+    TQ damping = 0.85,
+    TQ tolerance = 1e-6,
+    size_t max_iterations = 100,
+    size_t thread_count = 0)
+{
+
+    auto incoming = ograph::create_connection_index(
+        graph.node_count(), graph.m_connections, directed ? ograph::ConnectionDirection::Incoming : ograph::ConnectionDirection::Both);
+
+    return pagerank<TQ>(incoming, damping, tolerance, max_iterations, thread_count);
+}
+}
+
+#endif
@@ -0,0 +1,40 @@
+#ifndef ASYNC_CLUSTERING_HPP_
+#define ASYNC_CLUSTERING_HPP_
+
+#include <future>
+#include <vector>
+
+#include <ginv/clustering/clauset_newman_moore.hpp>
+#include <ginv/clustering/run_control.hpp>
+#include <ginv/parallel/work_stealing_pool.hpp>
+#include <osigma/ograph.hpp>
+
+namespace clustering {
+
+// Clusters the graph as one task of the pool, by default the shared library pool. Each task runs its
+// phases on a single thread, so many concurrent requests keep every worker busy without oversubscribing.
+// The graph is moved into the task; a run control, when given, has to outlive it.
+template <
+    typename TQ,
+    typename TMergeHeap = ExactMergeHeap,
+    template <typename> typename TAllocator,
+    typename TId,
+    typename TConnectionWeight,
+    typename TCoordinates,
+    typename TZIndex,
+    typename... TNodeFeatures>
+std::future<std::vector<std::vector<TId>>> greedy_modularity_communities_async(
+    ograph::BasicOGraph<TAllocator, TId, TConnectionWeight, TCoordinates, TZIndex, TNodeFeatures...> graph,
+    TQ resolution = 1.0f,
+    size_t cutoff = 1,
+    parallel::WorkStealingPool& pool = parallel::default_work_stealing_pool(),
+    RunControl<TQ>* run_control = nullptr)
+{
+
+    return pool.submit([graph = std::move(graph), resolution, cutoff, run_control]() mutable {
+        return greedy_modularity_communities<TQ, TMergeHeap>(std::move(graph), resolution, cutoff, false, TQ(-2605), 1, NoInstrumentation(), run_control);
+    });
+}
+}
+
+#endif
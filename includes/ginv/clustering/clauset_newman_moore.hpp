@@ -4,44 +4,57 @@
 #define PRINT_FREQUENCY_DQ 10000
 #define PRINT_FREQUENCY_DQH 1000
 
+#include <algorithm>
+#include <chrono>
 #include <map>
 #include <set>
+#include <span>
 #include <string>
 #include <tuple>
 #include <vector>
 
+#include <ginv/clustering/clustering_checkpoint.hpp>
+#include <ginv/clustering/community_labels.hpp>
 #include <ginv/clustering/decaying_max_heap.hpp>
+#include <ginv/clustering/instrumentation.hpp>
+#include <ginv/clustering/lazy_decaying_max_heap.hpp>
+#include <ginv/clustering/modularity_adjacency.hpp>
+#include <ginv/clustering/run_control.hpp>
+#include <ginv/parallel/parallel_for.hpp>
 #include <osigma/ograph.hpp>
 
+#include <cstdint>
 #include <cstdio>
 #include <iostream>
 
 namespace clustering {
 
 template <typename TId>
-void display_communities(std::vector<std::vector<TId>> communities, bool show_size = true, std::ostream& stream = std::cout)
+void display_communities(const std::vector<std::vector<TId>>& communities, bool show_size = true, std::ostream& stream = std::cout)
 {
 
-    std::sort(communities.begin(), communities.end(), [](auto a, auto b) { return a.size() > b.size(); });
+    std::vector<size_t> order = order_by_decreasing_size(communities.size(), [&](size_t i) { return communities[i].size(); });
 
     stream << "communities {";
     int count = 1;
     int non_zero_size = 0;
 
-    for (int i = 0; i < communities.size(); i++) {
+    for (size_t i = 0; i < order.size(); i++) {
+
+        const std::vector<TId>& community = communities[order[i]];
 
         if (show_size) {
 
-            if (communities[i].size() > 0) {
+            if (community.size() > 0) {
 
                 non_zero_size++;
             }
 
-            if (i + 1 < communities.size() && communities[i].size() == communities[i + 1].size()) {
+            if (i + 1 < order.size() && community.size() == communities[order[i + 1]].size()) {
                 count++;
             } else {
 
-                stream << "s" << communities[i].size() << (count > 1 ? "x" + std::to_string(count) : "") << (i == communities.size() - 1 ? "" : ", ");
+                stream << "s" << community.size() << (count > 1 ? "x" + std::to_string(count) : "") << (i == order.size() - 1 ? "" : ", ");
                 count = 1;
             }
 
@@ -49,12 +62,12 @@ void display_communities(std::vector<std::vector<TId>> communities, bool show_si
 
             stream << "[";
 
-            for (int q = 0; q < communities[i].size(); q++) {
+            for (size_t q = 0; q < community.size(); q++) {
 
-                stream << communities[i][q] << (q == communities[i].size() - 1 ? "" : ", ");
+                stream << community[q] << (q == community.size() - 1 ? "" : ", ");
             }
 
-            stream << "]" << (i == communities.size() - 1 ? "" : ", ");
+            stream << "]" << (i == order.size() - 1 ? "" : ", ");
         }
     }
 
@@ -86,155 +99,396 @@ std::set<TKey> map_key_set(std::map<TKey, TValue> map)
 template <
     typename TQ,
     typename TId,
-    typename TConnectionWeight,
-    typename TCoordinates,
-    typename TZIndex,
-    typename... TNodeFeatures>
-std::vector<std::vector<TId>> greedy_modularity_communities(
-    ograph::OGraph<
-        TId,
-        TConnectionWeight,
-        TCoordinates,
-        TZIndex,
-        TNodeFeatures...>
-        graph,
-    TQ resolution = 1.0f,
+    typename TConnectionWeight>
+std::tuple<std::vector<TQ>, TQ> create_normal_weighted_degrees(
+    size_t node_count,
+    std::span<const TId> from_ids,
+    std::span<const TId> to_ids,
+    std::span<const TConnectionWeight> values)
+{
+    std::vector<TQ> result(node_count);
+    TQ m = 0;
+
+    for (size_t i = 0; i < from_ids.size(); i++) {
+
+        TId from = from_ids[i];
+        TId to = to_ids[i];
+
+        if (from == to) {
+
+            continue;
+        }
+
+        TConnectionWeight weight = values[i];
+
+        result[from] += weight;
+        result[to] += weight;
+
+        m += weight;
+    }
+
+    TQ reverse_m = 1 / m;
+
+    for (size_t i = 0; i < node_count; i++) {
+
+        result[i] /= 2 * m;
+    }
+
+    return std::make_tuple(result, reverse_m);
+}
+
+// Merge heap modes: the exact heap removes outdated row tops through a position map,
+// the lazy heap only invalidates them and skips them when they are popped
+// Both can be written to a checkpoint and restored element by element.
+class ExactMergeHeap {
+
+public:
+    template <typename TInstrumentation, typename TQ, typename TId>
+    using Heap = InstrumentedDecayingMaxHeap<TInstrumentation, TQ, TId, TId>;
+
+    static constexpr uint8_t CHECKPOINT_KIND = 1;
+
+    template <typename TInstrumentation, typename TQ, typename TId>
+    static MergeHeapSnapshot<TQ, TId> snapshot(Heap<TInstrumentation, TQ, TId>& heap)
+    {
+
+        MergeHeapSnapshot<TQ, TId> result;
+        result.m_kind = CHECKPOINT_KIND;
+        result.m_values = heap.m_heap_values;
+
+        for (size_t i = 0; i < heap.size(); i++) {
+
+            auto [row, key] = heap.key_at(i);
+
+            result.m_rows.push_back(row);
+            result.m_keys.push_back(key);
+        }
+
+        return result;
+    }
+
+    template <typename TInstrumentation, typename TQ, typename TId>
+    static Heap<TInstrumentation, TQ, TId> restore(MergeHeapSnapshot<TQ, TId> snapshot, TInstrumentation instrumentation)
+    {
+
+        return Heap<TInstrumentation, TQ, TId>::from_heap_order(std::move(snapshot.m_rows), std::move(snapshot.m_keys), std::move(snapshot.m_values), instrumentation);
+    }
+};
+
+class LazyMergeHeap {
+
+public:
+    template <typename TInstrumentation, typename TQ, typename TId>
+    using Heap = LazyDecayingMaxHeap<TInstrumentation, TQ, TId, TId>;
+
+    static constexpr uint8_t CHECKPOINT_KIND = 2;
+
+    // Outdated elements are kept, as they still decide where the live ones sit
+    template <typename TInstrumentation, typename TQ, typename TId>
+    static MergeHeapSnapshot<TQ, TId> snapshot(Heap<TInstrumentation, TQ, TId>& heap)
+    {
+
+        MergeHeapSnapshot<TQ, TId> result;
+        result.m_kind = CHECKPOINT_KIND;
+        result.m_row_versions = heap.m_row_versions;
+        result.m_row_keys = heap.m_row_keys;
+        result.m_row_values = heap.m_row_values;
+        result.m_row_live = heap.m_row_live;
+
+        for (auto& element : heap.m_heap) {
+
+            result.m_rows.push_back(element.m_row);
+            result.m_keys.push_back(element.m_key);
+            result.m_values.push_back(element.m_value);
+            result.m_versions.push_back(element.m_version);
+        }
+
+        return result;
+    }
+
+    template <typename TInstrumentation, typename TQ, typename TId>
+    static Heap<TInstrumentation, TQ, TId> restore(MergeHeapSnapshot<TQ, TId> snapshot, TInstrumentation instrumentation)
+    {
+
+        Heap<TInstrumentation, TQ, TId> heap(snapshot.m_rows.size(), instrumentation);
+
+        for (size_t i = 0; i < snapshot.m_rows.size(); i++) {
+
+            heap.m_heap.push_back(typename Heap<TInstrumentation, TQ, TId>::Element { snapshot.m_values[i], snapshot.m_versions.at(i), snapshot.m_rows[i], snapshot.m_keys[i] });
+        }
+
+        heap.m_row_versions = std::move(snapshot.m_row_versions);
+        heap.m_row_keys = std::move(snapshot.m_row_keys);
+        heap.m_row_values = std::move(snapshot.m_row_values);
+        heap.m_row_live = std::move(snapshot.m_row_live);
+        heap.m_live_count = std::count(heap.m_row_live.begin(), heap.m_row_live.end(), uint8_t(1));
+
+        return heap;
+    }
+};
+
+// Result of a run stopped before its first merge, while its delta Q rows or heaps were still being built:
+// every node stays its own community
+template <typename TQ, typename TId>
+std::vector<std::vector<TId>> stop_before_merges(const std::vector<TQ>& a, TQ resolution, StopReason stop_reason, RunControl<TQ>* run_control)
+{
+
+    std::vector<std::vector<TId>> result(a.size());
+    TQ modularity = 0;
+
+    for (size_t i = 0; i < a.size(); i++) {
+
+        result[i] = std::vector<TId> { TId(i) };
+        modularity -= resolution * a[i] * a[i];
+    }
+
+    if (run_control != nullptr) {
+
+        run_control->m_steps = 0;
+        run_control->m_modularity = modularity;
+        run_control->m_community_count = a.size();
+        run_control->m_stop_reason = stop_reason;
+    }
+
+    return result;
+}
+
+// Runs the greedy merges from a state, e.g. one read back from a checkpoint. The heaps are restored from the heap
+// orders of the state, or built in bulk from its delta Q rows; with checkpoint settings the state is written to their path before the merges they ask for.
+template <
+    typename TQ,
+    typename TId,
+    typename TInstrumentation = NoInstrumentation,
+    typename TMergeHeap = ExactMergeHeap>
+std::vector<std::vector<TId>> greedy_modularity_merges(
+    ClusteringState<TQ, TId> state,
     size_t cutoff = 1,
     bool verbose = false,
-    TQ negative_infinity = -2605)
+    TQ negative_infinity = -2605,
+    size_t thread_count = 0,
+    TInstrumentation instrumentation = TInstrumentation(),
+    RunControl<TQ>* run_control = nullptr,
+    CheckpointSettings* checkpoint = nullptr)
 {
 
     typedef std::vector<std::vector<TId>> Communities;
-    typedef std::vector<TQ> VectorQ;
-    typedef std::map<TId, TQ> MapQ;
-    typedef std::map<TId, DecayingMaxHeap<TQ, TId>> MapHeapQ;
-    typedef std::map<TId, MapQ> DeltaQ;
+    typedef typename ClusteringState<TQ, TId>::MapQ MapQ;
+    typedef InstrumentedDecayingMaxHeap<TInstrumentation, TQ, TId> RowHeap;
+    typedef typename TMergeHeap::template Heap<TInstrumentation, TQ, TId> TotalHeap;
+    typedef std::map<TId, RowHeap> MapHeapQ;
+    typedef typename ClusteringState<TQ, TId>::DeltaQ DeltaQ;
     typedef std::set<TId> IdSet;
 
-    Communities communities(graph.node_count());
+    size_t node_count = state.node_count();
+    TQ resolution = state.m_resolution;
+    std::vector<TQ>& a = state.m_a;
+    Communities& communities = state.m_communities;
+    DeltaQ& delta_q = state.m_delta_q;
+    size_t& steps = state.m_steps;
+    size_t& community_count = state.m_community_count;
+    TQ& modularity = state.m_modularity;
 
-    auto create_normal_weighted_degrees = [&]() {
-        VectorQ result(graph.node_count());
-        TQ m = 0;
+    MapHeapQ delta_q_heaps;
+    TotalHeap total_heap(0, instrumentation);
+    bool has_heaps = false;
 
-        for (int i = 0; i < graph.connection_count(); i++) {
+    auto last_checkpoint = std::chrono::steady_clock::now();
 
-            TId from = graph.m_connections.m_from[i];
-            TId to = graph.m_connections.m_to[i];
+    // The heap orders are copied into the state only while it is written
+    auto write_checkpoint = [&]() {
+        if (has_heaps) {
 
-            if (from == to) {
+            for (auto& [id, heap] : delta_q_heaps) {
 
-                continue;
-            }
+                std::vector<TId>& keys = state.m_row_heap_keys.emplace_hint(state.m_row_heap_keys.end(), id, std::vector<TId>())->second;
+
+                keys.reserve(heap.size());
 
-            TConnectionWeight weight = graph.m_connections.m_values[i];
+                for (size_t i = 0; i < heap.size(); i++) {
 
-            result[from] += weight;
-            result[to] += weight;
+                    keys.push_back(std::get<0>(heap.key_at(i)));
+                }
+            }
 
-            m += weight;
+            state.m_merge_heap = TMergeHeap::template snapshot<TInstrumentation, TQ, TId>(total_heap);
         }
 
-        TQ reverse_m = 1 / m;
+        write_clustering_checkpoint(state, checkpoint->m_path);
 
-        for (int i = 0; i < graph.node_count(); i++) {
+        if (has_heaps) {
 
-            result[i] /= 2 * m;
+            state.m_row_heap_keys.clear();
+            state.m_merge_heap = MergeHeapSnapshot<TQ, TId>();
         }
 
-        return std::make_tuple(result, reverse_m);
+        checkpoint->m_written++;
+        last_checkpoint = std::chrono::steady_clock::now();
     };
 
-    auto a_reverse_m = create_normal_weighted_degrees();
-    VectorQ a = std::get<0>(a_reverse_m);
-    TQ reverse_m = std::get<1>(a_reverse_m);
+    auto finish = [&](StopReason stop_reason) {
+        bool interrupted = stop_reason == StopReason::Cancelled || stop_reason == StopReason::StepBudget || stop_reason == StopReason::TimeBudget;
 
-    // std::cout << "as " << a.size() << " rm " << reverse_m << std::endl;
+        if (checkpoint != nullptr && interrupted) {
 
-    auto create_delta_q = [&]() {
-        DeltaQ result;
+            write_checkpoint();
+        }
 
-        for (size_t i = 0; i < graph.node_count(); i++) {
+        if (run_control != nullptr) {
 
-            result[i] = MapQ();
+            run_control->m_steps = steps;
+            run_control->m_modularity = modularity;
+            run_control->m_community_count = community_count;
+            run_control->m_stop_reason = stop_reason;
         }
 
-        for (int i = 0; i < graph.connection_count(); i++) {
+        Communities result;
+
+        for (size_t i = 0; i < communities.size(); i++) {
+
+            if (communities[i].size() > 0) {
 
-            if (verbose && (i % PRINT_FREQUENCY_DQ == 0 || i == graph.connection_count() - 1)) {
-                std::printf("\rcreate_delta_q %.2f%%", i * 100.0f / graph.connection_count());
+                result.push_back(std::move(communities[i]));
             }
+        }
 
-            TId from = graph.m_connections.m_from[i];
-            TId to = graph.m_connections.m_to[i];
+        return result;
+    };
 
-            if (from == to) {
+    if (run_control != nullptr) {
 
-                continue;
-            }
+        StopReason budget_reason = run_control->check(steps);
 
-            TConnectionWeight weight = graph.m_connections.m_values[i];
+        if (budget_reason != StopReason::NotStarted) {
 
-            result[from][to] += weight;
-            result[to][from] += weight;
+            return finish(budget_reason);
         }
+    }
+
+    StopPoll<TQ> heap_poll(run_control);
 
-        for (auto const& [from, map] : result) {
+    auto create_heaps = [&]() {
+        [[maybe_unused]] auto timer = instrumentation.time_phase(ClusteringPhase::Heaps);
+        std::vector<const MapQ*> rows(node_count, nullptr);
 
-            for (auto& [to, value] : map) {
+        std::vector<const std::vector<TId>*> heap_orders(node_count, nullptr);
 
-                result[from][to] = reverse_m * result[from][to] - resolution * 2 * a[from] * a[to];
-            }
+        for (auto const& [id, row] : delta_q) {
+
+            rows[id] = &row;
         }
 
-        return result;
-    };
+        for (auto const& [id, keys] : state.m_row_heap_keys) {
 
-    if (verbose) {
-        std::cout << std::endl;
-    }
+            heap_orders[id] = &keys;
+        }
 
-    DeltaQ delta_q = create_delta_q();
+        // Communities merged away before a checkpoint have no row and get no heap
+        std::vector<RowHeap> heaps(node_count, RowHeap(0, instrumentation));
+        std::vector<TId> top_keys(node_count);
+        std::vector<TQ> top_values(node_count);
+        std::vector<uint8_t> has_top(node_count, 0);
 
-    auto create_heaps = [&]() {
-        MapHeapQ delta_q_heaps;
-        DecayingMaxHeap<TQ, TId, TId> total_heap(graph.node_count());
+        parallel::parallel_for(
+            0, node_count, [&](size_t i) {
+                if (rows[i] == nullptr || heap_poll.should_stop(i)) {
 
-        for (int i = 0; i < graph.node_count(); i++) {
+                    return;
+                }
 
-            if (verbose && (i % PRINT_FREQUENCY_DQH == 0 || i == graph.connection_count() - 1)) {
-                std::printf("\rcreate_heaps %.2f%%", i * 100.0f / graph.node_count());
-            }
+                std::vector<TId> keys;
+                std::vector<TQ> values;
+
+                keys.reserve(rows[i]->size());
+                values.reserve(rows[i]->size());
+
+                if (heap_orders[i] != nullptr) {
+
+                    for (auto to : *heap_orders[i]) {
+
+                        keys.push_back(to);
+                        values.push_back(rows[i]->at(to));
+                    }
+                } else {
+
+                    for (auto const& [to, value] : *rows[i]) {
+
+                        keys.push_back(to);
+                        values.push_back(value);
+                    }
+                }
+
+                instrumentation.record_row_size(keys.size());
+                heaps[i] = heap_orders[i] != nullptr ? RowHeap::from_heap_order(std::move(keys), std::move(values), instrumentation)
+                                                     : RowHeap(std::move(keys), std::move(values), instrumentation);
+
+                if (heaps[i].size() > 0) {
+
+                    auto [key, value] = heaps[i].top();
+
+                    top_keys[i] = key;
+                    top_values[i] = value;
+                    has_top[i] = 1;
+                }
+            },
+            thread_count);
 
-            DecayingMaxHeap<TQ, TId> heap(delta_q[i].size());
+        MapHeapQ row_heaps;
 
-            for (auto const& [to, value] : delta_q[i]) {
+        if (heap_poll.is_stopped()) {
 
-                heap.push(to, value);
+            return std::make_tuple(std::move(row_heaps), TotalHeap(std::vector<TId>(), std::vector<TId>(), std::vector<TQ>(), instrumentation));
+        }
+
+        std::vector<TId> total_rows;
+        std::vector<TId> total_keys;
+        std::vector<TQ> total_values;
+
+        total_rows.reserve(node_count);
+        total_keys.reserve(node_count);
+        total_values.reserve(node_count);
+
+        for (size_t i = 0; i < node_count; i++) {
+
+            if (verbose && (i % PRINT_FREQUENCY_DQH == 0 || i == node_count - 1)) {
+                std::printf("\rcreate_heaps %.2f%%", i * 100.0f / node_count);
             }
 
-            delta_q_heaps.try_emplace(i, heap);
+            if (rows[i] != nullptr) {
 
-            if (heap.size() > 0) {
+                row_heaps.emplace_hint(row_heaps.end(), i, std::move(heaps[i]));
+            }
 
-                auto top = heap.top();
+            if (has_top[i]) {
 
-                total_heap.push(i, std::get<0>(top), std::get<1>(top));
+                total_rows.push_back(i);
+                total_keys.push_back(top_keys[i]);
+                total_values.push_back(top_values[i]);
             }
         }
 
-        return std::make_tuple(delta_q_heaps, total_heap);
+        if (state.m_merge_heap.m_kind == TMergeHeap::CHECKPOINT_KIND) {
+
+            return std::make_tuple(std::move(row_heaps), TMergeHeap::template restore<TInstrumentation, TQ, TId>(std::move(state.m_merge_heap), instrumentation));
+        }
+
+        TotalHeap merge_heap(std::move(total_rows), std::move(total_keys), std::move(total_values), instrumentation);
+
+        return std::make_tuple(std::move(row_heaps), std::move(merge_heap));
     };
 
     auto all_heaps = create_heaps();
-    MapHeapQ delta_q_heaps = std::get<0>(all_heaps);
-    DecayingMaxHeap<TQ, TId, TId> total_heap = std::get<1>(all_heaps);
 
-    for (int i = 0; i < graph.node_count(); i++) {
+    if (heap_poll.is_stopped()) {
 
-        communities[i] = std::vector { i };
+        return finish(heap_poll.reason());
     }
 
+    delta_q_heaps = std::move(std::get<0>(all_heaps));
+    total_heap = std::move(std::get<1>(all_heaps));
+    has_heaps = true;
+    state.m_row_heap_keys.clear();
+    state.m_merge_heap = MergeHeapSnapshot<TQ, TId>();
+
     auto step = [&]() {
         if (total_heap.size() > 1) {
 
@@ -358,9 +612,8 @@ std::vector<std::vector<TId>> greedy_modularity_communities(
                                     delta_q_heaps.at(r).pop();
                                     total_heap.remove(r, c);
 
-                                    auto [k, dq] = delta_q_heaps.at(r).top();
-
                                     if (delta_q_heaps.at(r).size() > 0) {
+                                        auto [k, dq] = delta_q_heaps.at(r).top();
                                         total_heap.push(r, k, dq);
                                     }
                                 } else {
@@ -383,6 +636,7 @@ std::vector<std::vector<TId>> greedy_modularity_communities(
             };
 
             merge_u_into_v();
+            instrumentation.count_merge();
 
             return top_delta_q;
         } else {
@@ -391,31 +645,260 @@ std::vector<std::vector<TId>> greedy_modularity_communities(
         }
     };
 
-    while (communities.size() > cutoff) {
+    StopReason stop_reason = StopReason::Cutoff;
 
-        auto dq = step();
+    {
+        [[maybe_unused]] auto timer = instrumentation.time_phase(ClusteringPhase::Merges);
 
-        if (verbose) {
-            display_communities(std::vector(communities), communities.size() > 10);
-        }
+        while (community_count > cutoff) {
+
+            if (run_control != nullptr) {
+
+                StopReason budget_reason = run_control->check(steps);
 
-        if (dq < 0) {
+                if (budget_reason != StopReason::NotStarted) {
 
-            break;
+                    stop_reason = budget_reason;
+                    break;
+                }
+            }
+
+            auto dq = step();
+
+            if (verbose) {
+                display_communities(std::vector(communities), communities.size() > 10);
+            }
+
+            if (dq < 0) {
+
+                stop_reason = StopReason::Converged;
+                break;
+            }
+
+            steps++;
+            community_count--;
+            modularity += dq;
+
+            if (run_control != nullptr) {
+
+                run_control->report(steps, modularity, community_count);
+            }
+
+            if (checkpoint != nullptr
+                && ((checkpoint->m_step_interval > 0 && steps % checkpoint->m_step_interval == 0)
+                    || (checkpoint->m_time_interval > std::chrono::steady_clock::duration::zero()
+                        && std::chrono::steady_clock::now() - last_checkpoint >= checkpoint->m_time_interval))) {
+
+                write_checkpoint();
+            }
         }
     }
 
-    Communities result;
+    return finish(stop_reason);
+}
 
-    for (int i = 0; i < communities.size(); i++) {
+// Runs the greedy merges over a shared adjacency, owned or a view of shared columns;
+// only the delta Q maps and heaps of the run depend on the resolution
+template <
+    typename TQ,
+    typename TId,
+    typename TInstrumentation = NoInstrumentation,
+    typename TMergeHeap = ExactMergeHeap,
+    template <typename> typename TColumn = OwnedAdjacencyColumn>
+std::vector<std::vector<TId>> greedy_modularity_communities(
+    const BasicModularityAdjacency<TQ, TId, TColumn>& adjacency,
+    TQ resolution = 1.0f,
+    size_t cutoff = 1,
+    bool verbose = false,
+    TQ negative_infinity = -2605,
+    size_t thread_count = 0,
+    TInstrumentation instrumentation = TInstrumentation(),
+    RunControl<TQ>* run_control = nullptr,
+    CheckpointSettings* checkpoint = nullptr)
+{
 
-        if (communities[i].size() > 0) {
+    typedef typename ClusteringState<TQ, TId>::MapQ MapQ;
+    typedef typename ClusteringState<TQ, TId>::DeltaQ DeltaQ;
 
-            result.push_back(communities[i]);
+    size_t node_count = adjacency.node_count();
+    const auto& a = adjacency.m_a;
+    TQ reverse_m = adjacency.m_reverse_m;
+
+    ClusteringState<TQ, TId> state;
+    state.m_resolution = resolution;
+    state.m_reverse_m = reverse_m;
+    state.m_a = std::vector<TQ>(a.begin(), a.end());
+    state.m_communities.resize(node_count);
+    state.m_community_count = node_count;
+
+    for (size_t i = 0; i < node_count; i++) {
+
+        state.m_communities[i] = std::vector<TId> { TId(i) };
+        state.m_modularity -= resolution * a[i] * a[i];
+    }
+
+    StopPoll<TQ> poll(run_control);
+
+    auto create_delta_q = [&]() {
+        [[maybe_unused]] auto timer = instrumentation.time_phase(ClusteringPhase::DeltaQ);
+        std::vector<MapQ> rows(node_count);
+
+        parallel::parallel_for(
+            0, node_count, [&](size_t i) {
+                if (poll.should_stop(i)) {
+
+                    return;
+                }
+
+                auto neighbours = adjacency.neighbours(i);
+                auto weights = adjacency.weights(i);
+
+                for (size_t q = 0; q < neighbours.size(); q++) {
+
+                    rows[i].emplace_hint(rows[i].end(), neighbours[q], reverse_m * weights[q] - resolution * 2 * a[i] * a[neighbours[q]]);
+                }
+            },
+            thread_count, 1024);
+
+        DeltaQ result;
+
+        for (size_t i = 0; i < node_count; i++) {
+
+            if (verbose && (i % PRINT_FREQUENCY_DQ == 0 || i == node_count - 1)) {
+                std::printf("\rcreate_delta_q %.2f%%", i * 100.0f / node_count);
+            }
+
+            result.emplace_hint(result.end(), TId(i), std::move(rows[i]));
         }
+
+        return result;
+    };
+
+    if (verbose) {
+        std::cout << std::endl;
     }
 
-    return result;
+    state.m_delta_q = create_delta_q();
+
+    if (poll.is_stopped()) {
+
+        return stop_before_merges<TQ, TId>(state.m_a, resolution, poll.reason(), run_control);
+    }
+
+    return greedy_modularity_merges<TQ, TId, TInstrumentation, TMergeHeap>(
+        std::move(state), cutoff, verbose, negative_infinity, thread_count, instrumentation, run_control, checkpoint);
+}
+
+// Continues the run whose state was checkpointed to `path`, e.g. after the process was preempted.
+// Checkpoint settings with the same path keep the checkpoint current while the run goes on.
+template <
+    typename TQ,
+    typename TId,
+    typename TMergeHeap = ExactMergeHeap,
+    typename TInstrumentation = NoInstrumentation>
+std::vector<std::vector<TId>> resume_greedy_modularity_communities(
+    const std::string& path,
+    size_t cutoff = 1,
+    size_t thread_count = 0,
+    RunControl<TQ>* run_control = nullptr,
+    CheckpointSettings* checkpoint = nullptr,
+    TInstrumentation instrumentation = TInstrumentation())
+{
+
+    return greedy_modularity_merges<TQ, TId, TInstrumentation, TMergeHeap>(
+        read_clustering_checkpoint<TQ, TId>(path), cutoff, false, TQ(-2605), thread_count, instrumentation, run_control, checkpoint);
+}
+
+// Runs the greedy merges over connection columns with externally normalized degrees `a` and `reverse_m`,
+// so that a part of a graph can be clustered exactly as it would be inside the whole graph
+template <
+    typename TQ,
+    typename TId,
+    typename TConnectionWeight,
+    typename TInstrumentation = NoInstrumentation,
+    typename TMergeHeap = ExactMergeHeap>
+std::vector<std::vector<TId>> greedy_modularity_communities(
+    size_t node_count,
+    std::span<const TId> from_ids,
+    std::span<const TId> to_ids,
+    std::span<const TConnectionWeight> values,
+    std::vector<TQ> a,
+    TQ reverse_m,
+    TQ resolution = 1.0f,
+    size_t cutoff = 1,
+    bool verbose = false,
+    TQ negative_infinity = -2605,
+    size_t thread_count = 0,
+    TInstrumentation instrumentation = TInstrumentation(),
+    RunControl<TQ>* run_control = nullptr,
+    CheckpointSettings* checkpoint = nullptr)
+{
+
+    // Cancellation and deadlines are sticky, so a check after an interrupted build sees the reason again
+    auto setup_stop_reason = [&]() { return run_control != nullptr ? run_control->check(0) : StopReason::NotStarted; };
+
+    if (StopReason stop_reason = setup_stop_reason(); stop_reason != StopReason::NotStarted) {
+
+        return stop_before_merges<TQ, TId>(a, resolution, stop_reason, run_control);
+    }
+
+    auto adjacency = [&]() {
+        [[maybe_unused]] auto timer = instrumentation.time_phase(ClusteringPhase::DeltaQ);
+        return create_modularity_adjacency<TQ, TId, TConnectionWeight>(node_count, from_ids, to_ids, values, std::move(a), reverse_m, thread_count, run_control);
+    }();
+
+    if (StopReason stop_reason = setup_stop_reason(); stop_reason != StopReason::NotStarted) {
+
+        return stop_before_merges<TQ, TId>(adjacency.m_a, resolution, stop_reason, run_control);
+    }
+
+    return greedy_modularity_communities<TQ, TId, TInstrumentation, TMergeHeap>(
+        adjacency, resolution, cutoff, verbose, negative_infinity, thread_count, instrumentation, run_control, checkpoint);
+}
+
+// The merge heap mode may be chosen as the second template argument:
+// greedy_modularity_communities<float, LazyMergeHeap>(graph)
+template <
+    typename TQ,
+    typename TMergeHeap = ExactMergeHeap,
+    template <typename> typename TAllocator,
+    typename TId,
+    typename TConnectionWeight,
+    typename TCoordinates,
+    typename TZIndex,
+    typename... TNodeFeatures,
+    typename TInstrumentation = NoInstrumentation>
+std::vector<std::vector<TId>> greedy_modularity_communities(
+    ograph::BasicOGraph<
+        TAllocator,
+        TId,
+        TConnectionWeight,
+        TCoordinates,
+        TZIndex,
+        TNodeFeatures...>
+        graph,
+    TQ resolution = 1.0f,
+    size_t cutoff = 1,
+    bool verbose = false,
+    TQ negative_infinity = -2605,
+    size_t thread_count = 0,
+    TInstrumentation instrumentation = TInstrumentation(),
+    RunControl<TQ>* run_control = nullptr,
+    CheckpointSettings* checkpoint = nullptr)
+{
+
+    std::span<const TId> from_ids(graph.m_connections.m_from);
+    std::span<const TId> to_ids(graph.m_connections.m_to);
+    std::span<const TConnectionWeight> values(graph.m_connections.m_values);
+
+    auto [a, reverse_m] = [&]() {
+        [[maybe_unused]] auto timer = instrumentation.time_phase(ClusteringPhase::Degrees);
+        return create_normal_weighted_degrees<TQ>(graph.node_count(), from_ids, to_ids, values);
+    }();
+
+    return greedy_modularity_communities<TQ, TId, TConnectionWeight, TInstrumentation, TMergeHeap>(
+        graph.node_count(), from_ids, to_ids, values, std::move(a), reverse_m,
+        resolution, cutoff, verbose, negative_infinity, thread_count, instrumentation, run_control, checkpoint);
 }
 
 }
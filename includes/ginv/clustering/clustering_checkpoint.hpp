@@ -0,0 +1,390 @@
+#ifndef CLUSTERING_CHECKPOINT_HPP_
+#define CLUSTERING_CHECKPOINT_HPP_
+
+#include <chrono>
+#include <cstdint>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <map>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+namespace clustering {
+
+// The merge heap of a run as columns: its elements in heap order, with their versions for the lazy heap,
+// and for the lazy heap also the live element of every row. `m_kind` names the heap mode, 0 for none.
+template <typename TQ, typename TId>
+class MergeHeapSnapshot {
+
+public:
+    uint8_t m_kind = 0;
+    std::vector<TId> m_rows;
+    std::vector<TId> m_keys;
+    std::vector<TQ> m_values;
+    std::vector<uint32_t> m_versions;
+    std::vector<uint32_t> m_row_versions;
+    std::vector<TId> m_row_keys;
+    std::vector<TQ> m_row_values;
+    std::vector<uint8_t> m_row_live;
+
+    std::string describe() const
+    {
+
+        return "MergeHeapSnapshot(kind " + std::to_string(m_kind) + " of " + std::to_string(m_rows.size()) + " elements)";
+    }
+};
+
+// State of a greedy modularity run between two merges. A state taken from a running run also holds the order
+// of its heaps, so that the resumed run breaks ties between equal delta Q values as the uninterrupted one;
+// without them the heaps are built in bulk from the delta Q rows.
+template <typename TQ, typename TId>
+class ClusteringState {
+
+public:
+    typedef std::map<TId, TQ> MapQ;
+    typedef std::map<TId, MapQ> DeltaQ;
+
+    TQ m_resolution = 1;
+    TQ m_reverse_m = 0;
+    std::vector<TQ> m_a;
+    // Indexed by community id; merged communities are left empty
+    std::vector<std::vector<TId>> m_communities;
+    DeltaQ m_delta_q;
+    size_t m_steps = 0;
+    size_t m_community_count = 0;
+    TQ m_modularity = 0;
+    // Keys of every row heap in heap order, empty when the heaps are to be built from the rows
+    std::map<TId, std::vector<TId>> m_row_heap_keys;
+    MergeHeapSnapshot<TQ, TId> m_merge_heap;
+
+    size_t node_count() const
+    {
+
+        return m_a.size();
+    }
+
+    std::string describe() const
+    {
+
+        return "ClusteringState(" + std::to_string(m_steps) + " steps, " + std::to_string(m_community_count) + " communities of "
+            + std::to_string(node_count()) + " nodes, modularity " + std::to_string(m_modularity) + ")";
+    }
+};
+
+// When a run writes its state: every `m_step_interval` merges and at least every `m_time_interval`,
+// both off when zero, and whenever a budget or cancellation stops the run
+class CheckpointSettings {
+
+public:
+    std::string m_path;
+    size_t m_step_interval = 0;
+    std::chrono::steady_clock::duration m_time_interval = std::chrono::steady_clock::duration::zero();
+
+    // Filled by the run
+    size_t m_written = 0;
+
+    explicit CheckpointSettings(std::string path, size_t step_interval = 0, std::chrono::steady_clock::duration time_interval = std::chrono::steady_clock::duration::zero())
+        : m_path(std::move(path))
+        , m_step_interval(step_interval)
+        , m_time_interval(time_interval)
+    {
+    }
+
+    std::string describe() const
+    {
+
+        return "CheckpointSettings(" + m_path + " every " + std::to_string(m_step_interval) + " steps or "
+            + std::to_string(std::chrono::duration_cast<std::chrono::seconds>(m_time_interval).count()) + " s, " + std::to_string(m_written) + " written)";
+    }
+};
+
+inline constexpr char CLUSTERING_CHECKPOINT_MAGIC[8] = { 'G', 'I', 'N', 'V', 'C', 'K', '0', '2' };
+
+// Layout: magic, sizes of TQ and TId, resolution, 1/m, steps, community count, modularity, node count, a,
+// community sizes and members, then the delta Q rows as whether they are in heap order, row count and
+// (id, size, keys, values) per row, then the merge heap kind and its columns as (size, elements) each
+template <typename TQ, typename TId>
+void write_clustering_checkpoint(const ClusteringState<TQ, TId>& state, const std::string& path)
+{
+
+    std::string temporary_path = path + ".tmp";
+
+    {
+        std::ofstream file(temporary_path, std::ios::out | std::ios::binary | std::ios::trunc);
+
+        auto write = [&](const auto& value) { file.write((const char*)&value, sizeof(value)); };
+        auto write_array = [&](const auto* values, size_t count) { file.write((const char*)values, count * sizeof(*values)); };
+
+        file.write(CLUSTERING_CHECKPOINT_MAGIC, sizeof(CLUSTERING_CHECKPOINT_MAGIC));
+        write(uint8_t(sizeof(TQ)));
+        write(uint8_t(sizeof(TId)));
+        write(state.m_resolution);
+        write(state.m_reverse_m);
+        write(uint64_t(state.m_steps));
+        write(uint64_t(state.m_community_count));
+        write(state.m_modularity);
+        write(uint64_t(state.node_count()));
+        write_array(state.m_a.data(), state.m_a.size());
+
+        for (auto& community : state.m_communities) {
+
+            write(uint64_t(community.size()));
+        }
+
+        for (auto& community : state.m_communities) {
+
+            write_array(community.data(), community.size());
+        }
+
+        auto write_column = [&](const auto& column) {
+            write(uint64_t(column.size()));
+            write_array(column.data(), column.size());
+        };
+
+        std::vector<TId> keys;
+        std::vector<TQ> values;
+        bool in_heap_order = !state.m_row_heap_keys.empty();
+
+        write(uint8_t(in_heap_order));
+        write(uint64_t(state.m_delta_q.size()));
+
+        for (auto& [id, row] : state.m_delta_q) {
+
+            keys.clear();
+            values.clear();
+
+            if (in_heap_order) {
+
+                keys = state.m_row_heap_keys.at(id);
+
+                for (auto key : keys) {
+
+                    values.push_back(row.at(key));
+                }
+            } else {
+
+                for (auto& [key, value] : row) {
+
+                    keys.push_back(key);
+                    values.push_back(value);
+                }
+            }
+
+            write(id);
+            write(uint64_t(row.size()));
+            write_array(keys.data(), keys.size());
+            write_array(values.data(), values.size());
+        }
+
+        const MergeHeapSnapshot<TQ, TId>& merge_heap = state.m_merge_heap;
+
+        write(merge_heap.m_kind);
+        write_column(merge_heap.m_rows);
+        write_column(merge_heap.m_keys);
+        write_column(merge_heap.m_values);
+        write_column(merge_heap.m_versions);
+        write_column(merge_heap.m_row_versions);
+        write_column(merge_heap.m_row_keys);
+        write_column(merge_heap.m_row_values);
+        write_column(merge_heap.m_row_live);
+
+        if (!file.flush()) {
+
+            throw std::runtime_error("Cannot write " + temporary_path);
+        }
+    }
+
+    // An interrupted write leaves the previous checkpoint in place
+    std::filesystem::rename(temporary_path, path);
+}
+
+template <typename TQ, typename TId>
+ClusteringState<TQ, TId> read_clustering_checkpoint(const std::string& path)
+{
+
+    std::ifstream file(path, std::ios::in | std::ios::binary);
+
+    if (!file) {
+
+        throw std::runtime_error("Cannot open " + path);
+    }
+
+    auto read = [&](auto& value) {
+        if (!file.read((char*)&value, sizeof(value))) {
+
+            throw std::runtime_error(path + " is truncated");
+        }
+    };
+
+    auto read_array = [&](auto* values, size_t count) {
+        if (!file.read((char*)values, count * sizeof(*values))) {
+
+            throw std::runtime_error(path + " is truncated");
+        }
+    };
+
+    char magic[sizeof(CLUSTERING_CHECKPOINT_MAGIC)];
+    uint8_t q_size = 0;
+    uint8_t id_size = 0;
+
+    read_array(magic, sizeof(magic));
+    read(q_size);
+    read(id_size);
+
+    if (std::memcmp(magic, CLUSTERING_CHECKPOINT_MAGIC, sizeof(magic)) != 0) {
+
+        throw std::runtime_error(path + " is not a clustering checkpoint");
+    }
+
+    if (q_size != sizeof(TQ) || id_size != sizeof(TId)) {
+
+        throw std::invalid_argument(path + " holds a checkpoint of other value or id types");
+    }
+
+    ClusteringState<TQ, TId> state;
+    uint64_t steps = 0;
+    uint64_t community_count = 0;
+    uint64_t node_count = 0;
+
+    read(state.m_resolution);
+    read(state.m_reverse_m);
+    read(steps);
+    read(community_count);
+    read(state.m_modularity);
+    read(node_count);
+
+    state.m_steps = steps;
+    state.m_community_count = community_count;
+    state.m_a.resize(node_count);
+    read_array(state.m_a.data(), node_count);
+
+    // Every id of the checkpoint indexes the per node arrays of the resumed run
+    auto check_id = [&](TId id, const char* what) {
+        if (uint64_t(id) >= node_count) {
+
+            throw std::runtime_error(path + " holds " + what + " " + std::to_string(id) + " outside of its " + std::to_string(node_count) + " nodes");
+        }
+    };
+
+    auto check_ids = [&](const std::vector<TId>& ids, const char* what) {
+        for (TId id : ids) {
+
+            check_id(id, what);
+        }
+    };
+
+    std::vector<uint64_t> community_sizes(node_count);
+    read_array(community_sizes.data(), node_count);
+    state.m_communities.resize(node_count);
+
+    for (size_t i = 0; i < node_count; i++) {
+
+        state.m_communities[i].resize(community_sizes[i]);
+        read_array(state.m_communities[i].data(), community_sizes[i]);
+        check_ids(state.m_communities[i], "community member");
+    }
+
+    auto read_column = [&](auto& column) {
+        uint64_t size = 0;
+
+        read(size);
+        column.resize(size);
+        read_array(column.data(), size);
+    };
+
+    uint8_t in_heap_order = 0;
+    uint64_t row_count = 0;
+    std::vector<TId> keys;
+    std::vector<TQ> values;
+
+    read(in_heap_order);
+    read(row_count);
+
+    for (size_t r = 0; r < row_count; r++) {
+
+        TId id;
+        uint64_t size = 0;
+
+        read(id);
+        read(size);
+
+        keys.resize(size);
+        values.resize(size);
+        read_array(keys.data(), size);
+        read_array(values.data(), size);
+        check_id(id, "delta Q row");
+        check_ids(keys, "delta Q key");
+
+        auto& row = state.m_delta_q.emplace_hint(state.m_delta_q.end(), id, typename ClusteringState<TQ, TId>::MapQ())->second;
+
+        for (size_t q = 0; q < size; q++) {
+
+            row.emplace(keys[q], values[q]);
+        }
+
+        if (in_heap_order) {
+
+            state.m_row_heap_keys.emplace_hint(state.m_row_heap_keys.end(), id, keys);
+        }
+    }
+
+    MergeHeapSnapshot<TQ, TId>& merge_heap = state.m_merge_heap;
+
+    read(merge_heap.m_kind);
+    read_column(merge_heap.m_rows);
+    read_column(merge_heap.m_keys);
+    read_column(merge_heap.m_values);
+    read_column(merge_heap.m_versions);
+    read_column(merge_heap.m_row_versions);
+    read_column(merge_heap.m_row_keys);
+    read_column(merge_heap.m_row_values);
+    read_column(merge_heap.m_row_live);
+
+    if (merge_heap.m_keys.size() != merge_heap.m_rows.size() || merge_heap.m_values.size() != merge_heap.m_rows.size()) {
+
+        throw std::runtime_error(path + " holds an inconsistent merge heap");
+    }
+
+    check_ids(merge_heap.m_rows, "merge heap row");
+    check_ids(merge_heap.m_keys, "merge heap key");
+
+    // The lazy heap also indexes its per row columns by the rows of its elements
+    if (merge_heap.m_kind == 2) {
+
+        size_t row_slots = merge_heap.m_row_live.size();
+
+        if (merge_heap.m_versions.size() != merge_heap.m_rows.size() || merge_heap.m_row_versions.size() != row_slots
+            || merge_heap.m_row_keys.size() != row_slots || merge_heap.m_row_values.size() != row_slots) {
+
+            throw std::runtime_error(path + " holds an inconsistent lazy merge heap");
+        }
+
+        for (TId row : merge_heap.m_rows) {
+
+            if (size_t(row) >= row_slots) {
+
+                throw std::runtime_error(path + " holds merge heap row " + std::to_string(row) + " without a version");
+            }
+        }
+
+        for (size_t row = 0; row < row_slots; row++) {
+
+            if (merge_heap.m_row_live[row]) {
+
+                if (row >= node_count) {
+
+                    throw std::runtime_error(path + " holds live merge heap row " + std::to_string(row) + " outside of its " + std::to_string(node_count) + " nodes");
+                }
+
+                check_id(merge_heap.m_row_keys[row], "merge heap key");
+            }
+        }
+    }
+
+    return state;
+}
+}
+
+#endif
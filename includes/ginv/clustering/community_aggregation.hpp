@@ -0,0 +1,192 @@
+#ifndef COMMUNITY_AGGREGATION_HPP_
+#define COMMUNITY_AGGREGATION_HPP_
+
+#include <algorithm>
+#include <cstdint>
+#include <span>
+#include <stdexcept>
+#include <tuple>
+#include <type_traits>
+#include <vector>
+
+#include <ginv/clustering/community_labels.hpp>
+#include <ginv/parallel/parallel_for.hpp>
+#include <osigma/onodes.hpp>
+
+namespace clustering {
+
+// Aggregations of a feature column over the members of a community. Each one names its result type
+// for a feature type and reduces the members into it; empty communities get the result of no members.
+
+template <typename T>
+using AccumulatorType = std::conditional_t<std::is_floating_point_v<T>, double, std::conditional_t<std::is_signed_v<T>, int64_t, uint64_t>>;
+
+class SumAggregation {
+
+public:
+    template <typename T>
+    using Result = AccumulatorType<T>;
+
+    template <typename TColumn, typename TId>
+    static Result<typename TColumn::value_type> reduce(const TColumn& column, std::span<const TId> members)
+    {
+
+        Result<typename TColumn::value_type> result = 0;
+
+        for (size_t q = 0; q < members.size(); q++) {
+
+            result += column[members[q]];
+        }
+
+        return result;
+    }
+};
+
+class MeanAggregation {
+
+public:
+    template <typename T>
+    using Result = double;
+
+    template <typename TColumn, typename TId>
+    static double reduce(const TColumn& column, std::span<const TId> members)
+    {
+
+        return members.empty() ? 0.0 : double(SumAggregation::reduce(column, members)) / double(members.size());
+    }
+};
+
+class MinAggregation {
+
+public:
+    template <typename T>
+    using Result = T;
+
+    template <typename TColumn, typename TId>
+    static typename TColumn::value_type reduce(const TColumn& column, std::span<const TId> members)
+    {
+
+        if (members.empty()) {
+
+            return typename TColumn::value_type();
+        }
+
+        typename TColumn::value_type result = column[members[0]];
+
+        for (size_t q = 1; q < members.size(); q++) {
+
+            result = std::min(result, column[members[q]]);
+        }
+
+        return result;
+    }
+};
+
+class MaxAggregation {
+
+public:
+    template <typename T>
+    using Result = T;
+
+    template <typename TColumn, typename TId>
+    static typename TColumn::value_type reduce(const TColumn& column, std::span<const TId> members)
+    {
+
+        if (members.empty()) {
+
+            return typename TColumn::value_type();
+        }
+
+        typename TColumn::value_type result = column[members[0]];
+
+        for (size_t q = 1; q < members.size(); q++) {
+
+            result = std::max(result, column[members[q]]);
+        }
+
+        return result;
+    }
+};
+
+// Aggregation of the feature column `index`: the given one, or a sum when none are given
+template <size_t index, typename... TAggregations>
+class SelectedAggregationOf {
+
+public:
+    typedef std::tuple_element_t<index, std::tuple<TAggregations...>> Type;
+};
+
+template <size_t index>
+class SelectedAggregationOf<index> {
+
+public:
+    typedef SumAggregation Type;
+};
+
+template <size_t index, typename... TAggregations>
+using SelectedAggregation = typename SelectedAggregationOf<index, TAggregations...>::Type;
+
+// Returns one node per community with the aggregated feature columns, e.g. for the Istanbul nodes
+// (degree, centrality, number of trades, profits, excess profits, volume):
+// aggregate_communities<SumAggregation, MaxAggregation, SumAggregation, MeanAggregation, MeanAggregation, SumAggregation>(labels, dataset.m_nodes)
+// Community ranges are balanced by member count, so a single large community does not serialize the rest.
+template <
+    typename... TAggregations,
+    typename TId,
+    template <typename> typename TAllocator,
+    typename... TFeatures>
+auto aggregate_communities(const CommunityLabels<TId>& labels, const ograph::BasicONodes<TAllocator, TFeatures...>& nodes, size_t thread_count = 0)
+{
+
+    static_assert(sizeof...(TAggregations) == 0 || sizeof...(TAggregations) == sizeof...(TFeatures),
+        "aggregate_communities needs no aggregations or one per feature");
+
+    return [&]<size_t... indices>(std::index_sequence<indices...>) {
+        typedef ograph::ONodes<typename SelectedAggregation<indices, TAggregations...>::template Result<TFeatures>...> Result;
+
+        size_t community_count = labels.community_count();
+        size_t member_count = labels.m_members.size();
+
+        ((std::get<indices>(nodes.m_features).size() < labels.node_count()
+                 ? throw std::invalid_argument("Feature columns are shorter than the labelled nodes")
+                 : void()),
+            ...);
+
+        Result result((std::vector<typename SelectedAggregation<indices, TAggregations...>::template Result<TFeatures>>(community_count))...);
+
+        auto reduce_communities = [&](size_t community_begin, size_t community_end) {
+            for (size_t c = community_begin; c < community_end; c++) {
+
+                auto members = labels.community_members(c);
+
+                ((std::get<indices>(result.m_features)[c] = SelectedAggregation<indices, TAggregations...>::reduce(
+                      std::get<indices>(nodes.m_features), members)),
+                    ...);
+            }
+        };
+
+        if (member_count == 0) {
+
+            reduce_communities(0, community_count);
+            return result;
+        }
+
+        parallel::parallel_for_ranges(
+            0, member_count,
+            [&](size_t member_begin, size_t member_end, size_t) {
+                auto first_offset = labels.m_offsets.begin();
+                auto last_offset = labels.m_offsets.end() - 1;
+
+                size_t community_begin = std::lower_bound(first_offset, last_offset, member_begin) - first_offset;
+                size_t community_end = member_end == member_count ? community_count : std::lower_bound(first_offset, last_offset, member_end) - first_offset;
+
+                reduce_communities(community_begin, community_end);
+            },
+            thread_count, 4096);
+
+        return result;
+    }(std::index_sequence_for<TFeatures...>());
+}
+}
+
+#endif
@@ -0,0 +1,331 @@
+#ifndef COMMUNITY_LABELS_HPP_
+#define COMMUNITY_LABELS_HPP_
+
+#include <algorithm>
+#include <charconv>
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <numeric>
+#include <span>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include <ginv/parallel/parallel_for.hpp>
+
+namespace clustering {
+
+// Compact clustering result: a community label per node and the members of every community as CSR.
+// Nodes that belong to no community are labelled with NO_COMMUNITY.
+template <typename TId>
+class CommunityLabels {
+
+public:
+    static constexpr TId NO_COMMUNITY = TId(-1);
+
+    std::vector<TId> m_labels;
+    std::vector<size_t> m_offsets;
+    std::vector<TId> m_members;
+
+    explicit CommunityLabels(std::vector<TId> labels, std::vector<size_t> offsets, std::vector<TId> members)
+        : m_labels(std::move(labels))
+        , m_offsets(std::move(offsets))
+        , m_members(std::move(members))
+    {
+    }
+
+    size_t node_count() const
+    {
+
+        return m_labels.size();
+    }
+
+    size_t community_count() const
+    {
+
+        return m_offsets.size() - 1;
+    }
+
+    size_t community_size(size_t community) const
+    {
+
+        return m_offsets[community + 1] - m_offsets[community];
+    }
+
+    std::span<const TId> community_members(size_t community) const
+    {
+
+        return std::span<const TId>(m_members.data() + m_offsets[community], community_size(community));
+    }
+
+    std::vector<std::vector<TId>> to_communities() const
+    {
+
+        std::vector<std::vector<TId>> result(community_count());
+
+        for (size_t i = 0; i < community_count(); i++) {
+
+            auto members = community_members(i);
+            result[i].assign(members.begin(), members.end());
+        }
+
+        return result;
+    }
+
+    std::string describe() const
+    {
+
+        return "CommunityLabels(" + std::to_string(community_count()) + " communities of " + std::to_string(node_count()) + " nodes)";
+    }
+};
+
+// Keeps the community order and the member order of `communities`
+template <typename TId>
+CommunityLabels<TId> create_community_labels(size_t node_count, const std::vector<std::vector<TId>>& communities)
+{
+
+    std::vector<TId> labels(node_count, CommunityLabels<TId>::NO_COMMUNITY);
+    std::vector<size_t> offsets(communities.size() + 1, 0);
+
+    for (size_t i = 0; i < communities.size(); i++) {
+
+        offsets[i + 1] = offsets[i] + communities[i].size();
+    }
+
+    std::vector<TId> members(offsets.back());
+
+    for (size_t i = 0; i < communities.size(); i++) {
+
+        std::copy(communities[i].begin(), communities[i].end(), members.begin() + offsets[i]);
+
+        for (auto node : communities[i]) {
+
+            labels[node] = TId(i);
+        }
+    }
+
+    return CommunityLabels<TId>(std::move(labels), std::move(offsets), std::move(members));
+}
+
+// Binary layout: magic, id size, node count, community count, member count, offsets (uint64) and members (TId).
+// Labels are not stored since they are restored from the members.
+inline constexpr char COMMUNITY_LABELS_MAGIC[8] = { 'G', 'I', 'N', 'V', 'C', 'L', '0', '1' };
+
+template <typename TId>
+void write_community_labels(const CommunityLabels<TId>& labels, std::ostream& stream)
+{
+
+    uint64_t header[4] = { sizeof(TId), labels.node_count(), labels.community_count(), labels.m_members.size() };
+    std::vector<uint64_t> offsets(labels.m_offsets.begin(), labels.m_offsets.end());
+
+    stream.write(COMMUNITY_LABELS_MAGIC, sizeof(COMMUNITY_LABELS_MAGIC));
+    stream.write((const char*)header, sizeof(header));
+    stream.write((const char*)offsets.data(), offsets.size() * sizeof(uint64_t));
+    stream.write((const char*)labels.m_members.data(), labels.m_members.size() * sizeof(TId));
+
+    if (!stream) {
+
+        throw std::runtime_error("Cannot write community labels");
+    }
+}
+
+template <typename TId>
+void write_community_labels(const CommunityLabels<TId>& labels, std::string file_name)
+{
+
+    std::ofstream file(file_name, std::ios::out | std::ios::binary);
+
+    if (!file) {
+
+        throw std::runtime_error("Cannot open " + file_name);
+    }
+
+    write_community_labels(labels, file);
+}
+
+template <typename TId>
+CommunityLabels<TId> read_community_labels(std::istream& stream)
+{
+
+    char magic[sizeof(COMMUNITY_LABELS_MAGIC)];
+    uint64_t header[4];
+
+    stream.read(magic, sizeof(magic));
+    stream.read((char*)header, sizeof(header));
+
+    if (!stream || std::memcmp(magic, COMMUNITY_LABELS_MAGIC, sizeof(magic)) != 0) {
+
+        throw std::runtime_error("Not a community labels stream");
+    }
+
+    if (header[0] != sizeof(TId)) {
+
+        throw std::runtime_error("Community labels were written with " + std::to_string(header[0]) + " byte ids");
+    }
+
+    std::vector<uint64_t> offsets(header[2] + 1);
+    std::vector<TId> members(header[3]);
+
+    stream.read((char*)offsets.data(), offsets.size() * sizeof(uint64_t));
+    stream.read((char*)members.data(), members.size() * sizeof(TId));
+
+    if (!stream || offsets.back() != members.size()) {
+
+        throw std::runtime_error("Truncated community labels stream");
+    }
+
+    // A malformed stream is rejected before any of its offsets or ids is used as an index
+    if (offsets[0] != 0) {
+
+        throw std::runtime_error("Community labels stream does not start its first community at 0");
+    }
+
+    for (size_t i = 0; i < header[2]; i++) {
+
+        if (offsets[i + 1] < offsets[i] || offsets[i + 1] > members.size()) {
+
+            throw std::runtime_error("Community " + std::to_string(i) + " has members out of the member range");
+        }
+    }
+
+    for (TId member : members) {
+
+        if (uint64_t(member) >= header[1]) {
+
+            throw std::runtime_error("Community member " + std::to_string(member) + " is out of the node range");
+        }
+    }
+
+    std::vector<TId> labels(header[1], CommunityLabels<TId>::NO_COMMUNITY);
+
+    for (size_t i = 0; i < header[2]; i++) {
+
+        for (size_t q = offsets[i]; q < offsets[i + 1]; q++) {
+
+            labels[members[q]] = TId(i);
+        }
+    }
+
+    return CommunityLabels<TId>(std::move(labels), std::vector<size_t>(offsets.begin(), offsets.end()), std::move(members));
+}
+
+template <typename TId>
+CommunityLabels<TId> read_community_labels(std::string file_name)
+{
+
+    std::ifstream file(file_name, std::ios::in | std::ios::binary);
+
+    if (!file) {
+
+        throw std::runtime_error("Cannot open " + file_name);
+    }
+
+    return read_community_labels<TId>(file);
+}
+
+// Community indices ordered by decreasing size, equal sizes keep their order
+template <typename TSizeOf>
+std::vector<size_t> order_by_decreasing_size(size_t count, TSizeOf size_of)
+{
+
+    std::vector<size_t> order(count);
+    std::iota(order.begin(), order.end(), size_t(0));
+    std::stable_sort(order.begin(), order.end(), [&](size_t a, size_t b) { return size_of(a) > size_of(b); });
+
+    return order;
+}
+
+// Same text as display_communities: ranges of communities are formatted into per-thread buffers in parallel
+template <typename TId>
+std::string format_communities(const CommunityLabels<TId>& labels, bool show_size = true, size_t thread_count = 0)
+{
+
+    std::vector<size_t> order = order_by_decreasing_size(labels.community_count(), [&](size_t i) { return labels.community_size(i); });
+    size_t count = order.size();
+
+    std::string result = "communities {";
+
+    if (show_size) {
+
+        size_t non_zero_size = 0;
+        size_t run = 1;
+
+        for (size_t i = 0; i < count; i++) {
+
+            size_t size = labels.community_size(order[i]);
+
+            if (size > 0) {
+
+                non_zero_size++;
+            }
+
+            if (i + 1 < count && size == labels.community_size(order[i + 1])) {
+                run++;
+            } else {
+
+                result += "s" + std::to_string(size) + (run > 1 ? "x" + std::to_string(run) : "") + (i == count - 1 ? "" : ", ");
+                run = 1;
+            }
+        }
+
+        return result + "} [" + std::to_string(non_zero_size) + "]\n";
+    }
+
+    std::vector<std::string> buffers(parallel::resolve_thread_count(thread_count));
+
+    parallel::parallel_for_ranges(
+        0, count,
+        [&](size_t range_begin, size_t range_end, size_t thread_id) {
+            std::string& buffer = buffers[thread_id];
+            char number[32];
+
+            for (size_t i = range_begin; i < range_end; i++) {
+
+                auto members = labels.community_members(order[i]);
+
+                buffer += '[';
+
+                for (size_t q = 0; q < members.size(); q++) {
+
+                    char* end = std::to_chars(number, number + sizeof(number), members[q]).ptr;
+                    buffer.append(number, end);
+
+                    if (q + 1 < members.size()) {
+                        buffer += ", ";
+                    }
+                }
+
+                buffer += (i == count - 1 ? "]" : "], ");
+            }
+        },
+        thread_count, 1024);
+
+    size_t total_size = result.size() + 2;
+
+    for (auto& buffer : buffers) {
+
+        total_size += buffer.size();
+    }
+
+    result.reserve(total_size);
+
+    for (auto& buffer : buffers) {
+
+        result += buffer;
+    }
+
+    return result + "}\n";
+}
+
+template <typename TId>
+void write_communities_text(const CommunityLabels<TId>& labels, std::ostream& stream, bool show_size = true, size_t thread_count = 0)
+{
+
+    std::string text = format_communities(labels, show_size, thread_count);
+    stream.write(text.data(), text.size());
+}
+}
+
+#endif
@@ -0,0 +1,230 @@
+#ifndef COMPONENT_COMMUNITIES_HPP_
+#define COMPONENT_COMMUNITIES_HPP_
+
+#include <algorithm>
+#include <future>
+#include <iostream>
+#include <numeric>
+#include <span>
+#include <tuple>
+#include <vector>
+
+#include <ginv/clustering/clauset_newman_moore.hpp>
+#include <ginv/clustering/connected_components.hpp>
+#include <ginv/parallel/parallel_for.hpp>
+#include <ginv/parallel/thread_pool.hpp>
+#include <osigma/ograph.hpp>
+
+namespace clustering {
+
+// Modularity merges never cross connected components, so each component is clustered on its own
+// with the degrees and 1/m of the whole graph. Components of one or two nodes are resolved without heaps.
+template <
+    typename TQ,
+    typename TId,
+    typename TConnectionWeight,
+    typename TInstrumentation = NoInstrumentation>
+std::vector<std::vector<TId>> greedy_modularity_communities_by_components(
+    size_t node_count,
+    std::span<const TId> from_ids,
+    std::span<const TId> to_ids,
+    std::span<const TConnectionWeight> values,
+    const std::vector<TQ>& a,
+    TQ reverse_m,
+    TQ resolution = 1.0f,
+    bool verbose = false,
+    TQ negative_infinity = -2605,
+    size_t thread_count = 0,
+    TInstrumentation instrumentation = TInstrumentation())
+{
+
+    typedef std::vector<std::vector<TId>> Communities;
+
+    ConnectedComponents<TId> components = [&]() {
+        [[maybe_unused]] auto timer = instrumentation.time_phase(ClusteringPhase::Components);
+        return connected_components<TId>(node_count, from_ids, to_ids, thread_count);
+    }();
+    size_t component_count = components.component_count();
+
+    if (verbose) {
+        std::cout << components.describe() << std::endl;
+    }
+
+    std::vector<TId> local_ids(node_count);
+
+    parallel::parallel_for(
+        0, node_count, [&](size_t position) {
+            TId node = components.m_nodes[position];
+            local_ids[node] = TId(position - components.m_offsets[components.m_labels[node]]);
+        },
+        thread_count, 1 << 16);
+
+    std::vector<size_t> connection_offsets(component_count + 1, 0);
+
+    for (size_t i = 0; i < from_ids.size(); i++) {
+
+        connection_offsets[components.m_labels[from_ids[i]] + 1]++;
+    }
+
+    for (size_t i = 1; i < connection_offsets.size(); i++) {
+
+        connection_offsets[i] += connection_offsets[i - 1];
+    }
+
+    std::vector<TId> local_from(from_ids.size());
+    std::vector<TId> local_to(to_ids.size());
+    std::vector<TConnectionWeight> local_values(values.size());
+    std::vector<size_t> cursors(connection_offsets.begin(), connection_offsets.end() - 1);
+
+    for (size_t i = 0; i < from_ids.size(); i++) {
+
+        size_t position = cursors[components.m_labels[from_ids[i]]]++;
+
+        local_from[position] = local_ids[from_ids[i]];
+        local_to[position] = local_ids[to_ids[i]];
+        local_values[position] = values[i];
+    }
+
+    Communities communities_by_survivor(node_count);
+
+    auto cluster_pair = [&](size_t component) {
+        std::span<const TId> nodes = components.component_nodes(component);
+        TConnectionWeight weight = 0;
+
+        for (size_t i = connection_offsets[component]; i < connection_offsets[component + 1]; i++) {
+
+            if (local_from[i] != local_to[i]) {
+
+                weight += local_values[i];
+            }
+        }
+
+        TQ delta_q = reverse_m * weight - resolution * 2 * a[nodes[0]] * a[nodes[1]];
+
+        if (delta_q < 0) {
+
+            communities_by_survivor[nodes[0]] = std::vector<TId> { nodes[0] };
+            communities_by_survivor[nodes[1]] = std::vector<TId> { nodes[1] };
+        } else {
+
+            communities_by_survivor[nodes[1]] = std::vector<TId> { nodes[1], nodes[0] };
+            instrumentation.count_merge();
+        }
+    };
+
+    auto cluster_component = [&](size_t component) {
+        std::span<const TId> nodes = components.component_nodes(component);
+        size_t begin = connection_offsets[component];
+        size_t count = connection_offsets[component + 1] - begin;
+
+        std::vector<TQ> local_a(nodes.size());
+
+        for (size_t i = 0; i < nodes.size(); i++) {
+
+            local_a[i] = a[nodes[i]];
+        }
+
+        Communities local_communities = greedy_modularity_communities<TQ, TId, TConnectionWeight, TInstrumentation>(
+            nodes.size(),
+            std::span<const TId>(local_from.data() + begin, count),
+            std::span<const TId>(local_to.data() + begin, count),
+            std::span<const TConnectionWeight>(local_values.data() + begin, count),
+            std::move(local_a), reverse_m, resolution, 1, false, negative_infinity, 1, instrumentation);
+
+        for (auto& community : local_communities) {
+
+            for (auto& id : community) {
+
+                id = nodes[id];
+            }
+
+            TId survivor = community.front();
+            communities_by_survivor[survivor] = std::move(community);
+        }
+    };
+
+    std::vector<size_t> order(component_count);
+    std::iota(order.begin(), order.end(), 0);
+    std::sort(order.begin(), order.end(), [&](size_t x, size_t y) { return components.component_size(x) > components.component_size(y); });
+
+    {
+        parallel::ThreadPool pool(thread_count);
+        std::vector<std::future<void>> tasks;
+
+        for (size_t component : order) {
+
+            size_t size = components.component_size(component);
+
+            if (size == 1) {
+
+                TId node = components.component_nodes(component)[0];
+                communities_by_survivor[node] = std::vector<TId> { node };
+            } else if (size == 2) {
+
+                cluster_pair(component);
+            } else {
+
+                tasks.push_back(pool.submit([&, component]() { cluster_component(component); }));
+            }
+        }
+
+        for (auto& task : tasks) {
+
+            task.get();
+        }
+    }
+
+    Communities result;
+
+    for (size_t i = 0; i < node_count; i++) {
+
+        if (communities_by_survivor[i].size() > 0) {
+
+            result.push_back(std::move(communities_by_survivor[i]));
+        }
+    }
+
+    return result;
+}
+
+template <
+    typename TQ,
+    template <typename> typename TAllocator,
+    typename TId,
+    typename TConnectionWeight,
+    typename TCoordinates,
+    typename TZIndex,
+    typename... TNodeFeatures,
+    typename TInstrumentation = NoInstrumentation>
+std::vector<std::vector<TId>> greedy_modularity_communities_by_components(
+    const ograph::BasicOGraph<
+        TAllocator,
+        TId,
+        TConnectionWeight,
+        TCoordinates,
+        TZIndex,
+        TNodeFeatures...>& graph,
+    TQ resolution = 1.0f,
+    bool verbose = false,
+    TQ negative_infinity = -2605,
+    size_t thread_count = 0,
+    TInstrumentation instrumentation = TInstrumentation())
+{
+
+    size_t node_count = graph.node_count();
+
+    std::span<const TId> from_ids(graph.m_connections.m_from);
+    std::span<const TId> to_ids(graph.m_connections.m_to);
+    std::span<const TConnectionWeight> values(graph.m_connections.m_values);
+
+    auto [a, reverse_m] = [&]() {
+        [[maybe_unused]] auto timer = instrumentation.time_phase(ClusteringPhase::Degrees);
+        return create_normal_weighted_degrees<TQ>(node_count, from_ids, to_ids, values);
+    }();
+
+    return greedy_modularity_communities_by_components<TQ, TId, TConnectionWeight, TInstrumentation>(
+        node_count, from_ids, to_ids, values, a, reverse_m, resolution, verbose, negative_infinity, thread_count, instrumentation);
+}
+}
+
+#endif
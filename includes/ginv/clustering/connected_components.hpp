@@ -0,0 +1,183 @@
+#ifndef CONNECTED_COMPONENTS_HPP_
+#define CONNECTED_COMPONENTS_HPP_
+
+#include <atomic>
+#include <span>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include <ginv/parallel/parallel_for.hpp>
+#include <osigma/oconnections.hpp>
+
+namespace clustering {
+
+// Components are numbered by their smallest node id and list their nodes in increasing id order
+template <typename TId>
+class ConnectedComponents {
+
+public:
+    std::vector<TId> m_labels;
+    std::vector<size_t> m_offsets;
+    std::vector<TId> m_nodes;
+
+    explicit ConnectedComponents(std::vector<TId> labels, std::vector<size_t> offsets, std::vector<TId> nodes)
+        : m_labels(std::move(labels))
+        , m_offsets(std::move(offsets))
+        , m_nodes(std::move(nodes))
+    {
+    }
+
+    size_t component_count() const
+    {
+
+        return m_offsets.size() - 1;
+    }
+
+    size_t component_size(size_t component) const
+    {
+
+        return m_offsets[component + 1] - m_offsets[component];
+    }
+
+    std::span<const TId> component_nodes(size_t component) const
+    {
+
+        return std::span<const TId>(m_nodes.data() + m_offsets[component], component_size(component));
+    }
+
+    std::string describe() const
+    {
+
+        return "ConnectedComponents(" + std::to_string(component_count()) + " components of " + std::to_string(m_labels.size()) + " nodes)";
+    }
+};
+
+template <typename TId>
+TId find_component_root(std::vector<std::atomic<TId>>& parents, TId id)
+{
+
+    while (true) {
+
+        TId parent = parents[id].load(std::memory_order_acquire);
+
+        if (parent == id) {
+
+            return id;
+        }
+
+        TId grandparent = parents[parent].load(std::memory_order_acquire);
+
+        if (parent != grandparent) {
+
+            parents[id].compare_exchange_weak(parent, grandparent, std::memory_order_acq_rel);
+        }
+
+        id = grandparent;
+    }
+}
+
+// Lock-free union: the larger root is always linked under the smaller one, so roots end up as component minima
+template <typename TId>
+void unite_components(std::vector<std::atomic<TId>>& parents, TId a, TId b)
+{
+
+    while (true) {
+
+        a = find_component_root(parents, a);
+        b = find_component_root(parents, b);
+
+        if (a == b) {
+
+            return;
+        }
+
+        if (a < b) {
+
+            std::swap(a, b);
+        }
+
+        TId expected = a;
+
+        if (parents[a].compare_exchange_strong(expected, b, std::memory_order_acq_rel)) {
+
+            return;
+        }
+    }
+}
+
+template <typename TId>
+ConnectedComponents<TId> connected_components(
+    size_t node_count,
+    std::span<const TId> from_ids,
+    std::span<const TId> to_ids,
+    size_t thread_count = 0)
+{
+
+    std::vector<std::atomic<TId>> parents(node_count);
+
+    parallel::parallel_for(
+        0, node_count, [&](size_t i) { parents[i].store(TId(i), std::memory_order_relaxed); },
+        thread_count, 1 << 16);
+
+    parallel::parallel_for(
+        0, from_ids.size(), [&](size_t i) {
+            if (from_ids[i] != to_ids[i]) {
+
+                unite_components(parents, from_ids[i], to_ids[i]);
+            }
+        },
+        thread_count, 1 << 14);
+
+    std::vector<TId> roots(node_count);
+
+    parallel::parallel_for(
+        0, node_count, [&](size_t i) { roots[i] = find_component_root(parents, TId(i)); },
+        thread_count, 1 << 16);
+
+    std::vector<TId> labels(node_count);
+    std::vector<size_t> offsets(1, 0);
+
+    for (size_t i = 0; i < node_count; i++) {
+
+        if (roots[i] == TId(i)) {
+
+            labels[i] = TId(offsets.size() - 1);
+            offsets.push_back(0);
+        } else {
+
+            labels[i] = labels[roots[i]];
+        }
+
+        offsets[labels[i] + 1]++;
+    }
+
+    for (size_t i = 1; i < offsets.size(); i++) {
+
+        offsets[i] += offsets[i - 1];
+    }
+
+    std::vector<TId> nodes(node_count);
+    std::vector<size_t> cursors(offsets.begin(), offsets.end() - 1);
+
+    for (size_t i = 0; i < node_count; i++) {
+
+        nodes[cursors[labels[i]]++] = TId(i);
+    }
+
+    return ConnectedComponents<TId>(std::move(labels), std::move(offsets), std::move(nodes));
+}
+
+template <template <typename> typename TAllocator, typename TId, typename TValue, typename... TFeatures>
+ConnectedComponents<TId> connected_components(
+    size_t node_count,
+    const ograph::BasicOConnections<TAllocator, TId, TValue, TFeatures...>& connections,
+    size_t thread_count = 0)
+{
+
+    return connected_components<TId>(
+        node_count, std::span<const TId>(connections.m_from), std::span<const TId>(connections.m_to), thread_count);
+}
+}
+
+#endif
@@ -1,44 +1,71 @@
 #ifndef DECAYING_MAX_HEAP_HPP_
 #define DECAYING_MAX_HEAP_HPP_
 
-#include <map>
 #include <string>
 #include <tuple>
+#include <utility>
 #include <vector>
 
+#include <ginv/clustering/heap_key_storage.hpp>
+#include <ginv/clustering/instrumentation.hpp>
+
 namespace clustering {
 
 template <
+    typename TInstrumentation,
     typename TValue,
     typename... TKeys>
-class DecayingMaxHeap {
+class InstrumentedDecayingMaxHeap {
     typedef std::tuple<TKeys...> TKeysTuple;
     typedef std::tuple<TKeys..., TValue> TKeysValueTuple;
-    typedef std::tuple<std::vector<TKeys>...> TKeysVectorTuple;
+    typedef HeapKeyStorage<TKeys...> TKeyStorage;
+    typedef typename TKeyStorage::TStoredKey TStoredKey;
 
 public:
-    TKeysVectorTuple m_heap_keys;
+    TKeyStorage m_heap_keys;
     std::vector<TValue> m_heap_values;
-    std::map<TKeysTuple, size_t> m_node_position_map;
+    typename TKeyStorage::TPositionMap m_node_position_map;
+    [[no_unique_address]] TInstrumentation m_instrumentation;
 
-    explicit DecayingMaxHeap(size_t size)
+    explicit InstrumentedDecayingMaxHeap(size_t size, TInstrumentation instrumentation = TInstrumentation())
+        : m_instrumentation(instrumentation)
     {
 
         m_heap_values.reserve(size);
+        m_heap_keys.reserve(size);
+    }
+
+    // Builds the heap from key and value columns in O(n) and fills the position map once per element
+    explicit InstrumentedDecayingMaxHeap(std::vector<TKeys>... keys, std::vector<TValue> values, TInstrumentation instrumentation = TInstrumentation())
+        : m_heap_keys(std::move(keys)...)
+        , m_heap_values(std::move(values))
+        , m_instrumentation(instrumentation)
+    {
 
-        std::apply([size](auto&... vectors) { (vectors.reserve(size), ...); },
-            m_heap_keys);
+        heapify();
+    }
+
+    // Takes key and value columns in the order another heap held them, e.g. saved to a checkpoint, and keeps it
+    static InstrumentedDecayingMaxHeap from_heap_order(std::vector<TKeys>... keys, std::vector<TValue> values, TInstrumentation instrumentation = TInstrumentation())
+    {
+
+        InstrumentedDecayingMaxHeap heap(0, instrumentation);
+        heap.m_heap_keys = TKeyStorage(std::move(keys)...);
+        heap.m_heap_values = std::move(values);
+        heap.map_positions();
+
+        return heap;
     }
 
     void push(TKeys... keys, TValue value)
     {
 
-        std::apply([&](auto&... vectors) { (vectors.push_back(keys), ...); },
-            m_heap_keys);
+        TStoredKey key = TKeyStorage::store(std::make_tuple(keys...));
 
+        m_heap_keys.push_back(key);
         m_heap_values.push_back(value);
 
-        siftdown(0, size() - 1, value, std::make_tuple(keys...));
+        siftdown(0, size() - 1, value, key);
     }
 
     void push(TKeysTuple keys_tuple, TValue value)
@@ -67,18 +94,16 @@ public:
 
     TKeysValueTuple top()
     {
-        return std::apply([&](auto&... vectors) { return std::make_tuple(vectors[0]..., m_heap_values[0]); },
-            m_heap_keys);
+        return std::tuple_cat(key_at(0), std::make_tuple(m_heap_values[0]));
     }
 
     TKeysValueTuple pop()
     {
 
         size_t latest_id = size() - 1;
-        TKeysTuple result_key = top_key();
         TKeysValueTuple result = top();
 
-        remove_node_position_in_map(result_key);
+        remove_node_position_in_map(m_heap_keys.at(0));
 
         if (latest_id > 0) {
 
@@ -86,7 +111,7 @@ public:
 
             reduce_size();
 
-            siftup(0, size(), top_value(), top_key());
+            siftup(0, size(), value_at(0), m_heap_keys.at(0));
         } else {
 
             reduce_size();
@@ -99,19 +124,19 @@ public:
     {
 
         size_t latest_id = size() - 1;
-        size_t position = get_node_position_in_map(keys);
-        TKeysTuple output_key = key_at(position);
+        TStoredKey key = TKeyStorage::store(keys);
+        size_t position = get_node_position_in_map(key);
         TValue value = value_at(position);
 
-        remove_node_position_in_map(keys);
+        remove_node_position_in_map(key);
 
-        if (latest_id > 0) {
+        if (position < latest_id) {
 
             assign(position, latest_id);
 
             reduce_size();
 
-            siftup(position, size(), value_at(position), key_at(position));
+            siftup(position, size(), value_at(position), m_heap_keys.at(position));
         } else {
 
             reduce_size();
@@ -129,16 +154,17 @@ public:
     void update_value(TKeysTuple keys, TValue new_value)
     {
 
-        size_t position = get_node_position_in_map(keys);
+        TStoredKey key = TKeyStorage::store(keys);
+        size_t position = get_node_position_in_map(key);
         TValue old_value = value_at(position);
         m_heap_values[position] = new_value;
 
         if (new_value > old_value) {
 
-            siftdown(0, position, new_value, keys);
+            siftdown(0, position, new_value, key);
         } else {
 
-            siftup(position, size() - 1, new_value, keys);
+            siftup(position, size() - 1, new_value, key);
         }
     }
 
@@ -157,14 +183,13 @@ public:
     std::string describe() const
     {
 
-        return "DecayingMaxHeap(" + std::to_string(std::tuple_size<TKeysVectorTuple>()) + " keys and a value of " + std::to_string(m_heap_values.size()) + " heap elements)";
+        return "DecayingMaxHeap(" + std::to_string(sizeof...(TKeys)) + " keys and a value of " + std::to_string(m_heap_values.size()) + " heap elements)";
     }
 
     std::string describe_element(size_t element_id) const
     {
 
-        TKeysTuple keys = std::apply([element_id](auto&... vectors) { return std::make_tuple(vectors[element_id]...); },
-            m_heap_keys);
+        TKeysTuple keys = TKeyStorage::load(m_heap_keys.at(element_id));
 
         std::string keys_str = std::apply([](auto&... values) { return ((std::to_string(values) + ", ") + ...); },
             keys);
@@ -176,8 +201,7 @@ public:
     TKeysTuple key_at(size_t element_id)
     {
 
-        return std::apply([element_id](auto&... vectors) { return std::make_tuple(vectors[element_id]...); },
-            m_heap_keys);
+        return TKeyStorage::load(m_heap_keys.at(element_id));
     }
 
     TValue value_at(size_t element_id)
@@ -187,38 +211,91 @@ public:
     }
 
     void assign(size_t target, size_t source)
+    {
+        assign_unmapped(target, source);
+
+        set_node_position_in_map(m_heap_keys.at(target), target);
+    }
+
+    void assign_unmapped(size_t target, size_t source)
     {
         m_heap_values[target] = m_heap_values[source];
+        m_heap_keys.copy(target, source);
+    }
 
-        [&]<std::size_t... Is>(std::index_sequence<Is...>) {
-            ([&]() {
-                auto& vector = std::get<Is>(m_heap_keys);
-                vector[target] = vector[source];
-            }(),
-                ...);
-        }(std::index_sequence_for<TKeys...>());
+    void assign_value(size_t target, TValue value, TStoredKey key)
+    {
+        assign_value_unmapped(target, value, key);
 
-        set_node_position_in_map(key_at(target), target);
+        set_node_position_in_map(key, target);
     }
 
-    void assign_value(size_t target, TValue value, TKeysTuple key)
+    void assign_value_unmapped(size_t target, TValue value, TStoredKey key)
     {
 
         m_heap_values[target] = value;
+        m_heap_keys.set(target, key);
+    }
+
+    void heapify()
+    {
 
-        [&]<std::size_t... Is>(std::index_sequence<Is...>) {
-            ([&]() {
-                auto& vector = std::get<Is>(m_heap_keys);
-                auto& val = std::get<Is>(key);
-                vector[target] = val;
-            }(),
-                ...);
-        }(std::index_sequence_for<TKeys...>());
+        for (size_t position = size() / 2; position-- > 0;) {
 
-        set_node_position_in_map(key, target);
+            heapify_siftup(position);
+        }
+
+        map_positions();
     }
 
-    void siftdown(size_t start, size_t position, TValue new_value, TKeysTuple new_key)
+    void map_positions()
+    {
+
+        m_node_position_map.clear();
+
+        if constexpr (requires { m_node_position_map.reserve(size()); }) {
+
+            m_node_position_map.reserve(size());
+        }
+
+        for (size_t i = 0; i < size(); i++) {
+
+            set_node_position_in_map(m_heap_keys.at(i), i);
+        }
+    }
+
+    // Floyd's sift towards the leaves: stops at the first child that is not strictly greater.
+    // The order among equal values is unspecified and may differ from that of sequential pushes
+    void heapify_siftup(size_t position)
+    {
+        size_t end = size();
+        TValue value = value_at(position);
+        TStoredKey key = m_heap_keys.at(position);
+
+        size_t child_position = 2 * position + 1;
+
+        while (child_position < end) {
+
+            size_t right_child_position = child_position + 1;
+
+            if ((right_child_position < end) && (m_heap_values[right_child_position] > m_heap_values[child_position])) {
+                child_position = right_child_position;
+            }
+
+            if (!(m_heap_values[child_position] > value)) {
+                break;
+            }
+
+            m_instrumentation.count_sift();
+            assign_unmapped(position, child_position);
+            position = child_position;
+            child_position = 2 * position + 1;
+        }
+
+        assign_value_unmapped(position, value, key);
+    }
+
+    void siftdown(size_t start, size_t position, TValue new_value, TStoredKey new_key)
     {
 
         while (position > start) {
@@ -227,6 +304,7 @@ public:
             TValue parent_value = value_at(parent);
 
             if (new_value > parent_value) {
+                m_instrumentation.count_sift();
                 assign(position, parent);
                 position = parent;
             } else {
@@ -238,7 +316,7 @@ public:
         assign_value(position, new_value, new_key);
     }
 
-    void siftup(size_t position, size_t end, TValue new_value, TKeysTuple new_key)
+    void siftup(size_t position, size_t end, TValue new_value, TStoredKey new_key)
     {
         size_t start = position;
 
@@ -252,6 +330,7 @@ public:
                 child_position = right_child_position;
             }
 
+            m_instrumentation.count_sift();
             assign(position, child_position);
             position = child_position;
             child_position = 2 * position + 1;
@@ -262,18 +341,21 @@ public:
         siftdown(start, position, new_value, new_key);
     }
 
-    void remove_node_position_in_map(TKeysTuple key)
+    void remove_node_position_in_map(TStoredKey key)
     {
+        m_instrumentation.count_map_lookup();
         m_node_position_map.erase(key);
     }
 
-    size_t get_node_position_in_map(TKeysTuple key)
+    size_t get_node_position_in_map(TStoredKey key)
     {
+        m_instrumentation.count_map_lookup();
         return m_node_position_map.at(key);
     }
 
-    void set_node_position_in_map(TKeysTuple key, size_t position)
+    void set_node_position_in_map(TStoredKey key, size_t position)
     {
+        m_instrumentation.count_map_lookup();
         m_node_position_map[key] = position;
     }
 
@@ -281,13 +363,14 @@ public:
     {
 
         m_heap_values.pop_back();
-
-        std::apply([](auto&... vectors) {
-            (vectors.pop_back(), ...);
-        },
-            m_heap_keys);
+        m_heap_keys.pop_back();
     }
 };
+
+template <
+    typename TValue,
+    typename... TKeys>
+using DecayingMaxHeap = InstrumentedDecayingMaxHeap<NoInstrumentation, TValue, TKeys...>;
 }
 
-#endif
\ No newline at end of file
+#endif
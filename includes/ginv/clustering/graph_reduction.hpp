@@ -0,0 +1,407 @@
+#ifndef GRAPH_REDUCTION_HPP_
+#define GRAPH_REDUCTION_HPP_
+
+#include <algorithm>
+#include <numeric>
+#include <queue>
+#include <span>
+#include <string>
+#include <tuple>
+#include <vector>
+
+#include <ginv/clustering/clauset_newman_moore.hpp>
+#include <osigma/ograph.hpp>
+
+namespace clustering {
+
+// Active clustering problem left after removing isolated nodes and absorbing leaf chains.
+// Reduced nodes carry the summed degrees of the nodes absorbed into them, so clustering the
+// reduced columns with the original 1/m keeps modularity gains of the full graph.
+template <
+    typename TQ,
+    typename TId,
+    typename TConnectionWeight>
+class GraphReduction {
+
+public:
+    size_t m_node_count;
+    std::vector<TId> m_from;
+    std::vector<TId> m_to;
+    std::vector<TConnectionWeight> m_values;
+    std::vector<TQ> m_a;
+    std::vector<TId> m_original_ids;
+    std::vector<TId> m_finished_roots;
+    std::vector<size_t> m_member_offsets;
+    std::vector<TId> m_members;
+    std::vector<size_t> m_root_positions;
+
+    explicit GraphReduction(
+        size_t node_count,
+        std::vector<TId> from, std::vector<TId> to, std::vector<TConnectionWeight> values, std::vector<TQ> a,
+        std::vector<TId> original_ids, std::vector<TId> finished_roots,
+        std::vector<size_t> member_offsets, std::vector<TId> members, std::vector<size_t> root_positions)
+        : m_node_count(node_count)
+        , m_from(std::move(from))
+        , m_to(std::move(to))
+        , m_values(std::move(values))
+        , m_a(std::move(a))
+        , m_original_ids(std::move(original_ids))
+        , m_finished_roots(std::move(finished_roots))
+        , m_member_offsets(std::move(member_offsets))
+        , m_members(std::move(members))
+        , m_root_positions(std::move(root_positions))
+    {
+    }
+
+    // Original nodes represented by a root, starting with the root itself
+    std::span<const TId> members(TId root) const
+    {
+
+        size_t position = m_root_positions[root];
+
+        return std::span<const TId>(m_members.data() + m_member_offsets[position], m_member_offsets[position + 1] - m_member_offsets[position]);
+    }
+
+    std::vector<std::vector<TId>> expand(const std::vector<std::vector<TId>>& reduced_communities) const
+    {
+
+        std::vector<std::vector<TId>> communities_by_survivor(m_root_positions.size());
+
+        for (auto const& reduced_community : reduced_communities) {
+
+            if (reduced_community.empty()) {
+
+                continue;
+            }
+
+            std::vector<TId> community;
+
+            for (auto reduced_id : reduced_community) {
+
+                auto root_members = members(m_original_ids[reduced_id]);
+                community.insert(community.end(), root_members.begin(), root_members.end());
+            }
+
+            communities_by_survivor[community.front()] = std::move(community);
+        }
+
+        for (auto root : m_finished_roots) {
+
+            auto root_members = members(root);
+            communities_by_survivor[root] = std::vector<TId>(root_members.begin(), root_members.end());
+        }
+
+        std::vector<std::vector<TId>> result;
+
+        for (auto& community : communities_by_survivor) {
+
+            if (community.size() > 0) {
+
+                result.push_back(std::move(community));
+            }
+        }
+
+        return result;
+    }
+
+    std::string describe() const
+    {
+
+        return "GraphReduction(" + std::to_string(m_node_count) + " active nodes and " + std::to_string(m_from.size()) + " connections of "
+            + std::to_string(m_root_positions.size()) + " nodes with " + std::to_string(m_finished_roots.size()) + " finished communities)";
+    }
+};
+
+// Removes isolated nodes and absorbs degree-1 nodes into their only neighbour while the merge does not
+// decrease modularity, repeating along chains. Parallel connections are summed and self loops are dropped.
+template <
+    typename TQ,
+    typename TId,
+    typename TConnectionWeight>
+GraphReduction<TQ, TId, TConnectionWeight> reduce_graph(
+    size_t node_count,
+    std::span<const TId> from_ids,
+    std::span<const TId> to_ids,
+    std::span<const TConnectionWeight> values,
+    std::vector<TQ> a,
+    TQ reverse_m,
+    TQ resolution = 1.0f)
+{
+
+    std::vector<size_t> order;
+    order.reserve(from_ids.size());
+
+    for (size_t i = 0; i < from_ids.size(); i++) {
+
+        if (from_ids[i] != to_ids[i]) {
+
+            order.push_back(i);
+        }
+    }
+
+    auto edge_key = [&](size_t i) {
+        return std::make_tuple(std::min(from_ids[i], to_ids[i]), std::max(from_ids[i], to_ids[i]));
+    };
+
+    std::sort(order.begin(), order.end(), [&](size_t x, size_t y) { return edge_key(x) < edge_key(y); });
+
+    std::vector<TId> edge_from;
+    std::vector<TId> edge_to;
+    std::vector<TConnectionWeight> edge_values;
+
+    for (size_t i : order) {
+
+        auto [from, to] = edge_key(i);
+
+        if (edge_from.size() > 0 && edge_from.back() == from && edge_to.back() == to) {
+
+            edge_values.back() += values[i];
+        } else {
+
+            edge_from.push_back(from);
+            edge_to.push_back(to);
+            edge_values.push_back(values[i]);
+        }
+    }
+
+    std::vector<size_t> offsets(node_count + 1, 0);
+
+    for (size_t i = 0; i < edge_from.size(); i++) {
+
+        offsets[edge_from[i] + 1]++;
+        offsets[edge_to[i] + 1]++;
+    }
+
+    for (size_t i = 1; i < offsets.size(); i++) {
+
+        offsets[i] += offsets[i - 1];
+    }
+
+    std::vector<size_t> adjacent_edges(offsets.back());
+    std::vector<size_t> cursors(offsets.begin(), offsets.end() - 1);
+
+    for (size_t i = 0; i < edge_from.size(); i++) {
+
+        adjacent_edges[cursors[edge_from[i]]++] = i;
+        adjacent_edges[cursors[edge_to[i]]++] = i;
+    }
+
+    std::vector<size_t> remaining_degrees(node_count);
+    std::vector<TId> parents(node_count);
+    std::vector<uint8_t> absorbed(node_count, 0);
+    std::queue<TId> leaves;
+
+    for (size_t i = 0; i < node_count; i++) {
+
+        remaining_degrees[i] = offsets[i + 1] - offsets[i];
+        parents[i] = TId(i);
+
+        if (remaining_degrees[i] == 1) {
+
+            leaves.push(TId(i));
+        }
+    }
+
+    while (!leaves.empty()) {
+
+        TId leaf = leaves.front();
+        leaves.pop();
+
+        if (absorbed[leaf] || remaining_degrees[leaf] != 1) {
+
+            continue;
+        }
+
+        size_t edge = 0;
+        TId neighbour = leaf;
+
+        for (size_t i = offsets[leaf]; i < offsets[leaf + 1]; i++) {
+
+            edge = adjacent_edges[i];
+            neighbour = edge_from[edge] == leaf ? edge_to[edge] : edge_from[edge];
+
+            if (!absorbed[neighbour]) {
+
+                break;
+            }
+        }
+
+        TQ delta_q = reverse_m * edge_values[edge] - resolution * 2 * a[leaf] * a[neighbour];
+
+        if (delta_q < 0) {
+
+            continue;
+        }
+
+        absorbed[leaf] = 1;
+        parents[leaf] = neighbour;
+        remaining_degrees[leaf] = 0;
+        a[neighbour] += a[leaf];
+        a[leaf] = 0;
+
+        if (--remaining_degrees[neighbour] == 1) {
+
+            leaves.push(neighbour);
+        }
+    }
+
+    auto find_root = [&](TId id) {
+        TId root = id;
+
+        while (parents[root] != root) {
+
+            root = parents[root];
+        }
+
+        while (parents[id] != root) {
+
+            TId next = parents[id];
+            parents[id] = root;
+            id = next;
+        }
+
+        return root;
+    };
+
+    std::vector<TId> roots(node_count);
+
+    for (size_t i = 0; i < node_count; i++) {
+
+        roots[i] = find_root(TId(i));
+    }
+
+    std::vector<size_t> root_positions(node_count, 0);
+    std::vector<size_t> member_offsets(1, 0);
+    std::vector<TId> original_ids;
+    std::vector<TId> finished_roots;
+    std::vector<TId> reduced_ids(node_count, TId(-1));
+
+    for (size_t i = 0; i < node_count; i++) {
+
+        if (roots[i] == TId(i)) {
+
+            root_positions[i] = member_offsets.size() - 1;
+            member_offsets.push_back(0);
+
+            if (remaining_degrees[i] > 0) {
+
+                reduced_ids[i] = TId(original_ids.size());
+                original_ids.push_back(TId(i));
+            } else {
+
+                finished_roots.push_back(TId(i));
+            }
+        }
+    }
+
+    for (size_t i = 0; i < node_count; i++) {
+
+        member_offsets[root_positions[roots[i]] + 1]++;
+    }
+
+    for (size_t i = 1; i < member_offsets.size(); i++) {
+
+        member_offsets[i] += member_offsets[i - 1];
+    }
+
+    std::vector<TId> members(node_count);
+    std::vector<size_t> member_cursors(member_offsets.begin(), member_offsets.end() - 1);
+
+    for (size_t i = 0; i < node_count; i++) {
+
+        if (roots[i] == TId(i)) {
+
+            members[member_cursors[root_positions[i]]++] = TId(i);
+        }
+    }
+
+    for (size_t i = 0; i < node_count; i++) {
+
+        if (roots[i] != TId(i)) {
+
+            members[member_cursors[root_positions[roots[i]]]++] = TId(i);
+        }
+    }
+
+    std::vector<TId> reduced_from;
+    std::vector<TId> reduced_to;
+    std::vector<TConnectionWeight> reduced_values;
+    std::vector<TQ> reduced_a(original_ids.size());
+
+    for (size_t i = 0; i < edge_from.size(); i++) {
+
+        if (!absorbed[edge_from[i]] && !absorbed[edge_to[i]]) {
+
+            reduced_from.push_back(reduced_ids[edge_from[i]]);
+            reduced_to.push_back(reduced_ids[edge_to[i]]);
+            reduced_values.push_back(edge_values[i]);
+        }
+    }
+
+    for (size_t i = 0; i < original_ids.size(); i++) {
+
+        reduced_a[i] = a[original_ids[i]];
+    }
+
+    size_t reduced_node_count = original_ids.size();
+
+    return GraphReduction<TQ, TId, TConnectionWeight>(
+        reduced_node_count, std::move(reduced_from), std::move(reduced_to), std::move(reduced_values), std::move(reduced_a),
+        std::move(original_ids), std::move(finished_roots), std::move(member_offsets), std::move(members), std::move(root_positions));
+}
+
+template <
+    typename TQ,
+    template <typename> typename TAllocator,
+    typename TId,
+    typename TConnectionWeight,
+    typename TCoordinates,
+    typename TZIndex,
+    typename... TNodeFeatures,
+    typename TInstrumentation = NoInstrumentation>
+std::vector<std::vector<TId>> greedy_modularity_communities_with_reduction(
+    const ograph::BasicOGraph<
+        TAllocator,
+        TId,
+        TConnectionWeight,
+        TCoordinates,
+        TZIndex,
+        TNodeFeatures...>& graph,
+    TQ resolution = 1.0f,
+    size_t cutoff = 1,
+    bool verbose = false,
+    TQ negative_infinity = -2605,
+    size_t thread_count = 0,
+    TInstrumentation instrumentation = TInstrumentation())
+{
+
+    std::span<const TId> from_ids(graph.m_connections.m_from);
+    std::span<const TId> to_ids(graph.m_connections.m_to);
+    std::span<const TConnectionWeight> values(graph.m_connections.m_values);
+
+    auto [a, reverse_m] = [&]() {
+        [[maybe_unused]] auto timer = instrumentation.time_phase(ClusteringPhase::Degrees);
+        return create_normal_weighted_degrees<TQ>(graph.node_count(), from_ids, to_ids, values);
+    }();
+
+    GraphReduction<TQ, TId, TConnectionWeight> reduction = [&]() {
+        [[maybe_unused]] auto timer = instrumentation.time_phase(ClusteringPhase::Reduction);
+        return reduce_graph<TQ, TId, TConnectionWeight>(graph.node_count(), from_ids, to_ids, values, std::move(a), reverse_m, resolution);
+    }();
+
+    if (verbose) {
+        std::cout << reduction.describe() << std::endl;
+    }
+
+    std::vector<std::vector<TId>> reduced_communities = greedy_modularity_communities<TQ, TId, TConnectionWeight, TInstrumentation>(
+        reduction.m_node_count,
+        std::span<const TId>(reduction.m_from),
+        std::span<const TId>(reduction.m_to),
+        std::span<const TConnectionWeight>(reduction.m_values),
+        reduction.m_a, reverse_m, resolution, cutoff, verbose, negative_infinity, thread_count, instrumentation);
+
+    return reduction.expand(reduced_communities);
+}
+}
+
+#endif
@@ -0,0 +1,196 @@
+#ifndef HEAP_KEY_STORAGE_HPP_
+#define HEAP_KEY_STORAGE_HPP_
+
+#include <cstdint>
+#include <map>
+#include <string>
+#include <tuple>
+#include <type_traits>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+namespace clustering {
+
+// Several small integer keys fit into one machine word when their widths add up to 64 bits or less
+template <typename... TKeys>
+constexpr bool packable_keys = (sizeof...(TKeys) > 1)
+    && ((std::is_integral_v<TKeys> && !std::is_same_v<TKeys, bool>) && ...)
+    && ((sizeof(TKeys) + ...) <= sizeof(uint64_t));
+
+// Stores every key in its own column and looks positions up by the key tuple
+template <typename... TKeys>
+class TupleKeyStorage {
+
+public:
+    typedef std::tuple<TKeys...> TKeysTuple;
+    typedef TKeysTuple TStoredKey;
+    typedef std::map<TKeysTuple, size_t> TPositionMap;
+
+    std::tuple<std::vector<TKeys>...> m_keys;
+
+    explicit TupleKeyStorage() = default;
+
+    explicit TupleKeyStorage(std::vector<TKeys>... keys)
+        : m_keys(std::move(keys)...)
+    {
+    }
+
+    static TStoredKey store(const TKeysTuple& keys)
+    {
+
+        return keys;
+    }
+
+    static TKeysTuple load(const TStoredKey& key)
+    {
+
+        return key;
+    }
+
+    TStoredKey at(size_t element_id) const
+    {
+
+        return std::apply([element_id](auto&... vectors) { return std::make_tuple(vectors[element_id]...); },
+            m_keys);
+    }
+
+    void set(size_t target, const TStoredKey& key)
+    {
+
+        [&]<std::size_t... Is>(std::index_sequence<Is...>) {
+            ((std::get<Is>(m_keys)[target] = std::get<Is>(key)), ...);
+        }(std::index_sequence_for<TKeys...>());
+    }
+
+    void copy(size_t target, size_t source)
+    {
+
+        std::apply([&](auto&... vectors) { ((vectors[target] = vectors[source]), ...); },
+            m_keys);
+    }
+
+    void push_back(const TStoredKey& key)
+    {
+
+        [&]<std::size_t... Is>(std::index_sequence<Is...>) {
+            (std::get<Is>(m_keys).push_back(std::get<Is>(key)), ...);
+        }(std::index_sequence_for<TKeys...>());
+    }
+
+    void pop_back()
+    {
+
+        std::apply([](auto&... vectors) { (vectors.pop_back(), ...); },
+            m_keys);
+    }
+
+    void reserve(size_t size)
+    {
+
+        std::apply([size](auto&... vectors) { (vectors.reserve(size), ...); },
+            m_keys);
+    }
+};
+
+// Packs all keys into a single uint64_t column, first key in the highest bits,
+// so that storage, moves and position lookups cost the same as for a single key
+template <typename... TKeys>
+class PackedKeyStorage {
+
+public:
+    typedef std::tuple<TKeys...> TKeysTuple;
+    typedef uint64_t TStoredKey;
+    typedef std::unordered_map<uint64_t, size_t> TPositionMap;
+
+    std::vector<uint64_t> m_keys;
+
+    explicit PackedKeyStorage() = default;
+
+    explicit PackedKeyStorage(std::vector<TKeys>... keys)
+    {
+
+        size_t size = std::get<0>(std::forward_as_tuple(keys...)).size();
+        m_keys.resize(size);
+
+        for (size_t i = 0; i < size; i++) {
+
+            m_keys[i] = store(std::make_tuple(keys[i]...));
+        }
+    }
+
+    static TStoredKey store(const TKeysTuple& keys)
+    {
+
+        uint64_t result = 0;
+
+        std::apply([&](auto... key) {
+            ((result = (result << (sizeof(key) * 8)) | uint64_t(std::make_unsigned_t<decltype(key)>(key))), ...);
+        },
+            keys);
+
+        return result;
+    }
+
+    static TKeysTuple load(TStoredKey key)
+    {
+
+        TKeysTuple result;
+        size_t shift = 0;
+
+        [&]<std::size_t... Is>(std::index_sequence<Is...>) {
+            ([&]() {
+                constexpr size_t I = sizeof...(TKeys) - 1 - Is;
+                typedef std::tuple_element_t<I, TKeysTuple> TKey;
+
+                std::get<I>(result) = TKey(std::make_unsigned_t<TKey>(key >> shift));
+                shift += sizeof(TKey) * 8;
+            }(),
+                ...);
+        }(std::index_sequence_for<TKeys...>());
+
+        return result;
+    }
+
+    TStoredKey at(size_t element_id) const
+    {
+
+        return m_keys[element_id];
+    }
+
+    void set(size_t target, TStoredKey key)
+    {
+
+        m_keys[target] = key;
+    }
+
+    void copy(size_t target, size_t source)
+    {
+
+        m_keys[target] = m_keys[source];
+    }
+
+    void push_back(TStoredKey key)
+    {
+
+        m_keys.push_back(key);
+    }
+
+    void pop_back()
+    {
+
+        m_keys.pop_back();
+    }
+
+    void reserve(size_t size)
+    {
+
+        m_keys.reserve(size);
+    }
+};
+
+template <typename... TKeys>
+using HeapKeyStorage = std::conditional_t<packable_keys<TKeys...>, PackedKeyStorage<TKeys...>, TupleKeyStorage<TKeys...>>;
+}
+
+#endif
@@ -0,0 +1,201 @@
+#ifndef CLUSTERING_INSTRUMENTATION_HPP_
+#define CLUSTERING_INSTRUMENTATION_HPP_
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <string>
+
+namespace clustering {
+
+enum class ClusteringPhase {
+    Degrees,
+    DeltaQ,
+    Heaps,
+    Merges,
+    Components,
+    Reduction,
+};
+
+constexpr size_t CLUSTERING_PHASE_COUNT = 6;
+
+inline std::string phase_name(ClusteringPhase phase)
+{
+
+    switch (phase) {
+    case ClusteringPhase::Degrees:
+        return "degrees";
+    case ClusteringPhase::DeltaQ:
+        return "delta_q";
+    case ClusteringPhase::Heaps:
+        return "heaps";
+    case ClusteringPhase::Merges:
+        return "merges";
+    case ClusteringPhase::Components:
+        return "components";
+    case ClusteringPhase::Reduction:
+        return "reduction";
+    }
+
+    return "unknown";
+}
+
+// Counters filled by StatsInstrumentation. Phase times of engines running concurrently are summed.
+class ClusteringStats {
+
+public:
+    size_t m_sifts = 0;
+    size_t m_map_lookups = 0;
+    size_t m_merges = 0;
+    size_t m_rows = 0;
+    size_t m_row_size_total = 0;
+    size_t m_max_row_size = 0;
+    size_t m_stale_pops = 0;
+    size_t m_compactions = 0;
+    std::array<uint64_t, CLUSTERING_PHASE_COUNT> m_phase_nanoseconds {};
+
+    double phase_seconds(ClusteringPhase phase) const
+    {
+
+        return m_phase_nanoseconds[size_t(phase)] * 1e-9;
+    }
+
+    double mean_row_size() const
+    {
+
+        return m_rows > 0 ? double(m_row_size_total) / m_rows : 0.0;
+    }
+
+    std::string describe() const
+    {
+
+        std::string phases;
+
+        for (size_t i = 0; i < CLUSTERING_PHASE_COUNT; i++) {
+
+            if (m_phase_nanoseconds[i] > 0) {
+
+                phases += ", " + phase_name(ClusteringPhase(i)) + " " + std::to_string(phase_seconds(ClusteringPhase(i))) + "s";
+            }
+        }
+
+        return "ClusteringStats(" + std::to_string(m_sifts) + " sifts, " + std::to_string(m_map_lookups) + " map lookups, "
+            + std::to_string(m_merges) + " merges, " + std::to_string(m_rows) + " rows of mean size " + std::to_string(mean_row_size())
+            + " and max size " + std::to_string(m_max_row_size) + ", " + std::to_string(m_stale_pops) + " stale pops, "
+            + std::to_string(m_compactions) + " compactions" + phases + ")";
+    }
+};
+
+class NoPhaseTimer {
+};
+
+// Default policy: every hook is an empty inline function and the timer is an empty object
+class NoInstrumentation {
+
+public:
+    static constexpr bool enabled = false;
+
+    void count_sift() const { }
+    void count_map_lookup() const { }
+    void count_merge() const { }
+    void count_stale_pop() const { }
+    void count_compaction() const { }
+    void record_row_size(size_t) const { }
+
+    NoPhaseTimer time_phase(ClusteringPhase) const
+    {
+
+        return NoPhaseTimer();
+    }
+};
+
+class PhaseTimer {
+
+public:
+    explicit PhaseTimer(uint64_t& nanoseconds)
+        : m_nanoseconds(nanoseconds)
+        , m_start(std::chrono::steady_clock::now())
+    {
+    }
+
+    PhaseTimer(const PhaseTimer&) = delete;
+    PhaseTimer& operator=(const PhaseTimer&) = delete;
+
+    ~PhaseTimer()
+    {
+
+        auto elapsed = std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - m_start).count();
+        std::atomic_ref<uint64_t>(m_nanoseconds).fetch_add(elapsed, std::memory_order_relaxed);
+    }
+
+private:
+    uint64_t& m_nanoseconds;
+    std::chrono::steady_clock::time_point m_start;
+};
+
+// Counts into a shared ClusteringStats with relaxed atomic updates, so it can be used by parallel engines
+class StatsInstrumentation {
+
+public:
+    static constexpr bool enabled = true;
+
+    ClusteringStats* m_stats;
+
+    explicit StatsInstrumentation(ClusteringStats& stats)
+        : m_stats(&stats)
+    {
+    }
+
+    void count_sift() const
+    {
+
+        std::atomic_ref<size_t>(m_stats->m_sifts).fetch_add(1, std::memory_order_relaxed);
+    }
+
+    void count_map_lookup() const
+    {
+
+        std::atomic_ref<size_t>(m_stats->m_map_lookups).fetch_add(1, std::memory_order_relaxed);
+    }
+
+    void count_merge() const
+    {
+
+        std::atomic_ref<size_t>(m_stats->m_merges).fetch_add(1, std::memory_order_relaxed);
+    }
+
+    void count_stale_pop() const
+    {
+
+        std::atomic_ref<size_t>(m_stats->m_stale_pops).fetch_add(1, std::memory_order_relaxed);
+    }
+
+    void count_compaction() const
+    {
+
+        std::atomic_ref<size_t>(m_stats->m_compactions).fetch_add(1, std::memory_order_relaxed);
+    }
+
+    void record_row_size(size_t size) const
+    {
+
+        std::atomic_ref<size_t>(m_stats->m_rows).fetch_add(1, std::memory_order_relaxed);
+        std::atomic_ref<size_t>(m_stats->m_row_size_total).fetch_add(size, std::memory_order_relaxed);
+
+        std::atomic_ref<size_t> max_row_size(m_stats->m_max_row_size);
+        size_t current = max_row_size.load(std::memory_order_relaxed);
+
+        while (current < size && !max_row_size.compare_exchange_weak(current, size, std::memory_order_relaxed)) {
+        }
+    }
+
+    PhaseTimer time_phase(ClusteringPhase phase) const
+    {
+
+        return PhaseTimer(m_stats->m_phase_nanoseconds[size_t(phase)]);
+    }
+};
+}
+
+#endif
@@ -0,0 +1,310 @@
+#ifndef LAZY_DECAYING_MAX_HEAP_HPP_
+#define LAZY_DECAYING_MAX_HEAP_HPP_
+
+#include <algorithm>
+#include <cstdint>
+#include <stdexcept>
+#include <string>
+#include <tuple>
+#include <utility>
+#include <vector>
+
+#include <ginv/clustering/instrumentation.hpp>
+
+namespace clustering {
+
+// Max heap holding at most one live element per row, as the CNM merge heap does with the top of every row.
+// Pushing to a row or removing it only bumps the row version; outdated elements are skipped when they
+// reach the top and dropped in bulk when they outnumber live ones, so no position map is kept.
+template <
+    typename TInstrumentation,
+    typename TValue,
+    typename TRow,
+    typename TKey>
+class LazyDecayingMaxHeap {
+    typedef std::tuple<TRow, TKey> TKeysTuple;
+    typedef std::tuple<TRow, TKey, TValue> TKeysValueTuple;
+
+public:
+    class Element {
+
+    public:
+        TValue m_value;
+        uint32_t m_version;
+        TRow m_row;
+        TKey m_key;
+    };
+
+    static constexpr size_t MIN_COMPACTION_SIZE = 1024;
+
+    std::vector<Element> m_heap;
+    std::vector<uint32_t> m_row_versions;
+    std::vector<TKey> m_row_keys;
+    std::vector<TValue> m_row_values;
+    std::vector<uint8_t> m_row_live;
+    size_t m_live_count = 0;
+    [[no_unique_address]] TInstrumentation m_instrumentation;
+
+    explicit LazyDecayingMaxHeap(size_t size, TInstrumentation instrumentation = TInstrumentation())
+        : m_instrumentation(instrumentation)
+    {
+
+        m_heap.reserve(size);
+    }
+
+    explicit LazyDecayingMaxHeap(std::vector<TRow> rows, std::vector<TKey> keys, std::vector<TValue> values, TInstrumentation instrumentation = TInstrumentation())
+        : m_instrumentation(instrumentation)
+    {
+
+        m_heap.reserve(rows.size());
+
+        for (size_t i = 0; i < rows.size(); i++) {
+
+            uint32_t version = set_row(rows[i], keys[i], values[i]);
+            m_heap.push_back(Element { values[i], version, rows[i], keys[i] });
+        }
+
+        compact();
+    }
+
+    void push(TRow row, TKey key, TValue value)
+    {
+
+        uint32_t version = set_row(row, key, value);
+
+        m_heap.push_back(Element { value, version, row, key });
+        siftdown(m_heap.size() - 1);
+
+        compact_if_needed();
+    }
+
+    void push(TKeysValueTuple keys_value_tuple)
+    {
+
+        std::apply([&](auto&... key_values) { push(key_values...); },
+            keys_value_tuple);
+    }
+
+    TKeysTuple top_key()
+    {
+
+        discard_stale_top();
+        return std::make_tuple(m_heap[0].m_row, m_heap[0].m_key);
+    }
+
+    TValue top_value()
+    {
+
+        discard_stale_top();
+        return m_heap[0].m_value;
+    }
+
+    TKeysValueTuple top()
+    {
+
+        discard_stale_top();
+        return std::make_tuple(m_heap[0].m_row, m_heap[0].m_key, m_heap[0].m_value);
+    }
+
+    TKeysValueTuple pop()
+    {
+
+        discard_stale_top();
+
+        Element element = m_heap[0];
+
+        remove_top();
+        clear_row(element.m_row);
+
+        return std::make_tuple(element.m_row, element.m_key, element.m_value);
+    }
+
+    TValue remove(TRow row, TKey key)
+    {
+
+        if (size_t(row) >= m_row_live.size() || !m_row_live[row] || m_row_keys[row] != key) {
+
+            throw std::out_of_range("LazyDecayingMaxHeap has no live element for the row and key");
+        }
+
+        TValue value = m_row_values[row];
+
+        clear_row(row);
+        compact_if_needed();
+
+        return value;
+    }
+
+    TValue remove(TKeysTuple keys)
+    {
+
+        return remove(std::get<0>(keys), std::get<1>(keys));
+    }
+
+    size_t size()
+    {
+
+        return m_live_count;
+    }
+
+    size_t stored_size() const
+    {
+
+        return m_heap.size();
+    }
+
+    std::string describe() const
+    {
+
+        return "LazyDecayingMaxHeap(" + std::to_string(m_live_count) + " live of " + std::to_string(m_heap.size()) + " heap elements)";
+    }
+
+    // private:
+    uint32_t set_row(TRow row, TKey key, TValue value)
+    {
+
+        if (size_t(row) >= m_row_live.size()) {
+
+            size_t size = std::max(size_t(row) + 1, m_row_live.size() * 2);
+
+            m_row_versions.resize(size, 0);
+            m_row_keys.resize(size);
+            m_row_values.resize(size);
+            m_row_live.resize(size, 0);
+        }
+
+        if (!m_row_live[row]) {
+
+            m_live_count++;
+        }
+
+        m_row_live[row] = 1;
+        m_row_keys[row] = key;
+        m_row_values[row] = value;
+
+        return ++m_row_versions[row];
+    }
+
+    void clear_row(TRow row)
+    {
+
+        m_row_live[row] = 0;
+        m_row_versions[row]++;
+        m_live_count--;
+    }
+
+    bool is_stale(const Element& element) const
+    {
+
+        return element.m_version != m_row_versions[element.m_row];
+    }
+
+    void discard_stale_top()
+    {
+
+        while (m_heap.size() > 0 && is_stale(m_heap[0])) {
+
+            m_instrumentation.count_stale_pop();
+            remove_top();
+        }
+    }
+
+    void remove_top()
+    {
+
+        m_heap[0] = m_heap.back();
+        m_heap.pop_back();
+
+        if (m_heap.size() > 0) {
+
+            siftup(0);
+        }
+    }
+
+    void compact_if_needed()
+    {
+
+        size_t stale_count = m_heap.size() - m_live_count;
+
+        if (stale_count > MIN_COMPACTION_SIZE && stale_count > m_live_count) {
+
+            compact();
+        }
+    }
+
+    // Drops stale elements and rebuilds the heap in O(n); as with the bulk heapify of DecayingMaxHeap, the order among equal values is unspecified
+    void compact()
+    {
+
+        m_instrumentation.count_compaction();
+
+        size_t live = 0;
+
+        for (size_t i = 0; i < m_heap.size(); i++) {
+
+            if (!is_stale(m_heap[i])) {
+
+                m_heap[live++] = m_heap[i];
+            }
+        }
+
+        m_heap.resize(live);
+
+        for (size_t position = m_heap.size() / 2; position-- > 0;) {
+
+            siftup(position);
+        }
+    }
+
+    void siftdown(size_t position)
+    {
+
+        Element element = m_heap[position];
+
+        while (position > 0) {
+
+            size_t parent = (position - 1) >> 1;
+
+            if (!(element.m_value > m_heap[parent].m_value)) {
+                break;
+            }
+
+            m_instrumentation.count_sift();
+            m_heap[position] = m_heap[parent];
+            position = parent;
+        }
+
+        m_heap[position] = element;
+    }
+
+    void siftup(size_t position)
+    {
+
+        size_t end = m_heap.size();
+        Element element = m_heap[position];
+        size_t child_position = 2 * position + 1;
+
+        while (child_position < end) {
+
+            size_t right_child_position = child_position + 1;
+
+            if ((right_child_position < end) && (m_heap[right_child_position].m_value > m_heap[child_position].m_value)) {
+                child_position = right_child_position;
+            }
+
+            if (!(m_heap[child_position].m_value > element.m_value)) {
+                break;
+            }
+
+            m_instrumentation.count_sift();
+            m_heap[position] = m_heap[child_position];
+            position = child_position;
+            child_position = 2 * position + 1;
+        }
+
+        m_heap[position] = element;
+    }
+};
+}
+
+#endif
@@ -0,0 +1,242 @@
+#ifndef MODULARITY_ADJACENCY_HPP_
+#define MODULARITY_ADJACENCY_HPP_
+
+#include <algorithm>
+#include <span>
+#include <string>
+#include <tuple>
+#include <utility>
+#include <vector>
+
+#include <ginv/clustering/run_control.hpp>
+#include <ginv/parallel/parallel_for.hpp>
+
+namespace clustering {
+
+template <typename T>
+using OwnedAdjacencyColumn = std::vector<T>;
+
+template <typename T>
+using AdjacencyColumnView = std::span<const T>;
+
+// The resolution-independent input of a greedy modularity run: symmetric rows of summed connection weights
+// without self connections, sorted by neighbour, with the normalized degrees `a` and 1/m.
+// Runs only read it, so one adjacency can be shared by concurrent runs at different resolutions,
+// or by processes as a view of columns they do not own.
+template <typename TQ, typename TId, template <typename> typename TColumn = OwnedAdjacencyColumn>
+class BasicModularityAdjacency {
+
+public:
+    TColumn<TQ> m_a;
+    TQ m_reverse_m;
+    TColumn<size_t> m_offsets;
+    TColumn<TId> m_neighbours;
+    TColumn<TQ> m_weights;
+
+    explicit BasicModularityAdjacency(TColumn<TQ> a, TQ reverse_m, TColumn<size_t> offsets, TColumn<TId> neighbours, TColumn<TQ> weights)
+        : m_a(std::move(a))
+        , m_reverse_m(reverse_m)
+        , m_offsets(std::move(offsets))
+        , m_neighbours(std::move(neighbours))
+        , m_weights(std::move(weights))
+    {
+    }
+
+    size_t node_count() const
+    {
+
+        return m_offsets.size() - 1;
+    }
+
+    std::span<const TId> neighbours(size_t node) const
+    {
+
+        return std::span<const TId>(m_neighbours.data() + m_offsets[node], m_offsets[node + 1] - m_offsets[node]);
+    }
+
+    std::span<const TQ> weights(size_t node) const
+    {
+
+        return std::span<const TQ>(m_weights.data() + m_offsets[node], m_offsets[node + 1] - m_offsets[node]);
+    }
+
+    std::string describe() const
+    {
+
+        return "ModularityAdjacency(" + std::to_string(m_neighbours.size()) + " entries of " + std::to_string(node_count()) + " nodes)";
+    }
+};
+
+template <typename TQ, typename TId>
+using ModularityAdjacency = BasicModularityAdjacency<TQ, TId, OwnedAdjacencyColumn>;
+
+template <typename TQ, typename TId>
+using ModularityAdjacencyView = BasicModularityAdjacency<TQ, TId, AdjacencyColumnView>;
+
+// Weights of parallel connections are summed in connection order, as the delta Q maps of a run always did.
+// When the run control asks to stop, the build returns early with an incomplete adjacency that the run discards.
+template <typename TQ, typename TId, typename TConnectionWeight>
+ModularityAdjacency<TQ, TId> create_modularity_adjacency(
+    size_t node_count,
+    std::span<const TId> from_ids,
+    std::span<const TId> to_ids,
+    std::span<const TConnectionWeight> values,
+    std::vector<TQ> a,
+    TQ reverse_m,
+    size_t thread_count = 0,
+    const RunControl<TQ>* run_control = nullptr)
+{
+
+    StopPoll<TQ> poll(run_control);
+    std::vector<size_t> offsets(node_count + 1, 0);
+
+    auto stopped = [&]() {
+        return ModularityAdjacency<TQ, TId>(std::move(a), reverse_m, std::vector<size_t>(node_count + 1, 0), std::vector<TId>(), std::vector<TQ>());
+    };
+
+    for (size_t i = 0; i < from_ids.size(); i++) {
+
+        if (poll.should_stop(i)) {
+
+            return stopped();
+        }
+
+        if (from_ids[i] != to_ids[i]) {
+
+            offsets[from_ids[i] + 1]++;
+            offsets[to_ids[i] + 1]++;
+        }
+    }
+
+    for (size_t i = 0; i < node_count; i++) {
+
+        offsets[i + 1] += offsets[i];
+    }
+
+    std::vector<std::tuple<TId, TQ>> entries(offsets.back());
+    std::vector<size_t> cursors(offsets.begin(), offsets.end() - 1);
+
+    for (size_t i = 0; i < from_ids.size(); i++) {
+
+        if (poll.should_stop(i)) {
+
+            return stopped();
+        }
+
+        TId from = from_ids[i];
+        TId to = to_ids[i];
+
+        if (from != to) {
+
+            entries[cursors[from]++] = std::make_tuple(to, TQ(values[i]));
+            entries[cursors[to]++] = std::make_tuple(from, TQ(values[i]));
+        }
+    }
+
+    // Every row is sorted and summed in place; cursors then hold the end of the summed part
+    parallel::parallel_for(
+        0, node_count,
+        [&](size_t i) {
+            if (poll.should_stop(i)) {
+
+                return;
+            }
+
+            auto begin = entries.begin() + offsets[i];
+            auto end = entries.begin() + offsets[i + 1];
+
+            std::stable_sort(begin, end, [](auto& left, auto& right) { return std::get<0>(left) < std::get<0>(right); });
+
+            auto last = begin;
+
+            for (auto entry = begin; entry != end; entry++) {
+
+                if (entry != begin && std::get<0>(*entry) == std::get<0>(*(last - 1))) {
+
+                    std::get<1>(*(last - 1)) += std::get<1>(*entry);
+                } else {
+
+                    *last++ = *entry;
+                }
+            }
+
+            cursors[i] = offsets[i] + (last - begin);
+        },
+        thread_count, 1024);
+
+    if (poll.is_stopped()) {
+
+        return stopped();
+    }
+
+    std::vector<size_t> summed_offsets(node_count + 1, 0);
+
+    for (size_t i = 0; i < node_count; i++) {
+
+        summed_offsets[i + 1] = summed_offsets[i] + (cursors[i] - offsets[i]);
+    }
+
+    std::vector<TId> neighbours(summed_offsets.back());
+    std::vector<TQ> weights(summed_offsets.back());
+
+    parallel::parallel_for(
+        0, node_count,
+        [&](size_t i) {
+            for (size_t q = 0; q < summed_offsets[i + 1] - summed_offsets[i]; q++) {
+
+                std::tie(neighbours[summed_offsets[i] + q], weights[summed_offsets[i] + q]) = entries[offsets[i] + q];
+            }
+        },
+        thread_count, 1024);
+
+    return ModularityAdjacency<TQ, TId>(std::move(a), reverse_m, std::move(summed_offsets), std::move(neighbours), std::move(weights));
+}
+
+// Modularity of a partition at the given resolution: the sum over communities of the inner connection
+// weight divided by m minus resolution times the squared sum of their normalized degrees
+template <typename TQ, typename TId, template <typename> typename TColumn>
+double modularity(const BasicModularityAdjacency<TQ, TId, TColumn>& adjacency, const std::vector<std::vector<TId>>& communities, TQ resolution = 1.0f)
+{
+
+    std::vector<size_t> labels(adjacency.node_count(), communities.size());
+
+    for (size_t c = 0; c < communities.size(); c++) {
+
+        for (TId node : communities[c]) {
+
+            labels[node] = c;
+        }
+    }
+
+    double result = 0;
+
+    for (size_t c = 0; c < communities.size(); c++) {
+
+        double inner_weight = 0;
+        double degree = 0;
+
+        for (TId node : communities[c]) {
+
+            auto neighbours = adjacency.neighbours(node);
+            auto weights = adjacency.weights(node);
+
+            for (size_t q = 0; q < neighbours.size(); q++) {
+
+                if (labels[neighbours[q]] == c) {
+
+                    inner_weight += weights[q];
+                }
+            }
+
+            degree += adjacency.m_a[node];
+        }
+
+        // Rows hold every connection from both ends
+        result += (inner_weight > 0 ? inner_weight / 2 * double(adjacency.m_reverse_m) : 0.0) - double(resolution) * degree * degree;
+    }
+
+    return result;
+}
+}
+
+#endif
@@ -0,0 +1,98 @@
+#ifndef RESOLUTION_SWEEP_HPP_
+#define RESOLUTION_SWEEP_HPP_
+
+#include <future>
+#include <span>
+#include <string>
+#include <vector>
+
+#include <ginv/clustering/clauset_newman_moore.hpp>
+#include <ginv/clustering/modularity_adjacency.hpp>
+#include <ginv/clustering/run_control.hpp>
+#include <ginv/parallel/thread_pool.hpp>
+#include <osigma/ograph.hpp>
+
+namespace clustering {
+
+template <typename TQ, typename TId>
+class ResolutionSweepResult {
+
+public:
+    TQ m_resolution;
+    std::vector<std::vector<TId>> m_communities;
+    // Modularity of the partition at its own resolution and at resolution 1
+    double m_modularity;
+    double m_standard_modularity;
+    size_t m_steps;
+    StopReason m_stop_reason;
+
+    std::string describe() const
+    {
+
+        return "ResolutionSweepResult(resolution " + std::to_string(m_resolution) + ", " + std::to_string(m_communities.size())
+            + " communities, modularity " + std::to_string(m_modularity) + ", standard modularity " + std::to_string(m_standard_modularity)
+            + ", " + stop_reason_name(m_stop_reason) + ")";
+    }
+};
+
+// Clusters the graph once per resolution. The degrees and the summed adjacency are built once and shared
+// read-only; every resolution then builds only its own delta Q maps and heaps and runs as one task of a pool.
+// Results keep the order of `resolutions`, so longer runs should come first for a tighter schedule.
+template <
+    typename TQ,
+    typename TMergeHeap = ExactMergeHeap,
+    template <typename> typename TAllocator,
+    typename TId,
+    typename TConnectionWeight,
+    typename TCoordinates,
+    typename TZIndex,
+    typename... TNodeFeatures>
+std::vector<ResolutionSweepResult<TQ, TId>> resolution_sweep(
+    const ograph::BasicOGraph<TAllocator, TId, TConnectionWeight, TCoordinates, TZIndex, TNodeFeatures...>& graph,
+    const std::vector<TQ>& resolutions,
+    size_t cutoff = 1,
+    size_t thread_count = 0)
+{
+
+    std::span<const TId> from_ids(graph.m_connections.m_from);
+    std::span<const TId> to_ids(graph.m_connections.m_to);
+    std::span<const TConnectionWeight> values(graph.m_connections.m_values);
+
+    auto [a, reverse_m] = create_normal_weighted_degrees<TQ>(graph.node_count(), from_ids, to_ids, values);
+    const auto adjacency = create_modularity_adjacency<TQ, TId, TConnectionWeight>(
+        graph.node_count(), from_ids, to_ids, values, std::move(a), reverse_m, thread_count);
+
+    std::vector<ResolutionSweepResult<TQ, TId>> results(resolutions.size());
+
+    {
+        parallel::ThreadPool pool(std::min(parallel::resolve_thread_count(thread_count), std::max<size_t>(resolutions.size(), 1)));
+        std::vector<std::future<void>> futures;
+        futures.reserve(resolutions.size());
+
+        for (size_t r = 0; r < resolutions.size(); r++) {
+
+            futures.push_back(pool.submit([&, r]() {
+                RunControl<TQ> run_control;
+                auto& result = results[r];
+
+                result.m_resolution = resolutions[r];
+                result.m_communities = greedy_modularity_communities<TQ, TId, NoInstrumentation, TMergeHeap>(
+                    adjacency, resolutions[r], cutoff, false, TQ(-2605), 1, NoInstrumentation(), &run_control);
+                result.m_modularity = modularity(adjacency, result.m_communities, resolutions[r]);
+                result.m_standard_modularity = modularity(adjacency, result.m_communities, TQ(1));
+                result.m_steps = run_control.m_steps;
+                result.m_stop_reason = run_control.m_stop_reason;
+            }));
+        }
+
+        for (auto& future : futures) {
+
+            future.get();
+        }
+    }
+
+    return results;
+}
+}
+
+#endif
@@ -0,0 +1,215 @@
+#ifndef CLUSTERING_RUN_CONTROL_HPP_
+#define CLUSTERING_RUN_CONTROL_HPP_
+
+#include <atomic>
+#include <chrono>
+#include <functional>
+#include <limits>
+#include <memory>
+#include <string>
+
+namespace clustering {
+
+// Shared flag that can be cancelled from any thread while a run polls it
+class CancellationToken {
+
+public:
+    explicit CancellationToken()
+        : m_cancelled(std::make_shared<std::atomic<bool>>(false))
+    {
+    }
+
+    void cancel() const
+    {
+
+        m_cancelled->store(true, std::memory_order_release);
+    }
+
+    bool is_cancelled() const
+    {
+
+        return m_cancelled->load(std::memory_order_acquire);
+    }
+
+private:
+    std::shared_ptr<std::atomic<bool>> m_cancelled;
+};
+
+enum class StopReason {
+    NotStarted,
+    Converged,
+    Cutoff,
+    Cancelled,
+    StepBudget,
+    TimeBudget,
+};
+
+inline std::string stop_reason_name(StopReason reason)
+{
+
+    switch (reason) {
+    case StopReason::NotStarted:
+        return "not_started";
+    case StopReason::Converged:
+        return "converged";
+    case StopReason::Cutoff:
+        return "cutoff";
+    case StopReason::Cancelled:
+        return "cancelled";
+    case StopReason::StepBudget:
+        return "step_budget";
+    case StopReason::TimeBudget:
+        return "time_budget";
+    }
+
+    return "unknown";
+}
+
+// Observes and bounds a greedy modularity run. Greedy merges never decrease modularity,
+// so the partition returned when a budget or cancellation stops the run is the best one found so far.
+// The m_steps, m_modularity, m_community_count and m_stop_reason members are filled by the run.
+template <typename TQ>
+class RunControl {
+
+public:
+    typedef std::function<void(size_t step, TQ modularity, size_t community_count)> ProgressCallback;
+    typedef std::chrono::steady_clock Clock;
+
+    ProgressCallback m_progress;
+    size_t m_progress_interval = 1;
+    CancellationToken m_cancellation;
+    size_t m_max_steps = std::numeric_limits<size_t>::max();
+    Clock::time_point m_deadline = Clock::time_point::max();
+
+    size_t m_steps = 0;
+    TQ m_modularity = 0;
+    size_t m_community_count = 0;
+    StopReason m_stop_reason = StopReason::NotStarted;
+
+    explicit RunControl(ProgressCallback progress = ProgressCallback(), size_t progress_interval = 1)
+        : m_progress(std::move(progress))
+        , m_progress_interval(progress_interval)
+    {
+    }
+
+    RunControl& with_step_budget(size_t max_steps)
+    {
+
+        m_max_steps = max_steps;
+        return *this;
+    }
+
+    RunControl& with_time_budget(Clock::duration budget)
+    {
+
+        m_deadline = Clock::now() + budget;
+        return *this;
+    }
+
+    RunControl& with_deadline(Clock::time_point deadline)
+    {
+
+        m_deadline = deadline;
+        return *this;
+    }
+
+    RunControl& with_cancellation(CancellationToken cancellation)
+    {
+
+        m_cancellation = std::move(cancellation);
+        return *this;
+    }
+
+    // Returns the reason to stop before the next step, or NotStarted to continue
+    StopReason check(size_t step) const
+    {
+
+        if (m_cancellation.is_cancelled()) {
+
+            return StopReason::Cancelled;
+        }
+
+        if (step >= m_max_steps) {
+
+            return StopReason::StepBudget;
+        }
+
+        if (m_deadline != Clock::time_point::max() && Clock::now() >= m_deadline) {
+
+            return StopReason::TimeBudget;
+        }
+
+        return StopReason::NotStarted;
+    }
+
+    void report(size_t step, TQ modularity, size_t community_count)
+    {
+
+        m_steps = step;
+        m_modularity = modularity;
+        m_community_count = community_count;
+
+        if (m_progress && m_progress_interval > 0 && step % m_progress_interval == 0) {
+
+            m_progress(step, modularity, community_count);
+        }
+    }
+
+    std::string describe() const
+    {
+
+        return "RunControl(" + std::to_string(m_steps) + " steps, modularity " + std::to_string(m_modularity) + ", "
+            + std::to_string(m_community_count) + " communities, stopped by " + stop_reason_name(m_stop_reason) + ")";
+    }
+};
+
+// Polls a run control from the loops of the phases before the first merge, every `interval` iterations.
+// Parallel loops share one poll; once it has seen a reason to stop, every later poll stops too.
+template <typename TQ>
+class StopPoll {
+
+public:
+    explicit StopPoll(const RunControl<TQ>* run_control, size_t interval = 4096)
+        : m_run_control(run_control)
+        , m_interval(interval)
+    {
+    }
+
+    bool should_stop(size_t iteration)
+    {
+
+        if (m_run_control != nullptr && iteration % m_interval == 0) {
+
+            StopReason reason = m_run_control->check(0);
+            StopReason not_started = StopReason::NotStarted;
+
+            if (reason != StopReason::NotStarted) {
+
+                m_reason.compare_exchange_strong(not_started, reason, std::memory_order_relaxed);
+            }
+        }
+
+        return is_stopped();
+    }
+
+    bool is_stopped() const
+    {
+
+        return reason() != StopReason::NotStarted;
+    }
+
+    // The first reason to stop that a poll has seen, NotStarted while none has
+    StopReason reason() const
+    {
+
+        return m_reason.load(std::memory_order_relaxed);
+    }
+
+private:
+    const RunControl<TQ>* m_run_control;
+    size_t m_interval;
+    std::atomic<StopReason> m_reason = StopReason::NotStarted;
+};
+}
+
+#endif
@@ -0,0 +1,139 @@
+#ifndef SHARED_CLUSTERING_HPP_
+#define SHARED_CLUSTERING_HPP_
+
+#include <cstdint>
+#include <span>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include <ginv/clustering/clauset_newman_moore.hpp>
+#include <ginv/clustering/modularity_adjacency.hpp>
+#include <ginv/clustering/run_control.hpp>
+#include <osigma/shared_memory_graph.hpp>
+
+namespace clustering {
+
+// Publishes a graph with ograph::publish_graph together with its modularity adjacency:
+// the normalized degrees as a, 1/m as reverse_m and the rows as adjacency_offsets, adjacency_neighbours and adjacency_weights.
+template <
+    typename TQ = float,
+    template <typename> typename TAllocator,
+    typename TId,
+    typename TConnectionWeight,
+    typename TCoordinates,
+    typename TZIndex,
+    typename... TNodeFeatures>
+ograph::SharedMemorySegment publish_clustering_graph(
+    const std::string& segment_name,
+    const ograph::BasicOGraph<TAllocator, TId, TConnectionWeight, TCoordinates, TZIndex, TNodeFeatures...>& graph,
+    size_t thread_count = 0)
+{
+
+    std::span<const TId> from_ids(graph.m_connections.m_from.data(), graph.m_connections.m_from.size());
+    std::span<const TId> to_ids(graph.m_connections.m_to.data(), graph.m_connections.m_to.size());
+    std::span<const TConnectionWeight> values(graph.m_connections.m_values.data(), graph.m_connections.m_values.size());
+
+    auto [a, reverse_m] = create_normal_weighted_degrees<TQ>(graph.node_count(), from_ids, to_ids, values);
+    const auto adjacency = create_modularity_adjacency<TQ, TId, TConnectionWeight>(
+        graph.node_count(), from_ids, to_ids, values, std::move(a), reverse_m, thread_count);
+    std::vector<TQ> reverse_m_column(1, adjacency.m_reverse_m);
+
+    ograph::SharedGraphBuilder builder;
+    builder.add_column("a", adjacency.m_a);
+    builder.add_column("reverse_m", reverse_m_column);
+    builder.add_column("adjacency_offsets", adjacency.m_offsets);
+    builder.add_column("adjacency_neighbours", adjacency.m_neighbours);
+    builder.add_column("adjacency_weights", adjacency.m_weights);
+
+    return ograph::publish_graph(segment_name, graph, true, builder);
+}
+
+// Checks an adjacency read from a segment before any of its offsets or neighbours is used as an index
+template <typename TQ, typename TId>
+void validate_shared_adjacency(const ModularityAdjacencyView<TQ, TId>& adjacency, size_t node_count, const std::string& segment_name)
+{
+
+    size_t entry_count = adjacency.m_neighbours.size();
+
+    if (adjacency.m_a.size() != node_count || adjacency.m_offsets.size() != node_count + 1 || adjacency.m_weights.size() != entry_count
+        || adjacency.m_offsets[0] != 0 || adjacency.m_offsets[node_count] > entry_count) {
+
+        throw std::runtime_error(segment_name + " holds an inconsistent modularity adjacency");
+    }
+
+    for (size_t i = 0; i < node_count; i++) {
+
+        if (adjacency.m_offsets[i + 1] < adjacency.m_offsets[i]) {
+
+            throw std::runtime_error(segment_name + " holds decreasing adjacency offsets at node " + std::to_string(i));
+        }
+    }
+
+    for (TId neighbour : adjacency.m_neighbours) {
+
+        if (uint64_t(neighbour) >= node_count) {
+
+            throw std::runtime_error(segment_name + " holds adjacency neighbour " + std::to_string(neighbour) + " out of the node range");
+        }
+    }
+}
+
+// Clusters a graph published with publish_clustering_graph over views of its adjacency columns,
+// so a worker only allocates its own merge state. Segments without them are clustered from the connection columns.
+template <
+    typename TQ,
+    typename TId,
+    typename TConnectionWeight,
+    typename TMergeHeap = ExactMergeHeap>
+std::vector<std::vector<TId>> greedy_modularity_communities(
+    const ograph::SharedGraphView& view,
+    TQ resolution = 1.0f,
+    size_t cutoff = 1,
+    size_t thread_count = 0,
+    RunControl<TQ>* run_control = nullptr)
+{
+
+    size_t node_count = view.node_count();
+
+    if (view.has_column("adjacency_offsets")) {
+
+        std::span<const TQ> reverse_m = view.column<TQ>("reverse_m");
+
+        if (reverse_m.empty()) {
+
+            throw std::runtime_error(view.segment().name() + " has an empty reverse_m column");
+        }
+
+        ModularityAdjacencyView<TQ, TId> adjacency(
+            view.column<TQ>("a"), reverse_m[0], view.column<size_t>("adjacency_offsets"),
+            view.column<TId>("adjacency_neighbours"), view.column<TQ>("adjacency_weights"));
+
+        validate_shared_adjacency(adjacency, node_count, view.segment().name());
+
+        if (run_control != nullptr) {
+
+            StopReason stop_reason = run_control->check(0);
+
+            if (stop_reason != StopReason::NotStarted) {
+
+                return stop_before_merges<TQ, TId>(std::vector<TQ>(adjacency.m_a.begin(), adjacency.m_a.end()), resolution, stop_reason, run_control);
+            }
+        }
+
+        return greedy_modularity_communities<TQ, TId, NoInstrumentation, TMergeHeap>(
+            adjacency, resolution, cutoff, false, TQ(-2605), thread_count, NoInstrumentation(), run_control);
+    }
+
+    std::span<const TId> from_ids = view.column<TId>("from");
+    std::span<const TId> to_ids = view.column<TId>("to");
+    std::span<const TConnectionWeight> values = view.column<TConnectionWeight>("values");
+    auto [a, reverse_m] = create_normal_weighted_degrees<TQ>(node_count, from_ids, to_ids, values);
+
+    return greedy_modularity_communities<TQ, TId, TConnectionWeight, NoInstrumentation, TMergeHeap>(
+        node_count, from_ids, to_ids, values, std::move(a), reverse_m,
+        resolution, cutoff, false, TQ(-2605), thread_count, NoInstrumentation(), run_control);
+}
+}
+
+#endif
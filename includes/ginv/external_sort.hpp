@@ -0,0 +1,663 @@
+#ifndef EXTERNAL_SORT_HPP_
+#define EXTERNAL_SORT_HPP_
+
+#include <algorithm>
+#include <cstdint>
+#include <filesystem>
+#include <fstream>
+#include <functional>
+#include <nlohmann/json.hpp>
+#include <queue>
+#include <stdexcept>
+#include <string>
+#include <system_error>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include <ginv/parallel/parallel_for.hpp>
+#include <ginv/parallel/parallel_sort.hpp>
+#include <ginv/schema_dataset.hpp>
+
+namespace dataset {
+
+// Reads a sharded column front to back in chunks, opening the shards one after another
+template <typename T>
+class ShardReader {
+
+public:
+    explicit ShardReader(std::string root, ColumnSchema schema)
+        : m_root(std::move(root))
+        , m_schema(std::move(schema))
+    {
+
+        if (!std::holds_alternative<std::vector<T>>(create_column_data(m_schema.m_type))) {
+
+            throw std::invalid_argument("Column " + m_schema.m_name + " holds " + m_schema.m_type + " elements");
+        }
+    }
+
+    // Returns the number of elements read, less than `count` only at the end of the last shard
+    size_t read(T* target, size_t count)
+    {
+
+        size_t read_count = 0;
+
+        while (read_count < count) {
+
+            if (m_remaining == 0 && !open_next_shard()) {
+
+                break;
+            }
+
+            size_t chunk = std::min(count - read_count, m_remaining);
+
+            if (!m_file.read((char*)(target + read_count), chunk * sizeof(T))) {
+
+                throw std::runtime_error("Cannot read " + shard_file_name(m_root, m_schema, m_shard - 1));
+            }
+
+            read_count += chunk;
+            m_remaining -= chunk;
+        }
+
+        return read_count;
+    }
+
+    std::string describe() const
+    {
+
+        return "ShardReader(" + m_schema.describe() + " at shard " + std::to_string(m_shard) + ")";
+    }
+
+private:
+    std::string m_root;
+    ColumnSchema m_schema;
+    size_t m_shard = 0;
+    size_t m_remaining = 0;
+    std::ifstream m_file;
+
+    bool open_next_shard()
+    {
+
+        while (m_shard < m_schema.m_shards) {
+
+            std::string file_name = shard_file_name(m_root, m_schema, m_shard++);
+
+            m_file = std::ifstream(file_name, std::ios::in | std::ios::binary | std::ios::ate);
+
+            if (!m_file) {
+
+                throw std::runtime_error("Cannot open " + file_name);
+            }
+
+            size_t file_size = m_file.tellg();
+
+            if (file_size % sizeof(T) != 0) {
+
+                throw std::runtime_error(file_name + " does not hold whole " + m_schema.m_type + " elements");
+            }
+
+            m_file.seekg(0, std::ios::beg);
+            m_remaining = file_size / sizeof(T);
+
+            if (m_remaining > 0) {
+
+                return true;
+            }
+        }
+
+        return false;
+    }
+};
+
+class ExternalSortSettings {
+
+public:
+    // Connections sorted in memory at once. Per connection a run holds the read ids and value, the key and sum,
+    // the radix sort buffers for both and the coalesced entry: 2 * sizeof(TId) + sizeof(TValue) + 2 * (8 + sizeof(TSumValue))
+    // + sizeof(SortRunEntry<TSumValue>) bytes, 57 with int32 ids, uint8 values and 64-bit sums
+    size_t m_run_size = size_t(1) << 24;
+    // Connections per output shard
+    size_t m_shard_size = size_t(1) << 26;
+    // Entries buffered per run while merging
+    size_t m_merge_buffer_size = size_t(1) << 16;
+    // Runs merged at once, which bounds the open files; more runs are first merged in passes into longer runs
+    size_t m_max_fan_in = 64;
+    // Orders the endpoints of every connection, so both directions of a pair are summed into one connection
+    bool m_undirected = false;
+    // Directory of the run files, the output directory when empty
+    std::string m_temporary_directory;
+    size_t m_thread_count = 0;
+
+    std::string describe() const
+    {
+
+        return "ExternalSortSettings(runs of " + std::to_string(m_run_size) + ", shards of " + std::to_string(m_shard_size)
+            + (m_undirected ? ", undirected" : "") + ")";
+    }
+};
+
+class ExternalSortResult {
+
+public:
+    size_t m_input_connections = 0;
+    size_t m_output_connections = 0;
+    size_t m_run_count = 0;
+    size_t m_merge_pass_count = 0;
+    size_t m_shard_count = 0;
+
+    std::string describe() const
+    {
+
+        return "ExternalSortResult(" + std::to_string(m_input_connections) + " connections to " + std::to_string(m_output_connections)
+            + " through " + std::to_string(m_run_count) + " runs in " + std::to_string(m_merge_pass_count) + " merge passes into "
+            + std::to_string(m_shard_count) + " shards)";
+    }
+};
+
+// Default type of summed connection values: 64 bits of the same kind as the values
+template <typename TValue>
+using connection_sum_t = std::conditional_t<std::is_floating_point_v<TValue>, double, std::conditional_t<std::is_signed_v<TValue>, int64_t, uint64_t>>;
+
+// Connection key that orders by (from, to), also for signed ids
+template <typename TId>
+uint64_t connection_sort_key(TId from, TId to)
+{
+
+    static_assert(sizeof(TId) <= 4, "Connection sort keys hold two ids of at most 32 bits");
+
+    typedef std::make_unsigned_t<TId> TUnsigned;
+    constexpr TUnsigned sign = std::is_signed_v<TId> ? TUnsigned(TUnsigned(1) << (8 * sizeof(TId) - 1)) : TUnsigned(0);
+
+    return (uint64_t(TUnsigned(TUnsigned(from) ^ sign)) << 32) | uint64_t(TUnsigned(TUnsigned(to) ^ sign));
+}
+
+template <typename TId>
+std::tuple<TId, TId> connection_of_sort_key(uint64_t key)
+{
+
+    typedef std::make_unsigned_t<TId> TUnsigned;
+    constexpr TUnsigned sign = std::is_signed_v<TId> ? TUnsigned(TUnsigned(1) << (8 * sizeof(TId) - 1)) : TUnsigned(0);
+
+    return std::make_tuple(TId(TUnsigned(TUnsigned(key >> 32) ^ sign)), TId(TUnsigned(TUnsigned(key) ^ sign)));
+}
+
+template <typename TValue>
+class SortRunEntry {
+
+public:
+    uint64_t m_key;
+    TValue m_value;
+};
+
+// Reads a sorted run file in buffered blocks
+template <typename TValue>
+class SortRunCursor {
+
+public:
+    explicit SortRunCursor(const std::string& file_name, size_t buffer_size)
+        : m_file(file_name, std::ios::in | std::ios::binary)
+        , m_buffer(std::max<size_t>(buffer_size, 1))
+    {
+
+        if (!m_file) {
+
+            throw std::runtime_error("Cannot open " + file_name);
+        }
+
+        advance();
+    }
+
+    bool is_done() const
+    {
+
+        return m_position == m_size;
+    }
+
+    const SortRunEntry<TValue>& current() const
+    {
+
+        return m_buffer[m_position];
+    }
+
+    void advance()
+    {
+
+        if (m_position + 1 < m_size) {
+
+            m_position++;
+            return;
+        }
+
+        m_file.read((char*)m_buffer.data(), m_buffer.size() * sizeof(SortRunEntry<TValue>));
+        m_size = size_t(m_file.gcount()) / sizeof(SortRunEntry<TValue>);
+        m_position = 0;
+    }
+
+private:
+    std::ifstream m_file;
+    std::vector<SortRunEntry<TValue>> m_buffer;
+    size_t m_position = 0;
+    size_t m_size = 0;
+};
+
+// Removes the run files it was given when the sort finishes or fails
+class SortRunFiles {
+
+public:
+    explicit SortRunFiles(std::string directory)
+        : m_directory(std::move(directory))
+    {
+    }
+
+    SortRunFiles(const SortRunFiles&) = delete;
+    SortRunFiles& operator=(const SortRunFiles&) = delete;
+
+    ~SortRunFiles()
+    {
+
+        for (auto& file_name : m_file_names) {
+
+            std::error_code error;
+            std::filesystem::remove(file_name, error);
+        }
+    }
+
+    std::string create()
+    {
+
+        m_file_names.push_back(m_directory + "/external_sort_run_" + std::to_string(m_file_names.size()) + ".bin");
+
+        return m_file_names.back();
+    }
+
+private:
+    std::string m_directory;
+    std::vector<std::string> m_file_names;
+};
+
+// Merges sorted run files and passes each key once, with the values of the key summed
+template <typename TValue, typename TConsumer>
+void merge_sort_runs(const std::vector<std::string>& file_names, size_t buffer_size, TConsumer&& consumer)
+{
+
+    std::vector<SortRunCursor<TValue>> cursors;
+    std::priority_queue<std::tuple<uint64_t, size_t>, std::vector<std::tuple<uint64_t, size_t>>, std::greater<>> heads;
+
+    cursors.reserve(file_names.size());
+
+    for (size_t run = 0; run < file_names.size(); run++) {
+
+        cursors.emplace_back(file_names[run], buffer_size);
+
+        if (!cursors.back().is_done()) {
+
+            heads.emplace(cursors.back().current().m_key, run);
+        }
+    }
+
+    bool has_connection = false;
+    uint64_t key = 0;
+    TValue value = TValue();
+
+    while (!heads.empty()) {
+
+        size_t run = std::get<1>(heads.top());
+        const SortRunEntry<TValue>& entry = cursors[run].current();
+
+        heads.pop();
+
+        if (has_connection && entry.m_key == key) {
+
+            value += entry.m_value;
+        } else {
+
+            if (has_connection) {
+
+                consumer(key, value);
+            }
+
+            has_connection = true;
+            key = entry.m_key;
+            value = entry.m_value;
+        }
+
+        cursors[run].advance();
+
+        if (!cursors[run].is_done()) {
+
+            heads.emplace(cursors[run].current().m_key, run);
+        }
+    }
+
+    if (has_connection) {
+
+        consumer(key, value);
+    }
+}
+
+// The file pattern of an output column; a pattern without `${FILE_ID}` gets it appended to its stem,
+// so the shards do not overwrite each other
+inline std::string sharded_file_pattern(const std::string& file)
+{
+
+    if (file.find("${FILE_ID}") != std::string::npos) {
+
+        return file;
+    }
+
+    std::filesystem::path path(file);
+
+    return (path.parent_path() / (path.stem().string() + "_${FILE_ID}" + path.extension().string())).string();
+}
+
+// Writes the from, to and value columns into shards of `shard_size` connections
+template <typename TId, typename TValue>
+class ConnectionShardWriter {
+
+public:
+    explicit ConnectionShardWriter(std::string root, std::vector<ColumnSchema> schemas, size_t shard_size)
+        : m_root(std::move(root))
+        , m_schemas(std::move(schemas))
+        , m_shard_size(std::max<size_t>(shard_size, 1))
+    {
+    }
+
+    void write(TId from, TId to, TValue value)
+    {
+
+        if (m_count % m_shard_size == 0) {
+
+            open_shard();
+        }
+
+        std::get<0>(m_files).write((const char*)&from, sizeof(TId));
+        std::get<1>(m_files).write((const char*)&to, sizeof(TId));
+        std::get<2>(m_files).write((const char*)&value, sizeof(TValue));
+        m_count++;
+    }
+
+    // Returns the number of shards; a dataset without connections gets one empty shard
+    size_t finish()
+    {
+
+        if (m_shard_count == 0) {
+
+            open_shard();
+        }
+
+        close_shard();
+
+        return m_shard_count;
+    }
+
+    size_t count() const
+    {
+
+        return m_count;
+    }
+
+private:
+    std::string m_root;
+    std::vector<ColumnSchema> m_schemas;
+    size_t m_shard_size;
+    size_t m_shard_count = 0;
+    size_t m_count = 0;
+    std::tuple<std::ofstream, std::ofstream, std::ofstream> m_files;
+
+    void open_shard()
+    {
+
+        close_shard();
+
+        std::apply(
+            [&](auto&... files) {
+                size_t column = 0;
+
+                ((files = std::ofstream(shard_file_name(m_root, m_schemas[column++], m_shard_count), std::ios::out | std::ios::binary)), ...);
+            },
+            m_files);
+
+        m_shard_count++;
+    }
+
+    void close_shard()
+    {
+
+        std::apply(
+            [&](auto&... files) {
+                size_t column = 0;
+
+                auto close = [&](std::ofstream& file) {
+                    if (file.is_open() && !file.flush()) {
+
+                        throw std::runtime_error("Cannot write " + shard_file_name(m_root, m_schemas[column], m_shard_count - 1));
+                    }
+
+                    file.close();
+                    column++;
+                };
+
+                (close(files), ...);
+            },
+            m_files);
+    }
+};
+
+// Sorts the "from", "to" and "value" connection columns of the dataset at `input_root` by (from, to) and sums the values
+// of duplicate connections as TSumValue, 64 bits by default, with memory bounded by the run and buffer sizes of the settings:
+// runs of connections are radix sorted and coalesced in memory and spilled to temporary files, then merged
+// at most `m_max_fan_in` at a time. Writes the result with the node columns and the other parameters as a dataset to `output_root`;
+// other connection columns do not survive the deduplication and are left out.
+template <typename TId = int32_t, typename TValue = uint8_t, typename TSumValue = connection_sum_t<TValue>>
+ExternalSortResult external_sort_connections(
+    const std::string& input_root,
+    const std::string& output_root,
+    const ExternalSortSettings& settings = ExternalSortSettings(),
+    const std::string& global_params_file = "global_params.json")
+{
+
+    static_assert(sizeof(TSumValue) > sizeof(TValue) || sizeof(TSumValue) == sizeof(uint64_t), "Summed connection values need a wider type than the values");
+
+    namespace fs = std::filesystem;
+
+    fs::create_directories(output_root);
+
+    if (fs::equivalent(input_root, output_root)) {
+
+        throw std::invalid_argument("external_sort_connections cannot write over its input " + input_root);
+    }
+
+    std::ifstream params_file(input_root + "/" + global_params_file);
+
+    if (!params_file) {
+
+        throw std::runtime_error("Cannot open " + input_root + "/" + global_params_file);
+    }
+
+    nlohmann::json global_params = nlohmann::json::parse(params_file);
+    std::vector<ColumnSchema> schema = read_schema(global_params);
+
+    auto find_schema = [&](const std::string& name) {
+        auto column = std::find_if(schema.begin(), schema.end(), [&](auto& column) { return column.m_name == name; });
+
+        if (column == schema.end()) {
+
+            throw std::out_of_range("The dataset has no column " + name);
+        }
+
+        return *column;
+    };
+
+    std::vector<ColumnSchema> connection_schema = { find_schema("from"), find_schema("to"), find_schema("value") };
+
+    ShardReader<TId> from_reader(input_root, connection_schema[0]);
+    ShardReader<TId> to_reader(input_root, connection_schema[1]);
+    ShardReader<TValue> value_reader(input_root, connection_schema[2]);
+
+    SortRunFiles run_files(settings.m_temporary_directory.empty() ? output_root : settings.m_temporary_directory);
+    std::vector<std::string> runs;
+
+    ExternalSortResult result;
+    size_t run_size = std::max<size_t>(settings.m_run_size, 1);
+
+    {
+        std::vector<TId> from(run_size);
+        std::vector<TId> to(run_size);
+        std::vector<TValue> values(run_size);
+        std::vector<uint64_t> keys(run_size);
+        std::vector<TSumValue> sums(run_size);
+        std::vector<SortRunEntry<TSumValue>> entries;
+
+        while (true) {
+
+            size_t count = from_reader.read(from.data(), run_size);
+
+            if (to_reader.read(to.data(), run_size) != count || value_reader.read(values.data(), run_size) != count) {
+
+                throw std::runtime_error("The connection columns of " + input_root + " have different lengths");
+            }
+
+            if (count == 0) {
+
+                break;
+            }
+
+            parallel::parallel_for_ranges(
+                0, count,
+                [&](size_t begin, size_t end, size_t) {
+                    for (size_t i = begin; i < end; i++) {
+
+                        bool swap = settings.m_undirected && to[i] < from[i];
+
+                        keys[i] = swap ? connection_sort_key(to[i], from[i]) : connection_sort_key(from[i], to[i]);
+                        sums[i] = TSumValue(values[i]);
+                    }
+                },
+                settings.m_thread_count, 1 << 14);
+
+            parallel::parallel_radix_sort(std::span<uint64_t>(keys.data(), count), std::span<TSumValue>(sums.data(), count), settings.m_thread_count);
+
+            entries.clear();
+
+            for (size_t i = 0; i < count; i++) {
+
+                if (!entries.empty() && entries.back().m_key == keys[i]) {
+
+                    entries.back().m_value += sums[i];
+                } else {
+
+                    entries.push_back(SortRunEntry<TSumValue> { keys[i], sums[i] });
+                }
+            }
+
+            runs.push_back(run_files.create());
+            std::ofstream run_file(runs.back(), std::ios::out | std::ios::binary);
+
+            if (!run_file.write((const char*)entries.data(), entries.size() * sizeof(SortRunEntry<TSumValue>))) {
+
+                throw std::runtime_error("Cannot write " + runs.back());
+            }
+
+            result.m_input_connections += count;
+            result.m_run_count++;
+        }
+    }
+
+    if (result.m_input_connections != global_params.at("links").get<size_t>()) {
+
+        throw std::runtime_error(input_root + " holds " + std::to_string(result.m_input_connections) + " connections instead of its "
+            + std::to_string(global_params.at("links").get<size_t>()) + " links");
+    }
+
+    size_t fan_in = std::max<size_t>(settings.m_max_fan_in, 2);
+
+    while (runs.size() > fan_in) {
+
+        std::vector<std::string> merged_runs;
+
+        for (size_t begin = 0; begin < runs.size(); begin += fan_in) {
+
+            std::vector<std::string> group(runs.begin() + begin, runs.begin() + std::min(begin + fan_in, runs.size()));
+
+            merged_runs.push_back(run_files.create());
+            std::ofstream run_file(merged_runs.back(), std::ios::out | std::ios::binary);
+
+            merge_sort_runs<TSumValue>(group, settings.m_merge_buffer_size, [&](uint64_t key, TSumValue value) {
+                SortRunEntry<TSumValue> entry { key, value };
+                run_file.write((const char*)&entry, sizeof(entry));
+            });
+
+            if (!run_file.flush()) {
+
+                throw std::runtime_error("Cannot write " + merged_runs.back());
+            }
+
+            for (auto& file_name : group) {
+
+                fs::remove(file_name);
+            }
+        }
+
+        runs = std::move(merged_runs);
+        result.m_merge_pass_count++;
+    }
+
+    connection_schema[2].m_type = column_type_name<TSumValue>();
+
+    for (auto& column : connection_schema) {
+
+        column.m_file = sharded_file_pattern(column.m_file);
+    }
+
+    ConnectionShardWriter<TId, TSumValue> writer(output_root, connection_schema, settings.m_shard_size);
+
+    merge_sort_runs<TSumValue>(runs, settings.m_merge_buffer_size, [&](uint64_t key, TSumValue value) {
+        auto [from, to] = connection_of_sort_key<TId>(key);
+        writer.write(from, to, value);
+    });
+
+    result.m_merge_pass_count++;
+
+    result.m_output_connections = writer.count();
+    result.m_shard_count = writer.finish();
+
+    nlohmann::json output_columns = nlohmann::json::array();
+
+    for (auto& column : schema) {
+
+        if (column.m_table == "connections") {
+
+            continue;
+        }
+
+        for (size_t shard = 0; shard < column.m_shards; shard++) {
+
+            fs::copy_file(shard_file_name(input_root, column, shard), shard_file_name(output_root, column, shard), fs::copy_options::overwrite_existing);
+        }
+
+        output_columns.push_back({ { "name", column.m_name }, { "table", column.m_table }, { "file", column.m_file }, { "type", column.m_type }, { "shards", column.m_shards } });
+    }
+
+    for (auto& column : connection_schema) {
+
+        output_columns.push_back({ { "name", column.m_name }, { "table", column.m_table }, { "file", column.m_file }, { "type", column.m_type }, { "shards", result.m_shard_count } });
+    }
+
+    global_params["links"] = result.m_output_connections;
+    global_params["columns"] = output_columns;
+
+    std::ofstream output_params(output_root + "/" + global_params_file);
+
+    if (!(output_params << global_params.dump(4))) {
+
+        throw std::runtime_error("Cannot write " + output_root + "/" + global_params_file);
+    }
+
+    return result;
+}
+}
+
+#endif
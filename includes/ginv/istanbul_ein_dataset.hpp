@@ -1,6 +1,8 @@
 #ifndef ISTANBUL_EIN_DATASET_HPP_
 #define ISTANBUL_EIN_DATASET_HPP_
 
+#include <future>
+#include <ginv/parallel/work_stealing_pool.hpp>
 #include <osigma/ograph.hpp>
 #include <string>
 
@@ -15,22 +17,16 @@ public:
     std::string describe() const;
 
 private:
-    const int m_feature_count = 6;
-    const int m_feature_file_count = 1;
-    std::tuple<std::string, std::string, std::string, std::string, std::string, std::string> m_feature_files = std::make_tuple(
-        "feature_degree_${FILE_ID}.bin",
-        "feature_centrality_${FILE_ID}.bin",
-        "feature_number_of_trades_${FILE_ID}.bin",
-        "feature_profits_${FILE_ID}.bin",
-        "feature_profits_excess_${FILE_ID}.bin",
-        "feature_volume_${FILE_ID}.bin");
-
     void load_dataset(std::string root, std::string global_params_file);
-    void load_features(std::string root);
-    void load_ein_bins(
-        std::string ein_folder, std::string from_name = "ein_from_${FILE_ID}.bin", std::string to_name = "ein_to_${FILE_ID}.bin",
-        std::string value_name = "ein_value_${FILE_ID}.bin", std::tuple<int, int, int> file_counts = std::make_tuple(2, 2, 1));
 };
+
+// Loads the dataset as a task of the pool, by default the shared library pool
+inline std::future<IstanbulEinDatasetBin> load_istanbul_ein_dataset_async(
+    std::string root, std::string global_params_file = "global_params.json", parallel::WorkStealingPool& pool = parallel::default_work_stealing_pool())
+{
+
+    return pool.submit([root, global_params_file]() { return IstanbulEinDatasetBin(root, global_params_file); });
+}
 }
 
 #endif
\ No newline at end of file
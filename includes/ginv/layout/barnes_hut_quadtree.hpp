@@ -0,0 +1,220 @@
+#ifndef BARNES_HUT_QUADTREE_HPP_
+#define BARNES_HUT_QUADTREE_HPP_
+
+#include <algorithm>
+#include <cstdint>
+#include <span>
+#include <string>
+#include <tuple>
+#include <vector>
+
+namespace layout {
+
+// Quadtree of weighted points for Barnes-Hut approximation of pairwise forces.
+// Cells are stored in a flat array; the four children of a cell are consecutive.
+template <typename TQ>
+class BarnesHutQuadtree {
+
+public:
+    static constexpr int32_t NO_BODY = -1;
+    static constexpr int32_t MANY_BODIES = -2;
+    static constexpr size_t MAX_DEPTH = 48;
+
+    class Cell {
+
+    public:
+        TQ m_center_x;
+        TQ m_center_y;
+        TQ m_half_size;
+        TQ m_mass = 0;
+        TQ m_mass_x = 0;
+        TQ m_mass_y = 0;
+        int32_t m_first_child = -1;
+        int32_t m_body = NO_BODY;
+    };
+
+    std::vector<Cell> m_cells;
+
+    explicit BarnesHutQuadtree()
+    {
+    }
+
+    explicit BarnesHutQuadtree(std::span<const TQ> x, std::span<const TQ> y, std::span<const TQ> masses)
+    {
+
+        build(x, y, masses);
+    }
+
+    void build(std::span<const TQ> x, std::span<const TQ> y, std::span<const TQ> masses)
+    {
+
+        m_cells.clear();
+
+        if (x.empty()) {
+
+            return;
+        }
+
+        auto [min_x, max_x] = std::minmax_element(x.begin(), x.end());
+        auto [min_y, max_y] = std::minmax_element(y.begin(), y.end());
+
+        Cell root;
+        root.m_center_x = (*min_x + *max_x) / 2;
+        root.m_center_y = (*min_y + *max_y) / 2;
+        root.m_half_size = std::max<TQ>(std::max(*max_x - *min_x, *max_y - *min_y) / 2, TQ(1e-6)) * TQ(1.0001);
+
+        m_cells.reserve(2 * x.size());
+        m_cells.push_back(root);
+
+        for (size_t i = 0; i < x.size(); i++) {
+
+            insert(int32_t(i), x[i], y[i], masses[i], x, y);
+        }
+
+        for (auto& cell : m_cells) {
+
+            if (cell.m_mass > 0) {
+
+                cell.m_mass_x /= cell.m_mass;
+                cell.m_mass_y /= cell.m_mass;
+            }
+        }
+    }
+
+    // Sums force_scale * mass * cell_mass / distance along the direction away from every far enough cell;
+    // a cell is far enough when its size is below theta times its distance
+    std::tuple<TQ, TQ> repulsion(int32_t body, TQ x, TQ y, TQ mass, TQ theta, TQ force_scale, std::vector<int32_t>& stack) const
+    {
+
+        TQ force_x = 0;
+        TQ force_y = 0;
+
+        if (m_cells.empty()) {
+
+            return std::make_tuple(force_x, force_y);
+        }
+
+        stack.clear();
+        stack.push_back(0);
+
+        while (!stack.empty()) {
+
+            const Cell& cell = m_cells[stack.back()];
+            stack.pop_back();
+
+            if (cell.m_mass <= 0 || cell.m_body == body) {
+
+                continue;
+            }
+
+            TQ dx = x - cell.m_mass_x;
+            TQ dy = y - cell.m_mass_y;
+            TQ distance2 = dx * dx + dy * dy;
+            TQ size = 2 * cell.m_half_size;
+
+            if (cell.m_first_child < 0 || size * size < theta * theta * distance2) {
+
+                if (distance2 > 0) {
+
+                    TQ factor = force_scale * mass * cell.m_mass / distance2;
+
+                    force_x += dx * factor;
+                    force_y += dy * factor;
+                }
+            } else {
+
+                for (int32_t child = 0; child < 4; child++) {
+
+                    stack.push_back(cell.m_first_child + child);
+                }
+            }
+        }
+
+        return std::make_tuple(force_x, force_y);
+    }
+
+    std::string describe() const
+    {
+
+        return "BarnesHutQuadtree(" + std::to_string(m_cells.size()) + " cells)";
+    }
+
+    // private:
+    int32_t child_of(const Cell& cell, TQ x, TQ y) const
+    {
+
+        return cell.m_first_child + (x >= cell.m_center_x ? 1 : 0) + (y >= cell.m_center_y ? 2 : 0);
+    }
+
+    void subdivide(size_t cell_id)
+    {
+
+        int32_t first_child = int32_t(m_cells.size());
+        TQ half_size = m_cells[cell_id].m_half_size / 2;
+
+        for (int32_t child = 0; child < 4; child++) {
+
+            Cell child_cell;
+            child_cell.m_center_x = m_cells[cell_id].m_center_x + ((child & 1) ? half_size : -half_size);
+            child_cell.m_center_y = m_cells[cell_id].m_center_y + ((child & 2) ? half_size : -half_size);
+            child_cell.m_half_size = half_size;
+
+            m_cells.push_back(child_cell);
+        }
+
+        m_cells[cell_id].m_first_child = first_child;
+    }
+
+    void add_mass(Cell& cell, TQ x, TQ y, TQ mass)
+    {
+
+        cell.m_mass += mass;
+        cell.m_mass_x += x * mass;
+        cell.m_mass_y += y * mass;
+    }
+
+    void insert(int32_t body, TQ x, TQ y, TQ mass, std::span<const TQ> xs, std::span<const TQ> ys)
+    {
+
+        size_t cell_id = 0;
+
+        for (size_t depth = 0;; depth++) {
+
+            add_mass(m_cells[cell_id], x, y, mass);
+
+            if (m_cells[cell_id].m_first_child >= 0) {
+
+                cell_id = child_of(m_cells[cell_id], x, y);
+                continue;
+            }
+
+            if (m_cells[cell_id].m_body == NO_BODY && m_cells[cell_id].m_mass == mass) {
+
+                m_cells[cell_id].m_body = body;
+                return;
+            }
+
+            // Coincident or extremely close bodies share a leaf instead of subdividing forever
+            if (m_cells[cell_id].m_body == MANY_BODIES || depth >= MAX_DEPTH) {
+
+                m_cells[cell_id].m_body = MANY_BODIES;
+                return;
+            }
+
+            int32_t resident = m_cells[cell_id].m_body;
+            TQ resident_mass = m_cells[cell_id].m_mass - mass;
+
+            m_cells[cell_id].m_body = NO_BODY;
+            subdivide(cell_id);
+
+            size_t resident_cell = child_of(m_cells[cell_id], xs[resident], ys[resident]);
+            add_mass(m_cells[resident_cell], xs[resident], ys[resident], resident_mass);
+            m_cells[resident_cell].m_body = resident;
+
+            cell_id = child_of(m_cells[cell_id], x, y);
+        }
+    }
+};
+}
+
+#endif
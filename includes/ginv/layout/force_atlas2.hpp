@@ -0,0 +1,319 @@
+#ifndef FORCE_ATLAS2_HPP_
+#define FORCE_ATLAS2_HPP_
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <random>
+#include <span>
+#include <string>
+#include <vector>
+
+#include <ginv/layout/barnes_hut_quadtree.hpp>
+#include <ginv/parallel/parallel_for.hpp>
+#include <osigma/oconnection_index.hpp>
+#include <osigma/ograph.hpp>
+
+namespace layout {
+
+template <typename TQ>
+class ForceAtlas2Settings {
+
+public:
+    TQ m_scaling_ratio = 2;
+    TQ m_gravity = 1;
+    bool m_strong_gravity = false;
+    TQ m_edge_weight_influence = 1;
+    TQ m_jitter_tolerance = 1;
+    bool m_barnes_hut = true;
+    TQ m_theta = 1.2;
+    size_t m_max_iterations = 100;
+    // Stops once the mean node displacement of an iteration falls below it; 0 runs all iterations
+    TQ m_tolerance = 0;
+    size_t m_thread_count = 0;
+    uint64_t m_seed = 2605;
+
+    std::string describe() const
+    {
+
+        return "ForceAtlas2Settings(scaling " + std::to_string(m_scaling_ratio) + ", gravity " + std::to_string(m_gravity)
+            + (m_strong_gravity ? " strong" : "") + ", " + (m_barnes_hut ? "barnes-hut theta " + std::to_string(m_theta) : "exact")
+            + ", " + std::to_string(m_max_iterations) + " iterations)";
+    }
+};
+
+// ForceAtlas2 (Jacomy et al. 2014) with degree-weighted repulsion, linear attraction along connections
+// and the adaptive global and per-node speeds of the reference implementation.
+// Expects an undirected (Both) index; moves `x` and `y` in place and returns the number of iterations run.
+// Node masses default to degree + 1.
+template <typename TQ, typename TId, typename TValue>
+size_t force_atlas2(
+    const ograph::OConnectionIndex<TId, TValue>& index,
+    std::vector<TQ>& x,
+    std::vector<TQ>& y,
+    const ForceAtlas2Settings<TQ>& settings = ForceAtlas2Settings<TQ>(),
+    std::span<const TQ> node_masses = std::span<const TQ>())
+{
+
+    size_t node_count = index.node_count();
+    size_t threads = parallel::resolve_thread_count(settings.m_thread_count);
+    size_t min_range_size = 1024;
+
+    std::vector<TQ> masses(node_count);
+    std::vector<TQ> weights(index.m_values.size());
+
+    for (size_t v = 0; v < node_count; v++) {
+
+        masses[v] = node_masses.empty() ? TQ(index.degree(v) + 1) : node_masses[v];
+    }
+
+    for (size_t q = 0; q < weights.size(); q++) {
+
+        weights[q] = settings.m_edge_weight_influence == 0 ? TQ(1)
+            : settings.m_edge_weight_influence == 1        ? TQ(index.m_values[q])
+                                                           : std::pow(TQ(index.m_values[q]), settings.m_edge_weight_influence);
+    }
+
+    std::vector<TQ> force_x(node_count, 0);
+    std::vector<TQ> force_y(node_count, 0);
+    std::vector<TQ> old_force_x(node_count, 0);
+    std::vector<TQ> old_force_y(node_count, 0);
+    std::vector<TQ> partial_swings(threads);
+    std::vector<TQ> partial_tractions(threads);
+    std::vector<TQ> partial_displacements(threads);
+
+    BarnesHutQuadtree<TQ> tree;
+
+    TQ speed = 1;
+    TQ speed_efficiency = 1;
+    size_t iteration = 0;
+
+    while (iteration < settings.m_max_iterations && node_count > 0) {
+
+        iteration++;
+
+        if (settings.m_barnes_hut) {
+
+            tree.build(std::span<const TQ>(x), std::span<const TQ>(y), std::span<const TQ>(masses));
+        }
+
+        std::fill(partial_swings.begin(), partial_swings.end(), TQ(0));
+        std::fill(partial_tractions.begin(), partial_tractions.end(), TQ(0));
+
+        parallel::parallel_for_ranges(
+            0, node_count,
+            [&](size_t begin, size_t end, size_t thread_id) {
+                std::vector<int32_t> stack;
+                TQ swing = 0;
+                TQ traction = 0;
+
+                for (size_t v = begin; v < end; v++) {
+
+                    TQ fx = 0;
+                    TQ fy = 0;
+
+                    if (settings.m_barnes_hut) {
+
+                        auto [rx, ry] = tree.repulsion(int32_t(v), x[v], y[v], masses[v], settings.m_theta, settings.m_scaling_ratio, stack);
+                        fx = rx;
+                        fy = ry;
+                    } else {
+
+                        // Branch-free loop over the coordinate columns that the compiler vectorizes
+                        TQ scale = settings.m_scaling_ratio * masses[v];
+
+                        for (size_t u = 0; u < node_count; u++) {
+
+                            TQ dx = x[v] - x[u];
+                            TQ dy = y[v] - y[u];
+                            TQ distance2 = dx * dx + dy * dy;
+                            TQ factor = distance2 > 0 ? scale * masses[u] / distance2 : TQ(0);
+
+                            fx += dx * factor;
+                            fy += dy * factor;
+                        }
+                    }
+
+                    TQ distance = std::sqrt(x[v] * x[v] + y[v] * y[v]);
+
+                    if (distance > 0) {
+
+                        TQ factor = settings.m_strong_gravity ? settings.m_scaling_ratio * settings.m_gravity * masses[v]
+                                                              : settings.m_gravity * masses[v] / distance;
+
+                        fx -= x[v] * factor;
+                        fy -= y[v] * factor;
+                    }
+
+                    auto neighbours = index.neighbours(v);
+                    size_t offset = index.m_offsets[v];
+
+                    for (size_t q = 0; q < neighbours.size(); q++) {
+
+                        fx += (x[neighbours[q]] - x[v]) * weights[offset + q];
+                        fy += (y[neighbours[q]] - y[v]) * weights[offset + q];
+                    }
+
+                    force_x[v] = fx;
+                    force_y[v] = fy;
+
+                    TQ swing_x = fx - old_force_x[v];
+                    TQ swing_y = fy - old_force_y[v];
+                    TQ traction_x = fx + old_force_x[v];
+                    TQ traction_y = fy + old_force_y[v];
+
+                    swing += masses[v] * std::sqrt(swing_x * swing_x + swing_y * swing_y);
+                    traction += masses[v] * std::sqrt(traction_x * traction_x + traction_y * traction_y) / 2;
+                }
+
+                partial_swings[thread_id] = swing;
+                partial_tractions[thread_id] = traction;
+            },
+            threads, min_range_size);
+
+        TQ total_swing = 0;
+        TQ total_traction = 0;
+
+        for (size_t t = 0; t < threads; t++) {
+
+            total_swing += partial_swings[t];
+            total_traction += partial_tractions[t];
+        }
+
+        TQ estimated_optimal_jitter_tolerance = TQ(0.05) * std::sqrt(TQ(node_count));
+        TQ min_jitter_tolerance = std::sqrt(estimated_optimal_jitter_tolerance);
+        TQ jitter_tolerance = settings.m_jitter_tolerance
+            * std::max(min_jitter_tolerance,
+                std::min(TQ(10), estimated_optimal_jitter_tolerance * total_traction / (TQ(node_count) * TQ(node_count))));
+
+        TQ min_speed_efficiency = TQ(0.05);
+
+        if (total_traction > 0 && total_swing / total_traction > 2) {
+
+            if (speed_efficiency > min_speed_efficiency) {
+
+                speed_efficiency *= TQ(0.5);
+            }
+
+            jitter_tolerance = std::max(jitter_tolerance, settings.m_jitter_tolerance);
+        }
+
+        TQ target_speed = total_swing > 0 ? jitter_tolerance * speed_efficiency * total_traction / total_swing : speed;
+
+        if (total_swing > jitter_tolerance * total_traction) {
+
+            if (speed_efficiency > min_speed_efficiency) {
+
+                speed_efficiency *= TQ(0.7);
+            }
+        } else if (speed < 1000) {
+
+            speed_efficiency *= TQ(1.3);
+        }
+
+        speed = speed + std::min(target_speed - speed, TQ(0.5) * speed);
+
+        std::fill(partial_displacements.begin(), partial_displacements.end(), TQ(0));
+
+        parallel::parallel_for_ranges(
+            0, node_count,
+            [&](size_t begin, size_t end, size_t thread_id) {
+                TQ displacement = 0;
+
+                for (size_t v = begin; v < end; v++) {
+
+                    TQ swing_x = force_x[v] - old_force_x[v];
+                    TQ swing_y = force_y[v] - old_force_y[v];
+                    TQ swing = masses[v] * std::sqrt(swing_x * swing_x + swing_y * swing_y);
+                    TQ factor = speed / (1 + std::sqrt(speed * swing));
+
+                    x[v] += force_x[v] * factor;
+                    y[v] += force_y[v] * factor;
+                    displacement += factor * std::sqrt(force_x[v] * force_x[v] + force_y[v] * force_y[v]);
+                }
+
+                partial_displacements[thread_id] = displacement;
+            },
+            threads, min_range_size);
+
+        force_x.swap(old_force_x);
+        force_y.swap(old_force_y);
+
+        TQ displacement = 0;
+
+        for (auto partial_displacement : partial_displacements) {
+
+            displacement += partial_displacement;
+        }
+
+        if (settings.m_tolerance > 0 && displacement / TQ(node_count) < settings.m_tolerance) {
+
+            break;
+        }
+    }
+
+    return iteration;
+}
+
+// Lays out the graph into its node coordinates. Existing coordinates are used as the starting
+// positions unless they are missing or all equal, in which case nodes start at seeded random positions.
+template <
+    typename TQ,
+    template <typename> typename TAllocator,
+    typename TId,
+    typename TConnectionWeight,
+    typename TCoordinates,
+    typename TZIndex,
+    typename... TNodeFeatures>
+size_t force_atlas2_layout(
+    ograph::BasicOGraph<TAllocator, TId, TConnectionWeight, TCoordinates, TZIndex, TNodeFeatures...>& graph,
+    const ForceAtlas2Settings<TQ>& settings = ForceAtlas2Settings<TQ>())
+{
+
+    size_t node_count = graph.node_count();
+    auto& x_coordinates = graph.m_nodes.m_x_coordinates;
+    auto& y_coordinates = graph.m_nodes.m_y_coordinates;
+
+    std::vector<TQ> x(node_count);
+    std::vector<TQ> y(node_count);
+
+    bool has_positions = x_coordinates.size() == node_count && y_coordinates.size() == node_count && node_count > 1
+        && (std::any_of(x_coordinates.begin(), x_coordinates.end(), [&](auto value) { return value != x_coordinates[0]; })
+            || std::any_of(y_coordinates.begin(), y_coordinates.end(), [&](auto value) { return value != y_coordinates[0]; }));
+
+    if (has_positions) {
+
+        for (size_t i = 0; i < node_count; i++) {
+
+            x[i] = TQ(x_coordinates[i]);
+            y[i] = TQ(y_coordinates[i]);
+        }
+    } else {
+
+        std::mt19937_64 random(settings.m_seed);
+        std::uniform_real_distribution<TQ> distribution(-std::sqrt(TQ(node_count)), std::sqrt(TQ(node_count)));
+
+        for (size_t i = 0; i < node_count; i++) {
+
+            x[i] = distribution(random);
+            y[i] = distribution(random);
+        }
+    }
+
+    auto index = ograph::create_connection_index(node_count, graph.m_connections, ograph::ConnectionDirection::Both);
+    size_t iterations = force_atlas2(index, x, y, settings);
+
+    x_coordinates.resize(node_count);
+    y_coordinates.resize(node_count);
+
+    for (size_t i = 0; i < node_count; i++) {
+
+        x_coordinates[i] = TCoordinates(x[i]);
+        y_coordinates[i] = TCoordinates(y[i]);
+    }
+
+    return iterations;
+}
+}
+
+#endif
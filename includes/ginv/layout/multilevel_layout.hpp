@@ -0,0 +1,290 @@
+#ifndef MULTILEVEL_LAYOUT_HPP_
+#define MULTILEVEL_LAYOUT_HPP_
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <future>
+#include <numeric>
+#include <random>
+#include <span>
+#include <stdexcept>
+#include <string>
+#include <tuple>
+#include <vector>
+
+#include <ginv/clustering/community_labels.hpp>
+#include <ginv/layout/force_atlas2.hpp>
+#include <ginv/parallel/thread_pool.hpp>
+#include <osigma/oconnection_index.hpp>
+#include <osigma/ograph.hpp>
+
+namespace layout {
+
+template <typename TQ>
+class MultilevelLayoutSettings {
+
+public:
+    ForceAtlas2Settings<TQ> m_coarse;
+    ForceAtlas2Settings<TQ> m_refine;
+    // Iterations of ForceAtlas2 over the whole graph after the communities are placed
+    size_t m_final_iterations = 0;
+    size_t m_thread_count = 0;
+    uint64_t m_seed = 2605;
+
+    explicit MultilevelLayoutSettings()
+    {
+
+        m_refine.m_max_iterations = 50;
+    }
+
+    std::string describe() const
+    {
+
+        return "MultilevelLayoutSettings(coarse " + m_coarse.describe() + ", refine " + m_refine.describe()
+            + ", " + std::to_string(m_final_iterations) + " final iterations)";
+    }
+};
+
+// Lays out the community supergraph with community sizes as masses, then lays out every community
+// on its own in parallel and fits it into a disc of radius sqrt(size) around its community position.
+// The coarse positions are stretched until connected communities are, on average, clear of each other.
+template <
+    typename TQ,
+    template <typename> typename TAllocator,
+    typename TId,
+    typename TConnectionWeight,
+    typename TCoordinates,
+    typename TZIndex,
+    typename... TNodeFeatures>
+void multilevel_layout(
+    ograph::BasicOGraph<TAllocator, TId, TConnectionWeight, TCoordinates, TZIndex, TNodeFeatures...>& graph,
+    const clustering::CommunityLabels<TId>& labels,
+    const MultilevelLayoutSettings<TQ>& settings = MultilevelLayoutSettings<TQ>())
+{
+
+    size_t node_count = graph.node_count();
+    size_t community_count = labels.community_count();
+
+    if (labels.node_count() != node_count
+        || std::any_of(labels.m_labels.begin(), labels.m_labels.end(), [](TId label) { return label == clustering::CommunityLabels<TId>::NO_COMMUNITY; })) {
+
+        throw std::invalid_argument("multilevel_layout needs a community for every node of the graph");
+    }
+
+    std::span<const TId> from_ids(graph.m_connections.m_from);
+    std::span<const TId> to_ids(graph.m_connections.m_to);
+    std::span<const TConnectionWeight> values(graph.m_connections.m_values);
+
+    std::vector<TId> local_ids(node_count);
+
+    for (size_t c = 0; c < community_count; c++) {
+
+        auto members = labels.community_members(c);
+
+        for (size_t q = 0; q < members.size(); q++) {
+
+            local_ids[members[q]] = TId(q);
+        }
+    }
+
+    // Connections inside communities are bucketed per community, the others are summed per community pair
+    std::vector<size_t> local_offsets(community_count + 1, 0);
+    std::vector<std::tuple<uint64_t, TQ>> super_connections;
+
+    for (size_t i = 0; i < from_ids.size(); i++) {
+
+        uint64_t a = uint64_t(labels.m_labels[from_ids[i]]);
+        uint64_t b = uint64_t(labels.m_labels[to_ids[i]]);
+
+        if (a == b) {
+
+            local_offsets[a + 1]++;
+        } else {
+
+            super_connections.emplace_back((std::min(a, b) << 32) | std::max(a, b), TQ(values[i]));
+        }
+    }
+
+    for (size_t c = 0; c < community_count; c++) {
+
+        local_offsets[c + 1] += local_offsets[c];
+    }
+
+    std::vector<TId> local_from(local_offsets.back());
+    std::vector<TId> local_to(local_offsets.back());
+    std::vector<TConnectionWeight> local_values(local_offsets.back());
+    std::vector<size_t> cursors(local_offsets.begin(), local_offsets.end() - 1);
+
+    for (size_t i = 0; i < from_ids.size(); i++) {
+
+        TId community = labels.m_labels[from_ids[i]];
+
+        if (community == labels.m_labels[to_ids[i]]) {
+
+            size_t position = cursors[community]++;
+
+            local_from[position] = local_ids[from_ids[i]];
+            local_to[position] = local_ids[to_ids[i]];
+            local_values[position] = values[i];
+        }
+    }
+
+    std::sort(super_connections.begin(), super_connections.end());
+
+    std::vector<TId> super_from;
+    std::vector<TId> super_to;
+    std::vector<TQ> super_values;
+
+    for (size_t i = 0; i < super_connections.size(); i++) {
+
+        auto [key, value] = super_connections[i];
+
+        if (i > 0 && std::get<0>(super_connections[i - 1]) == key) {
+
+            super_values.back() += value;
+        } else {
+
+            super_from.push_back(TId(key >> 32));
+            super_to.push_back(TId(key & 0xffffffffu));
+            super_values.push_back(value);
+        }
+    }
+
+    std::vector<TQ> radii(community_count);
+    std::vector<TQ> masses(community_count);
+
+    for (size_t c = 0; c < community_count; c++) {
+
+        masses[c] = TQ(std::max<size_t>(labels.community_size(c), 1));
+        radii[c] = std::sqrt(masses[c]);
+    }
+
+    std::vector<TQ> center_x(community_count);
+    std::vector<TQ> center_y(community_count);
+
+    {
+        std::mt19937_64 random(settings.m_seed);
+        std::uniform_real_distribution<TQ> distribution(-std::sqrt(TQ(community_count)), std::sqrt(TQ(community_count)));
+
+        for (size_t c = 0; c < community_count; c++) {
+
+            center_x[c] = distribution(random);
+            center_y[c] = distribution(random);
+        }
+
+        auto super_index = ograph::create_connection_index<TId, TQ>(
+            community_count, std::span<const TId>(super_from), std::span<const TId>(super_to), std::span<const TQ>(super_values), ograph::ConnectionDirection::Both);
+
+        ForceAtlas2Settings<TQ> coarse = settings.m_coarse;
+        coarse.m_thread_count = settings.m_thread_count;
+
+        force_atlas2(super_index, center_x, center_y, coarse, std::span<const TQ>(masses));
+    }
+
+    TQ required_length = 0;
+    TQ current_length = 0;
+
+    for (size_t i = 0; i < super_from.size(); i++) {
+
+        required_length += TQ(1.5) * (radii[super_from[i]] + radii[super_to[i]]);
+        current_length += std::hypot(center_x[super_from[i]] - center_x[super_to[i]], center_y[super_from[i]] - center_y[super_to[i]]);
+    }
+
+    TQ stretch = current_length > 0 ? std::max(TQ(1), required_length / current_length) : TQ(1);
+
+    std::vector<TQ> x(node_count);
+    std::vector<TQ> y(node_count);
+
+    auto place_community = [&](size_t c) {
+        auto members = labels.community_members(c);
+        size_t size = members.size();
+
+        std::vector<TQ> local_x(size);
+        std::vector<TQ> local_y(size);
+
+        std::mt19937_64 random(settings.m_seed + 1 + c);
+        std::uniform_real_distribution<TQ> distribution(-radii[c], radii[c]);
+
+        for (size_t q = 0; q < size; q++) {
+
+            local_x[q] = distribution(random);
+            local_y[q] = distribution(random);
+        }
+
+        if (size > 1) {
+
+            size_t begin = local_offsets[c];
+            size_t count = local_offsets[c + 1] - begin;
+
+            auto local_index = ograph::create_connection_index<TId, TConnectionWeight>(
+                size, std::span<const TId>(local_from.data() + begin, count), std::span<const TId>(local_to.data() + begin, count),
+                std::span<const TConnectionWeight>(local_values.data() + begin, count), ograph::ConnectionDirection::Both);
+
+            ForceAtlas2Settings<TQ> refine = settings.m_refine;
+            refine.m_thread_count = 1;
+
+            force_atlas2(local_index, local_x, local_y, refine);
+        }
+
+        TQ mean_x = std::accumulate(local_x.begin(), local_x.end(), TQ(0)) / TQ(std::max<size_t>(size, 1));
+        TQ mean_y = std::accumulate(local_y.begin(), local_y.end(), TQ(0)) / TQ(std::max<size_t>(size, 1));
+        TQ extent = 0;
+
+        for (size_t q = 0; q < size; q++) {
+
+            extent = std::max(extent, std::hypot(local_x[q] - mean_x, local_y[q] - mean_y));
+        }
+
+        TQ scale = extent > 0 ? radii[c] / extent : TQ(0);
+
+        for (size_t q = 0; q < size; q++) {
+
+            x[members[q]] = stretch * center_x[c] + (local_x[q] - mean_x) * scale;
+            y[members[q]] = stretch * center_y[c] + (local_y[q] - mean_y) * scale;
+        }
+    };
+
+    std::vector<size_t> order(community_count);
+    std::iota(order.begin(), order.end(), size_t(0));
+    std::stable_sort(order.begin(), order.end(), [&](size_t a, size_t b) { return labels.community_size(a) > labels.community_size(b); });
+
+    {
+        parallel::ThreadPool pool(settings.m_thread_count);
+        std::vector<std::future<void>> futures;
+        futures.reserve(community_count);
+
+        for (size_t c : order) {
+
+            futures.push_back(pool.submit([&, c]() { place_community(c); }));
+        }
+
+        for (auto& future : futures) {
+
+            future.get();
+        }
+    }
+
+    if (settings.m_final_iterations > 0) {
+
+        auto index = ograph::create_connection_index(node_count, graph.m_connections, ograph::ConnectionDirection::Both);
+
+        ForceAtlas2Settings<TQ> final_settings = settings.m_refine;
+        final_settings.m_max_iterations = settings.m_final_iterations;
+        final_settings.m_thread_count = settings.m_thread_count;
+
+        force_atlas2(index, x, y, final_settings);
+    }
+
+    graph.m_nodes.m_x_coordinates.resize(node_count);
+    graph.m_nodes.m_y_coordinates.resize(node_count);
+
+    for (size_t i = 0; i < node_count; i++) {
+
+        graph.m_nodes.m_x_coordinates[i] = TCoordinates(x[i]);
+        graph.m_nodes.m_y_coordinates[i] = TCoordinates(y[i]);
+    }
+}
+}
+
+#endif
@@ -0,0 +1,469 @@
+#ifndef TILE_EXPORT_HPP_
+#define TILE_EXPORT_HPP_
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <stdexcept>
+#include <string>
+#include <tuple>
+#include <vector>
+
+#include <ginv/parallel/parallel_for.hpp>
+#include <ginv/parallel/parallel_sort.hpp>
+#include <osigma/ograph.hpp>
+
+namespace layout {
+
+class TileInfo {
+
+public:
+    uint32_t m_level;
+    uint32_t m_x;
+    uint32_t m_y;
+    uint64_t m_node_count;
+    uint64_t m_connection_count;
+};
+
+// Square bounds of the layout split into 2^level x 2^level tiles per z-level. A tile of level L holds
+// the nodes of z-index exactly L, so a viewer loads the tiles of levels 0..L that intersect its viewport.
+// Grids stop subdividing at MAX_GRID_LEVEL; deeper levels reuse its tiles.
+class TilePyramid {
+
+public:
+    static constexpr uint32_t MAX_GRID_LEVEL = 20;
+
+    double m_min_x;
+    double m_min_y;
+    double m_size;
+    uint32_t m_level_count;
+    std::vector<TileInfo> m_tiles;
+
+    explicit TilePyramid(double min_x, double min_y, double size, uint32_t level_count, std::vector<TileInfo> tiles = {})
+        : m_min_x(min_x)
+        , m_min_y(min_y)
+        , m_size(size)
+        , m_level_count(level_count)
+        , m_tiles(std::move(tiles))
+    {
+    }
+
+    static uint32_t grid_size(uint32_t level)
+    {
+
+        return uint32_t(1) << std::min(level, MAX_GRID_LEVEL);
+    }
+
+    std::tuple<uint32_t, uint32_t> tile_of(uint32_t level, double x, double y) const
+    {
+
+        uint32_t cells = grid_size(level);
+
+        auto cell = [&](double value, double min) {
+            double position = std::floor((value - min) / m_size * cells);
+            return uint32_t(std::clamp(position, 0.0, double(cells - 1)));
+        };
+
+        return std::make_tuple(cell(x, m_min_x), cell(y, m_min_y));
+    }
+
+    static std::string tile_path(uint32_t level, uint32_t x, uint32_t y)
+    {
+
+        return std::to_string(level) + "/" + std::to_string(x) + "_" + std::to_string(y) + ".bin";
+    }
+
+    std::string describe() const
+    {
+
+        return "TilePyramid(" + std::to_string(m_tiles.size()) + " tiles in " + std::to_string(m_level_count) + " levels)";
+    }
+};
+
+// Nodes of a tile with their positions, and connections of the tile level with the positions of both
+// endpoints so they can be drawn without the tiles of the endpoints
+template <typename TId, typename TConnectionWeight, typename TCoordinates>
+class Tile {
+
+public:
+    uint32_t m_level;
+    uint32_t m_x;
+    uint32_t m_y;
+    std::vector<TId> m_node_ids;
+    std::vector<TCoordinates> m_x_coordinates;
+    std::vector<TCoordinates> m_y_coordinates;
+    std::vector<TId> m_from;
+    std::vector<TId> m_to;
+    std::vector<TConnectionWeight> m_values;
+    std::vector<TCoordinates> m_from_x;
+    std::vector<TCoordinates> m_from_y;
+    std::vector<TCoordinates> m_to_x;
+    std::vector<TCoordinates> m_to_y;
+
+    std::string describe() const
+    {
+
+        return "Tile(" + std::to_string(m_level) + "/" + std::to_string(m_x) + "_" + std::to_string(m_y) + " with "
+            + std::to_string(m_node_ids.size()) + " nodes and " + std::to_string(m_from.size()) + " connections)";
+    }
+};
+
+// Tile layout: magic, sizes of id, weight and coordinate, level, x, y (uint32), node and connection counts (uint64),
+// then the node columns (ids, x, y) and the connection columns (from, to, values, from x, from y, to x, to y).
+// pyramid.bin holds magic, bounds (double), level and tile counts (uint64) and (level, x, y, nodes, connections) per tile.
+inline constexpr char TILE_MAGIC[8] = { 'G', 'I', 'N', 'V', 'T', 'L', '0', '1' };
+inline constexpr char TILE_PYRAMID_MAGIC[8] = { 'G', 'I', 'N', 'V', 'T', 'P', '0', '1' };
+
+template <typename TColumn>
+void write_column(std::ostream& stream, const TColumn& column)
+{
+
+    stream.write((const char*)column.data(), column.size() * sizeof(typename TColumn::value_type));
+}
+
+template <typename TColumn>
+void read_column(std::istream& stream, TColumn& column, size_t size)
+{
+
+    column.resize(size);
+    stream.read((char*)column.data(), size * sizeof(typename TColumn::value_type));
+}
+
+template <typename TId, typename TConnectionWeight, typename TCoordinates>
+void write_tile(const Tile<TId, TConnectionWeight, TCoordinates>& tile, std::string file_name)
+{
+
+    std::ofstream file(file_name, std::ios::out | std::ios::binary);
+
+    if (!file) {
+
+        throw std::runtime_error("Cannot open " + file_name);
+    }
+
+    uint32_t header[6] = { sizeof(TId), sizeof(TConnectionWeight), sizeof(TCoordinates), tile.m_level, tile.m_x, tile.m_y };
+    uint64_t counts[2] = { tile.m_node_ids.size(), tile.m_from.size() };
+
+    file.write(TILE_MAGIC, sizeof(TILE_MAGIC));
+    file.write((const char*)header, sizeof(header));
+    file.write((const char*)counts, sizeof(counts));
+
+    write_column(file, tile.m_node_ids);
+    write_column(file, tile.m_x_coordinates);
+    write_column(file, tile.m_y_coordinates);
+    write_column(file, tile.m_from);
+    write_column(file, tile.m_to);
+    write_column(file, tile.m_values);
+    write_column(file, tile.m_from_x);
+    write_column(file, tile.m_from_y);
+    write_column(file, tile.m_to_x);
+    write_column(file, tile.m_to_y);
+
+    if (!file) {
+
+        throw std::runtime_error("Cannot write " + file_name);
+    }
+}
+
+template <typename TId, typename TConnectionWeight, typename TCoordinates>
+Tile<TId, TConnectionWeight, TCoordinates> read_tile(std::string file_name)
+{
+
+    std::ifstream file(file_name, std::ios::in | std::ios::binary);
+
+    if (!file) {
+
+        throw std::runtime_error("Cannot open " + file_name);
+    }
+
+    char magic[sizeof(TILE_MAGIC)];
+    uint32_t header[6];
+    uint64_t counts[2];
+
+    file.read(magic, sizeof(magic));
+    file.read((char*)header, sizeof(header));
+    file.read((char*)counts, sizeof(counts));
+
+    if (!file || std::memcmp(magic, TILE_MAGIC, sizeof(magic)) != 0) {
+
+        throw std::runtime_error(file_name + " is not a tile");
+    }
+
+    if (header[0] != sizeof(TId) || header[1] != sizeof(TConnectionWeight) || header[2] != sizeof(TCoordinates)) {
+
+        throw std::runtime_error(file_name + " was written with other id, weight or coordinate types");
+    }
+
+    Tile<TId, TConnectionWeight, TCoordinates> tile;
+    tile.m_level = header[3];
+    tile.m_x = header[4];
+    tile.m_y = header[5];
+
+    read_column(file, tile.m_node_ids, counts[0]);
+    read_column(file, tile.m_x_coordinates, counts[0]);
+    read_column(file, tile.m_y_coordinates, counts[0]);
+    read_column(file, tile.m_from, counts[1]);
+    read_column(file, tile.m_to, counts[1]);
+    read_column(file, tile.m_values, counts[1]);
+    read_column(file, tile.m_from_x, counts[1]);
+    read_column(file, tile.m_from_y, counts[1]);
+    read_column(file, tile.m_to_x, counts[1]);
+    read_column(file, tile.m_to_y, counts[1]);
+
+    if (!file) {
+
+        throw std::runtime_error("Truncated tile " + file_name);
+    }
+
+    return tile;
+}
+
+inline void write_tile_pyramid(const TilePyramid& pyramid, std::string file_name)
+{
+
+    std::ofstream file(file_name, std::ios::out | std::ios::binary);
+
+    if (!file) {
+
+        throw std::runtime_error("Cannot open " + file_name);
+    }
+
+    double bounds[3] = { pyramid.m_min_x, pyramid.m_min_y, pyramid.m_size };
+    uint64_t counts[2] = { pyramid.m_level_count, pyramid.m_tiles.size() };
+
+    file.write(TILE_PYRAMID_MAGIC, sizeof(TILE_PYRAMID_MAGIC));
+    file.write((const char*)bounds, sizeof(bounds));
+    file.write((const char*)counts, sizeof(counts));
+
+    for (auto& tile : pyramid.m_tiles) {
+
+        uint32_t position[3] = { tile.m_level, tile.m_x, tile.m_y };
+        uint64_t sizes[2] = { tile.m_node_count, tile.m_connection_count };
+
+        file.write((const char*)position, sizeof(position));
+        file.write((const char*)sizes, sizeof(sizes));
+    }
+
+    if (!file) {
+
+        throw std::runtime_error("Cannot write " + file_name);
+    }
+}
+
+inline TilePyramid read_tile_pyramid(std::string file_name)
+{
+
+    std::ifstream file(file_name, std::ios::in | std::ios::binary);
+
+    if (!file) {
+
+        throw std::runtime_error("Cannot open " + file_name);
+    }
+
+    char magic[sizeof(TILE_PYRAMID_MAGIC)];
+    double bounds[3];
+    uint64_t counts[2];
+
+    file.read(magic, sizeof(magic));
+    file.read((char*)bounds, sizeof(bounds));
+    file.read((char*)counts, sizeof(counts));
+
+    if (!file || std::memcmp(magic, TILE_PYRAMID_MAGIC, sizeof(magic)) != 0) {
+
+        throw std::runtime_error(file_name + " is not a tile pyramid");
+    }
+
+    TilePyramid pyramid(bounds[0], bounds[1], bounds[2], uint32_t(counts[0]));
+    pyramid.m_tiles.resize(counts[1]);
+
+    for (auto& tile : pyramid.m_tiles) {
+
+        uint32_t position[3];
+        uint64_t sizes[2];
+
+        file.read((char*)position, sizeof(position));
+        file.read((char*)sizes, sizeof(sizes));
+
+        tile = TileInfo { position[0], position[1], position[2], sizes[0], sizes[1] };
+    }
+
+    if (!file) {
+
+        throw std::runtime_error("Truncated tile pyramid " + file_name);
+    }
+
+    return pyramid;
+}
+
+// Bins nodes by z-index and tile, and connections by their z-index and the tiles of both endpoints on that
+// level, then writes every non-empty tile to <directory>/<level>/<x>_<y>.bin and the manifest to <directory>/pyramid.bin.
+// Entries are grouped with a parallel sort on packed (level, x, y) keys and tiles are written in parallel.
+template <
+    template <typename> typename TAllocator,
+    typename TId,
+    typename TConnectionWeight,
+    typename TCoordinates,
+    typename TZIndex,
+    typename... TNodeFeatures>
+TilePyramid export_tiles(
+    const ograph::BasicOGraph<TAllocator, TId, TConnectionWeight, TCoordinates, TZIndex, TNodeFeatures...>& graph,
+    std::string directory,
+    size_t thread_count = 0)
+{
+
+    auto& nodes = graph.m_nodes;
+    auto& connections = graph.m_connections;
+    size_t node_count = graph.node_count();
+    size_t connection_count = connections.m_from.size();
+
+    if (nodes.m_y_coordinates.size() != node_count || nodes.m_z_index.size() != node_count || connections.m_z_index.size() != connection_count) {
+
+        throw std::invalid_argument("export_tiles needs coordinates and z-indices of every node and connection");
+    }
+
+    double min_x = 0;
+    double min_y = 0;
+    double size = 1;
+    uint32_t level_count = 0;
+
+    if (node_count > 0) {
+
+        auto [min_x_coordinate, max_x_coordinate] = std::minmax_element(nodes.m_x_coordinates.begin(), nodes.m_x_coordinates.end());
+        auto [min_y_coordinate, max_y_coordinate] = std::minmax_element(nodes.m_y_coordinates.begin(), nodes.m_y_coordinates.end());
+
+        min_x = double(*min_x_coordinate);
+        min_y = double(*min_y_coordinate);
+        size = std::max(double(*max_x_coordinate) - min_x, double(*max_y_coordinate) - min_y);
+        size = size > 0 ? size * (1 + 1e-9) : 1;
+        level_count = uint32_t(*std::max_element(nodes.m_z_index.begin(), nodes.m_z_index.end())) + 1;
+    }
+
+    if (connection_count > 0) {
+
+        level_count = std::max(level_count, uint32_t(*std::max_element(connections.m_z_index.begin(), connections.m_z_index.end())) + 1);
+    }
+
+    TilePyramid pyramid(min_x, min_y, size, level_count);
+
+    auto tile_key = [&](uint32_t level, size_t node) {
+        auto [x, y] = pyramid.tile_of(level, double(nodes.m_x_coordinates[node]), double(nodes.m_y_coordinates[node]));
+        return (uint64_t(level) << 48) | (uint64_t(x) << 24) | uint64_t(y);
+    };
+
+    std::vector<std::tuple<uint64_t, uint32_t>> node_entries(node_count);
+    std::vector<std::tuple<uint64_t, uint32_t>> connection_entries(2 * connection_count);
+
+    parallel::parallel_for(
+        0, node_count,
+        [&](size_t i) {
+            node_entries[i] = std::make_tuple(tile_key(uint32_t(nodes.m_z_index[i]), i), uint32_t(i));
+        },
+        thread_count, 4096);
+
+    // A connection crossing tiles is stored in both, one within a tile once; duplicates get the key NO_TILE
+    constexpr uint64_t NO_TILE = ~uint64_t(0);
+
+    parallel::parallel_for(
+        0, connection_count,
+        [&](size_t i) {
+            uint32_t level = uint32_t(connections.m_z_index[i]);
+            uint64_t from_key = tile_key(level, connections.m_from[i]);
+            uint64_t to_key = tile_key(level, connections.m_to[i]);
+
+            connection_entries[2 * i] = std::make_tuple(from_key, uint32_t(i));
+            connection_entries[2 * i + 1] = std::make_tuple(to_key == from_key ? NO_TILE : to_key, uint32_t(i));
+        },
+        thread_count, 4096);
+
+    auto by_key = [](auto& a, auto& b) { return std::get<0>(a) < std::get<0>(b); };
+
+    parallel::parallel_sort(node_entries.begin(), node_entries.end(), by_key, thread_count);
+    parallel::parallel_sort(connection_entries.begin(), connection_entries.end(), by_key, thread_count);
+
+    while (!connection_entries.empty() && std::get<0>(connection_entries.back()) == NO_TILE) {
+
+        connection_entries.pop_back();
+    }
+
+    // Tiles as (key, node range, connection range) over both sorted entry lists
+    std::vector<std::tuple<uint64_t, size_t, size_t, size_t, size_t>> tiles;
+    size_t node_position = 0;
+    size_t connection_position = 0;
+
+    while (node_position < node_entries.size() || connection_position < connection_entries.size()) {
+
+        uint64_t key = std::min(node_position < node_entries.size() ? std::get<0>(node_entries[node_position]) : NO_TILE,
+            connection_position < connection_entries.size() ? std::get<0>(connection_entries[connection_position]) : NO_TILE);
+
+        size_t node_begin = node_position;
+        size_t connection_begin = connection_position;
+
+        while (node_position < node_entries.size() && std::get<0>(node_entries[node_position]) == key) {
+
+            node_position++;
+        }
+
+        while (connection_position < connection_entries.size() && std::get<0>(connection_entries[connection_position]) == key) {
+
+            connection_position++;
+        }
+
+        tiles.emplace_back(key, node_begin, node_position, connection_begin, connection_position);
+    }
+
+    pyramid.m_tiles.resize(tiles.size());
+
+    for (uint32_t level = 0; level < level_count; level++) {
+
+        std::filesystem::create_directories(std::filesystem::path(directory) / std::to_string(level));
+    }
+
+    parallel::parallel_for(
+        0, tiles.size(),
+        [&](size_t t) {
+            auto [key, node_begin, node_end, connection_begin, connection_end] = tiles[t];
+
+            Tile<TId, TConnectionWeight, TCoordinates> tile;
+            tile.m_level = uint32_t(key >> 48);
+            tile.m_x = uint32_t(key >> 24) & 0xffffffu;
+            tile.m_y = uint32_t(key) & 0xffffffu;
+
+            for (size_t q = node_begin; q < node_end; q++) {
+
+                uint32_t node = std::get<1>(node_entries[q]);
+
+                tile.m_node_ids.push_back(TId(node));
+                tile.m_x_coordinates.push_back(nodes.m_x_coordinates[node]);
+                tile.m_y_coordinates.push_back(nodes.m_y_coordinates[node]);
+            }
+
+            for (size_t q = connection_begin; q < connection_end; q++) {
+
+                uint32_t connection = std::get<1>(connection_entries[q]);
+                TId from = connections.m_from[connection];
+                TId to = connections.m_to[connection];
+
+                tile.m_from.push_back(from);
+                tile.m_to.push_back(to);
+                tile.m_values.push_back(connections.m_values[connection]);
+                tile.m_from_x.push_back(nodes.m_x_coordinates[from]);
+                tile.m_from_y.push_back(nodes.m_y_coordinates[from]);
+                tile.m_to_x.push_back(nodes.m_x_coordinates[to]);
+                tile.m_to_y.push_back(nodes.m_y_coordinates[to]);
+            }
+
+            write_tile(tile, (std::filesystem::path(directory) / TilePyramid::tile_path(tile.m_level, tile.m_x, tile.m_y)).string());
+
+            pyramid.m_tiles[t] = TileInfo { tile.m_level, tile.m_x, tile.m_y, node_end - node_begin, connection_end - connection_begin };
+        },
+        thread_count);
+
+    write_tile_pyramid(pyramid, (std::filesystem::path(directory) / "pyramid.bin").string());
+
+    return pyramid;
+}
+}
+
+#endif
@@ -0,0 +1,117 @@
+#ifndef Z_INDEX_HPP_
+#define Z_INDEX_HPP_
+
+#include <algorithm>
+#include <limits>
+#include <numeric>
+#include <span>
+#include <stdexcept>
+#include <vector>
+
+#include <ginv/clustering/community_labels.hpp>
+#include <ginv/parallel/parallel_for.hpp>
+#include <ginv/parallel/parallel_sort.hpp>
+#include <osigma/ograph.hpp>
+
+namespace layout {
+
+// Level of every node by decreasing importance: the first `first_level_size` nodes get level 0 and
+// every next level holds four times as many as the previous one, matching the tile count of a quadtree
+// pyramid. Level 0 is shown first; the last level takes all remaining nodes. Equal importance keeps node order.
+template <typename TZIndex, typename TQ>
+std::vector<TZIndex> assign_z_levels(std::span<const TQ> importance, size_t level_count, size_t first_level_size = 256, size_t thread_count = 0)
+{
+
+    if (level_count == 0 || level_count - 1 > size_t(std::numeric_limits<TZIndex>::max()) || first_level_size == 0) {
+
+        throw std::invalid_argument("assign_z_levels needs between 1 and " + std::to_string(size_t(std::numeric_limits<TZIndex>::max()) + 1)
+            + " levels and a non-empty first level");
+    }
+
+    size_t node_count = importance.size();
+    std::vector<uint32_t> order(node_count);
+    std::iota(order.begin(), order.end(), uint32_t(0));
+
+    parallel::parallel_sort(
+        order.begin(), order.end(), [&](uint32_t a, uint32_t b) { return importance[a] > importance[b]; }, thread_count);
+
+    std::vector<size_t> level_ends(level_count, node_count);
+    size_t level_end = 0;
+    size_t level_size = first_level_size;
+
+    for (size_t level = 0; level + 1 < level_count && level_end < node_count; level++) {
+
+        level_end = std::min(node_count, level_end + level_size);
+        level_ends[level] = level_end;
+        level_size = level_size > node_count ? level_size : 4 * level_size;
+    }
+
+    std::vector<TZIndex> levels(node_count);
+
+    parallel::parallel_for(
+        0, node_count,
+        [&](size_t rank) {
+            levels[order[rank]] = TZIndex(std::upper_bound(level_ends.begin(), level_ends.end(), rank) - level_ends.begin());
+        },
+        thread_count, 4096);
+
+    return levels;
+}
+
+// Importance of a node as the size of its community, so whole large communities surface first
+template <typename TId>
+std::vector<double> community_size_importance(const clustering::CommunityLabels<TId>& labels)
+{
+
+    std::vector<double> importance(labels.node_count(), 0.0);
+
+    for (size_t i = 0; i < importance.size(); i++) {
+
+        if (labels.m_labels[i] != clustering::CommunityLabels<TId>::NO_COMMUNITY) {
+
+            importance[i] = double(labels.community_size(labels.m_labels[i]));
+        }
+    }
+
+    return importance;
+}
+
+// Writes node levels into the node z-index and gives every connection the level of its later endpoint,
+// so a connection appears together with both of its nodes
+template <
+    typename TQ,
+    template <typename> typename TAllocator,
+    typename TId,
+    typename TConnectionWeight,
+    typename TCoordinates,
+    typename TZIndex,
+    typename... TNodeFeatures>
+void assign_z_index(
+    ograph::BasicOGraph<TAllocator, TId, TConnectionWeight, TCoordinates, TZIndex, TNodeFeatures...>& graph,
+    std::span<const TQ> importance,
+    size_t level_count,
+    size_t first_level_size = 256,
+    size_t thread_count = 0)
+{
+
+    if (importance.size() != graph.node_count()) {
+
+        throw std::invalid_argument("assign_z_index needs one importance value per node");
+    }
+
+    auto levels = assign_z_levels<TZIndex>(importance, level_count, first_level_size, thread_count);
+    auto& connections = graph.m_connections;
+
+    graph.m_nodes.m_z_index.assign(levels.begin(), levels.end());
+    connections.m_z_index.resize(connections.m_from.size());
+
+    parallel::parallel_for(
+        0, connections.m_from.size(),
+        [&](size_t i) {
+            connections.m_z_index[i] = std::max(levels[connections.m_from[i]], levels[connections.m_to[i]]);
+        },
+        thread_count, 4096);
+}
+}
+
+#endif
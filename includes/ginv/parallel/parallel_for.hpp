@@ -0,0 +1,109 @@
+#ifndef PARALLEL_FOR_HPP_
+#define PARALLEL_FOR_HPP_
+
+#include <algorithm>
+#include <exception>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace parallel {
+
+inline size_t resolve_thread_count(size_t thread_count)
+{
+
+    if (thread_count > 0) {
+
+        return thread_count;
+    }
+
+    size_t hardware_threads = std::thread::hardware_concurrency();
+
+    return hardware_threads > 0 ? hardware_threads : 1;
+}
+
+// Splits [begin, end) into one contiguous range per thread and calls
+// function(range_begin, range_end, thread_id) for each of them.
+template <typename TFunction>
+void parallel_for_ranges(size_t begin, size_t end, TFunction function, size_t thread_count = 0, size_t min_range_size = 1)
+{
+
+    if (end <= begin) {
+
+        return;
+    }
+
+    size_t count = end - begin;
+    size_t threads = std::min(resolve_thread_count(thread_count), (count + min_range_size - 1) / std::max<size_t>(min_range_size, 1));
+
+    if (threads <= 1) {
+
+        function(begin, end, size_t(0));
+        return;
+    }
+
+    size_t range_size = (count + threads - 1) / threads;
+
+    std::vector<std::thread> workers;
+    workers.reserve(threads - 1);
+
+    std::exception_ptr exception;
+    std::mutex exception_mutex;
+
+    auto run_range = [&](size_t thread_id) {
+        size_t range_begin = begin + thread_id * range_size;
+        size_t range_end = std::min(end, range_begin + range_size);
+
+        if (range_begin >= range_end) {
+
+            return;
+        }
+
+        try {
+
+            function(range_begin, range_end, thread_id);
+        } catch (...) {
+
+            std::lock_guard<std::mutex> lock(exception_mutex);
+
+            if (!exception) {
+
+                exception = std::current_exception();
+            }
+        }
+    };
+
+    for (size_t t = 1; t < threads; t++) {
+
+        workers.emplace_back(run_range, t);
+    }
+
+    run_range(0);
+
+    for (auto& worker : workers) {
+
+        worker.join();
+    }
+
+    if (exception) {
+
+        std::rethrow_exception(exception);
+    }
+}
+
+template <typename TFunction>
+void parallel_for(size_t begin, size_t end, TFunction function, size_t thread_count = 0, size_t min_range_size = 1)
+{
+
+    parallel_for_ranges(
+        begin, end, [&](size_t range_begin, size_t range_end, size_t) {
+            for (size_t i = range_begin; i < range_end; i++) {
+
+                function(i);
+            }
+        },
+        thread_count, min_range_size);
+}
+}
+
+#endif
@@ -0,0 +1,177 @@
+#ifndef PARALLEL_SORT_HPP_
+#define PARALLEL_SORT_HPP_
+
+#include <algorithm>
+#include <cstdint>
+#include <functional>
+#include <iterator>
+#include <span>
+#include <vector>
+
+#include <ginv/parallel/parallel_for.hpp>
+
+namespace parallel {
+
+// Stable sort: every thread stable-sorts one contiguous run, then neighbouring runs are merged pairwise in parallel rounds
+template <typename TIterator, typename TCompare = std::less<>>
+void parallel_sort(TIterator begin, TIterator end, TCompare compare = TCompare(), size_t thread_count = 0, size_t min_range_size = 1 << 14)
+{
+
+    size_t count = std::distance(begin, end);
+    std::vector<size_t> run_begins(resolve_thread_count(thread_count) + 1, count);
+
+    parallel_for_ranges(
+        0, count,
+        [&](size_t range_begin, size_t range_end, size_t thread_id) {
+            run_begins[thread_id] = range_begin;
+            std::stable_sort(begin + range_begin, begin + range_end, compare);
+        },
+        thread_count, min_range_size);
+
+    run_begins.erase(std::unique(run_begins.begin(), run_begins.end()), run_begins.end());
+
+    if (run_begins.back() != count) {
+
+        run_begins.push_back(count);
+    }
+
+    while (run_begins.size() > 2) {
+
+        size_t pair_count = (run_begins.size() - 1) / 2;
+
+        parallel_for(
+            0, pair_count,
+            [&](size_t pair) {
+                std::inplace_merge(begin + run_begins[2 * pair], begin + run_begins[2 * pair + 1], begin + run_begins[2 * pair + 2], compare);
+            },
+            thread_count);
+
+        std::vector<size_t> merged_run_begins;
+
+        for (size_t i = 0; i < run_begins.size(); i += 2) {
+
+            merged_run_begins.push_back(run_begins[i]);
+        }
+
+        if (merged_run_begins.back() != count) {
+
+            merged_run_begins.push_back(count);
+        }
+
+        run_begins.swap(merged_run_begins);
+    }
+}
+
+// Stable LSD radix sort of 64-bit keys that moves the payloads along. Every pass counts the byte digits per chunk,
+// then each chunk scatters into its own slice of every bucket; bytes that are equal in all keys are skipped.
+template <typename TPayload>
+void parallel_radix_sort(std::span<uint64_t> keys, std::span<TPayload> payloads, size_t thread_count = 0, size_t min_range_size = 1 << 14)
+{
+
+    constexpr size_t DIGIT_BITS = 8;
+    constexpr size_t BUCKET_COUNT = size_t(1) << DIGIT_BITS;
+
+    size_t count = keys.size();
+
+    if (count < 2) {
+
+        return;
+    }
+
+    size_t chunk_count = std::clamp<size_t>(count / std::max<size_t>(min_range_size, 1), 1, resolve_thread_count(thread_count));
+    auto chunk_begin = [&](size_t chunk) { return count * chunk / chunk_count; };
+
+    std::vector<uint64_t> differing_bits(chunk_count, 0);
+
+    parallel_for(
+        0, chunk_count,
+        [&](size_t chunk) {
+            for (size_t i = chunk_begin(chunk); i < chunk_begin(chunk + 1); i++) {
+
+                differing_bits[chunk] |= keys[i] ^ keys[0];
+            }
+        },
+        thread_count);
+
+    uint64_t differing = 0;
+
+    for (uint64_t bits : differing_bits) {
+
+        differing |= bits;
+    }
+
+    std::vector<uint64_t> key_buffer(count);
+    std::vector<TPayload> payload_buffer(count);
+    std::span<uint64_t> source_keys = keys;
+    std::span<TPayload> source_payloads = payloads;
+    std::span<uint64_t> target_keys(key_buffer);
+    std::span<TPayload> target_payloads(payload_buffer);
+    std::vector<size_t> offsets(chunk_count * BUCKET_COUNT);
+
+    for (size_t shift = 0; shift < 64; shift += DIGIT_BITS) {
+
+        if (((differing >> shift) & (BUCKET_COUNT - 1)) == 0) {
+
+            continue;
+        }
+
+        std::fill(offsets.begin(), offsets.end(), 0);
+
+        parallel_for(
+            0, chunk_count,
+            [&](size_t chunk) {
+                size_t* histogram = offsets.data() + chunk * BUCKET_COUNT;
+
+                for (size_t i = chunk_begin(chunk); i < chunk_begin(chunk + 1); i++) {
+
+                    histogram[(source_keys[i] >> shift) & (BUCKET_COUNT - 1)]++;
+                }
+            },
+            thread_count);
+
+        size_t position = 0;
+
+        for (size_t digit = 0; digit < BUCKET_COUNT; digit++) {
+
+            for (size_t chunk = 0; chunk < chunk_count; chunk++) {
+
+                size_t digit_count = offsets[chunk * BUCKET_COUNT + digit];
+
+                offsets[chunk * BUCKET_COUNT + digit] = position;
+                position += digit_count;
+            }
+        }
+
+        parallel_for(
+            0, chunk_count,
+            [&](size_t chunk) {
+                size_t* cursors = offsets.data() + chunk * BUCKET_COUNT;
+
+                for (size_t i = chunk_begin(chunk); i < chunk_begin(chunk + 1); i++) {
+
+                    size_t target = cursors[(source_keys[i] >> shift) & (BUCKET_COUNT - 1)]++;
+
+                    target_keys[target] = source_keys[i];
+                    target_payloads[target] = std::move(source_payloads[i]);
+                }
+            },
+            thread_count);
+
+        std::swap(source_keys, target_keys);
+        std::swap(source_payloads, target_payloads);
+    }
+
+    if (source_keys.data() != keys.data()) {
+
+        parallel_for(
+            0, chunk_count,
+            [&](size_t chunk) {
+                std::copy(source_keys.begin() + chunk_begin(chunk), source_keys.begin() + chunk_begin(chunk + 1), keys.begin() + chunk_begin(chunk));
+                std::move(source_payloads.begin() + chunk_begin(chunk), source_payloads.begin() + chunk_begin(chunk + 1), payloads.begin() + chunk_begin(chunk));
+            },
+            thread_count);
+    }
+}
+}
+
+#endif
@@ -0,0 +1,117 @@
+#ifndef THREAD_POOL_HPP_
+#define THREAD_POOL_HPP_
+
+#include <condition_variable>
+#include <functional>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <queue>
+#include <string>
+#include <thread>
+#include <type_traits>
+#include <vector>
+
+#include <ginv/parallel/parallel_for.hpp>
+
+namespace parallel {
+
+class ThreadPool {
+
+public:
+    explicit ThreadPool(size_t thread_count = 0)
+    {
+
+        size_t threads = resolve_thread_count(thread_count);
+        m_workers.reserve(threads);
+
+        for (size_t i = 0; i < threads; i++) {
+
+            m_workers.emplace_back([this]() { work(); });
+        }
+    }
+
+    ThreadPool(const ThreadPool&) = delete;
+    ThreadPool& operator=(const ThreadPool&) = delete;
+
+    ~ThreadPool()
+    {
+
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            m_stopping = true;
+        }
+
+        m_condition.notify_all();
+
+        for (auto& worker : m_workers) {
+
+            worker.join();
+        }
+    }
+
+    template <typename TFunction>
+    std::future<std::invoke_result_t<TFunction>> submit(TFunction function)
+    {
+
+        typedef std::invoke_result_t<TFunction> TResult;
+
+        auto task = std::make_shared<std::packaged_task<TResult()>>(std::move(function));
+        std::future<TResult> result = task->get_future();
+
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            m_tasks.emplace([task]() { (*task)(); });
+        }
+
+        m_condition.notify_one();
+
+        return result;
+    }
+
+    size_t thread_count() const
+    {
+
+        return m_workers.size();
+    }
+
+    std::string describe() const
+    {
+
+        return "ThreadPool(" + std::to_string(m_workers.size()) + " threads)";
+    }
+
+private:
+    std::vector<std::thread> m_workers;
+    std::queue<std::function<void()>> m_tasks;
+    std::mutex m_mutex;
+    std::condition_variable m_condition;
+    bool m_stopping = false;
+
+    void work()
+    {
+
+        while (true) {
+
+            std::function<void()> task;
+
+            {
+                std::unique_lock<std::mutex> lock(m_mutex);
+                m_condition.wait(lock, [this]() { return m_stopping || !m_tasks.empty(); });
+
+                if (m_stopping && m_tasks.empty()) {
+
+                    return;
+                }
+
+                task = std::move(m_tasks.front());
+                m_tasks.pop();
+            }
+
+            task();
+        }
+    }
+};
+}
+
+#endif
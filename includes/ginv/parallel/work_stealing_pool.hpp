@@ -0,0 +1,243 @@
+#ifndef WORK_STEALING_POOL_HPP_
+#define WORK_STEALING_POOL_HPP_
+
+#include <chrono>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <type_traits>
+#include <vector>
+
+#include <ginv/parallel/parallel_for.hpp>
+
+namespace parallel {
+
+// Every worker owns a task deque: tasks submitted from a worker go to the back of its own deque and are
+// run newest first, tasks submitted from other threads go to a shared queue, and idle workers steal the
+// oldest tasks of the others. wait() runs pending tasks while a future is not ready, so tasks may wait
+// for the tasks they submit without blocking a worker; with nothing left to run it blocks instead of spinning.
+class WorkStealingPool {
+
+public:
+    static constexpr std::chrono::microseconds WORKER_WAIT_INTERVAL = std::chrono::microseconds(200);
+
+    explicit WorkStealingPool(size_t thread_count = 0)
+    {
+
+        size_t threads = resolve_thread_count(thread_count);
+
+        for (size_t i = 0; i <= threads; i++) {
+
+            m_queues.push_back(std::make_unique<TaskQueue>());
+        }
+
+        m_workers.reserve(threads);
+
+        for (size_t i = 0; i < threads; i++) {
+
+            m_workers.emplace_back([this, i]() { work(i); });
+        }
+    }
+
+    WorkStealingPool(const WorkStealingPool&) = delete;
+    WorkStealingPool& operator=(const WorkStealingPool&) = delete;
+
+    // Runs the remaining tasks before joining the workers
+    ~WorkStealingPool()
+    {
+
+        {
+            std::lock_guard<std::mutex> lock(m_sleep_mutex);
+            m_stopping = true;
+        }
+
+        m_condition.notify_all();
+
+        for (auto& worker : m_workers) {
+
+            worker.join();
+        }
+    }
+
+    template <typename TFunction>
+    std::future<std::invoke_result_t<TFunction>> submit(TFunction function)
+    {
+
+        typedef std::invoke_result_t<TFunction> TResult;
+
+        auto task = std::make_shared<std::packaged_task<TResult()>>(std::move(function));
+        std::future<TResult> result = task->get_future();
+
+        {
+            std::lock_guard<std::mutex> lock(m_sleep_mutex);
+            m_pending++;
+        }
+
+        TaskQueue& queue = *m_queues[s_current_pool == this ? s_current_worker : m_workers.size()];
+
+        {
+            std::lock_guard<std::mutex> lock(queue.m_mutex);
+            queue.m_tasks.emplace_back([task]() { (*task)(); });
+        }
+
+        m_condition.notify_one();
+
+        return result;
+    }
+
+    // Runs one pending task on the calling thread; returns false when there was none
+    bool run_pending_task()
+    {
+
+        size_t own_queue = s_current_pool == this ? s_current_worker : m_workers.size();
+        std::function<void()> task;
+
+        if (!take_task(own_queue, task)) {
+
+            return false;
+        }
+
+        task();
+        return true;
+    }
+
+    template <typename TResult>
+    TResult wait(std::future<TResult>& future)
+    {
+
+        while (future.wait_for(std::chrono::seconds(0)) != std::future_status::ready) {
+
+            if (run_pending_task()) {
+
+                continue;
+            }
+
+            // Nothing to run: threads outside the pool block until the task is done, workers sleep briefly
+            // and then look again for tasks that the awaited one may have submitted
+            if (s_current_pool != this) {
+
+                future.wait();
+            } else {
+
+                future.wait_for(WORKER_WAIT_INTERVAL);
+            }
+        }
+
+        return future.get();
+    }
+
+    size_t thread_count() const
+    {
+
+        return m_workers.size();
+    }
+
+    std::string describe() const
+    {
+
+        return "WorkStealingPool(" + std::to_string(m_workers.size()) + " threads)";
+    }
+
+private:
+    class TaskQueue {
+
+    public:
+        std::mutex m_mutex;
+        std::deque<std::function<void()>> m_tasks;
+    };
+
+    // The last queue is the shared one of threads outside the pool
+    std::vector<std::unique_ptr<TaskQueue>> m_queues;
+    std::vector<std::thread> m_workers;
+    std::mutex m_sleep_mutex;
+    std::condition_variable m_condition;
+    size_t m_pending = 0;
+    bool m_stopping = false;
+
+    inline static thread_local const WorkStealingPool* s_current_pool = nullptr;
+    inline static thread_local size_t s_current_worker = 0;
+
+    bool pop(size_t queue_id, bool newest, std::function<void()>& task)
+    {
+
+        TaskQueue& queue = *m_queues[queue_id];
+        std::lock_guard<std::mutex> lock(queue.m_mutex);
+
+        if (queue.m_tasks.empty()) {
+
+            return false;
+        }
+
+        if (newest) {
+
+            task = std::move(queue.m_tasks.back());
+            queue.m_tasks.pop_back();
+        } else {
+
+            task = std::move(queue.m_tasks.front());
+            queue.m_tasks.pop_front();
+        }
+
+        return true;
+    }
+
+    bool take_task(size_t own_queue, std::function<void()>& task)
+    {
+
+        size_t queue_count = m_queues.size();
+        bool found = pop(own_queue, own_queue < m_workers.size(), task);
+
+        for (size_t offset = 1; !found && offset < queue_count; offset++) {
+
+            found = pop((own_queue + offset) % queue_count, false, task);
+        }
+
+        if (found) {
+
+            std::lock_guard<std::mutex> lock(m_sleep_mutex);
+            m_pending--;
+        }
+
+        return found;
+    }
+
+    void work(size_t worker)
+    {
+
+        s_current_pool = this;
+        s_current_worker = worker;
+
+        while (true) {
+
+            if (run_pending_task()) {
+
+                continue;
+            }
+
+            std::unique_lock<std::mutex> lock(m_sleep_mutex);
+            m_condition.wait(lock, [this]() { return m_stopping || m_pending > 0; });
+
+            if (m_stopping && m_pending == 0) {
+
+                return;
+            }
+        }
+    }
+};
+
+// Pool shared by the asynchronous entry points of the library; the thread count of the first call sizes it
+inline WorkStealingPool& default_work_stealing_pool(size_t thread_count = 0)
+{
+
+    static WorkStealingPool pool(thread_count);
+
+    return pool;
+}
+}
+
+#endif
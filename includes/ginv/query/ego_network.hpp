@@ -0,0 +1,263 @@
+#ifndef EGO_NETWORK_HPP_
+#define EGO_NETWORK_HPP_
+
+#include <algorithm>
+#include <atomic>
+#include <bit>
+#include <cstdint>
+#include <limits>
+#include <stdexcept>
+#include <string>
+#include <tuple>
+#include <vector>
+
+#include <ginv/parallel/parallel_for.hpp>
+#include <ginv/query/induced_subgraph.hpp>
+#include <ginv/query/predicate_scan.hpp>
+#include <osigma/oconnection_index.hpp>
+#include <osigma/ograph.hpp>
+
+namespace query {
+
+// Nodes within k hops of `node`, at most max_nodes of them; the last hop keeps its lowest ids when it overflows.
+// The node itself always counts as the first one, so max_nodes 0 selects nothing.
+// Direction-optimizing BFS (Beamer et al. 2012) over bitmap frontiers: hops expand top-down from the frontier
+// until its connections outweigh the unexplored ones, then bottom-up from the unvisited nodes until the frontier
+// shrinks again. Bottom-up steps need a symmetric (Both) index, other indices only expand top-down.
+template <typename TId, typename TValue>
+SelectionBitmap k_hop_neighbourhood(
+    const ograph::OConnectionIndex<TId, TValue>& index,
+    size_t node,
+    size_t k,
+    size_t max_nodes = std::numeric_limits<size_t>::max(),
+    size_t thread_count = 0)
+{
+
+    constexpr size_t TOP_DOWN_EDGE_RATIO = 14;
+    constexpr size_t BOTTOM_UP_NODE_RATIO = 24;
+
+    size_t node_count = index.node_count();
+
+    if (node >= node_count) {
+
+        throw std::out_of_range("Node " + std::to_string(node) + " is out of the node range");
+    }
+
+    SelectionBitmap visited(node_count);
+    SelectionBitmap frontier(node_count);
+    size_t word_count = visited.m_words.size();
+
+    if (max_nodes == 0) {
+
+        return visited;
+    }
+
+    visited.set(node);
+    frontier.set(node);
+
+    size_t visited_count = 1;
+    size_t frontier_count = 1;
+    size_t frontier_edges = index.degree(node);
+    size_t unexplored_edges = index.m_neighbours.size() - frontier_edges;
+    bool bottom_up = false;
+
+    for (size_t hop = 0; hop < k && frontier_count > 0 && visited_count < max_nodes; hop++) {
+
+        if (index.m_direction == ograph::ConnectionDirection::Both) {
+
+            bottom_up = bottom_up ? frontier_count * BOTTOM_UP_NODE_RATIO >= node_count
+                                  : frontier_edges * TOP_DOWN_EDGE_RATIO > unexplored_edges;
+        }
+
+        SelectionBitmap next(node_count);
+
+        if (bottom_up) {
+
+            // Every range owns its words of the next frontier
+            parallel::parallel_for_ranges(
+                0, word_count,
+                [&](size_t begin, size_t end, size_t) {
+                    for (size_t w = begin; w < end; w++) {
+
+                        uint64_t found = 0;
+
+                        for (uint64_t unvisited = ~visited.m_words[w]; unvisited != 0; unvisited &= unvisited - 1) {
+
+                            size_t v = (w << 6) + std::countr_zero(unvisited);
+
+                            if (v >= node_count) {
+
+                                break;
+                            }
+
+                            for (TId u : index.neighbours(v)) {
+
+                                if (frontier.test(u)) {
+
+                                    found |= uint64_t(1) << (v & 63);
+                                    break;
+                                }
+                            }
+                        }
+
+                        next.m_words[w] = found;
+                    }
+                },
+                thread_count, 1024);
+        } else {
+
+            parallel::parallel_for_ranges(
+                0, word_count,
+                [&](size_t begin, size_t end, size_t) {
+                    for (size_t w = begin; w < end; w++) {
+
+                        for (uint64_t word = frontier.m_words[w]; word != 0; word &= word - 1) {
+
+                            size_t v = (w << 6) + std::countr_zero(word);
+
+                            for (TId u : index.neighbours(v)) {
+
+                                if (!visited.test(u)) {
+
+                                    std::atomic_ref<uint64_t>(next.m_words[size_t(u) >> 6]).fetch_or(uint64_t(1) << (size_t(u) & 63), std::memory_order_relaxed);
+                                }
+                            }
+                        }
+                    }
+                },
+                thread_count, 1024);
+        }
+
+        size_t next_count = next.count();
+
+        if (visited_count + next_count > max_nodes) {
+
+            size_t remaining = max_nodes - visited_count;
+
+            for (auto& word : next.m_words) {
+
+                while (size_t(std::popcount(word)) > remaining) {
+
+                    word &= ~(uint64_t(1) << (63 - std::countl_zero(word)));
+                }
+
+                remaining -= std::popcount(word);
+            }
+
+            next_count = max_nodes - visited_count;
+        }
+
+        visited |= next;
+        visited_count += next_count;
+        frontier = std::move(next);
+        frontier_count = next_count;
+        frontier_edges = 0;
+
+        frontier.for_each_selected([&](size_t v) { frontier_edges += index.degree(v); });
+
+        unexplored_edges -= std::min(unexplored_edges, frontier_edges);
+    }
+
+    return visited;
+}
+
+// The k-hop ego network of `node` as an induced subgraph with all node features; returns it with the
+// original ids of its nodes like induced_subgraph. Takes a connection id index of the graph
+// (create_connection_id_index) so only the connections of the neighbourhood are visited.
+template <
+    template <typename> typename TAllocator,
+    typename TId,
+    typename TConnectionWeight,
+    typename TCoordinates,
+    typename TZIndex,
+    typename... TNodeFeatures>
+std::tuple<ograph::BasicOGraph<TAllocator, TId, TConnectionWeight, TCoordinates, TZIndex, TNodeFeatures...>, std::vector<TId>> ego_network(
+    const ograph::BasicOGraph<TAllocator, TId, TConnectionWeight, TCoordinates, TZIndex, TNodeFeatures...>& graph,
+    const ograph::OConnectionIndex<TId, uint32_t>& connection_id_index,
+    size_t node,
+    size_t k,
+    size_t max_nodes = std::numeric_limits<size_t>::max(),
+    size_t thread_count = 0)
+{
+
+    typedef ograph::BasicOSpatialNodes<TAllocator, TCoordinates, TZIndex, TNodeFeatures...> Nodes;
+    typedef ograph::BasicOSpatialConnections<TAllocator, TId, TConnectionWeight, TZIndex> Connections;
+
+    if (connection_id_index.node_count() != graph.node_count()) {
+
+        throw std::invalid_argument("Connection index does not match the graph");
+    }
+
+    SelectionBitmap visited = k_hop_neighbourhood(connection_id_index, node, k, max_nodes, thread_count);
+    std::vector<TId> original_ids = visited.template selected_ids<TId>();
+    std::vector<uint32_t> connection_ids;
+
+    for (TId v : original_ids) {
+
+        auto neighbours = connection_id_index.neighbours(v);
+        auto ids = connection_id_index.values(v);
+
+        for (size_t q = 0; q < neighbours.size(); q++) {
+
+            if (visited.test(neighbours[q])) {
+
+                connection_ids.push_back(ids[q]);
+            }
+        }
+    }
+
+    std::sort(connection_ids.begin(), connection_ids.end());
+    connection_ids.erase(std::unique(connection_ids.begin(), connection_ids.end()), connection_ids.end());
+
+    Nodes nodes = std::apply([&](auto&... features) {
+        return Nodes(
+            gather_column(graph.m_nodes.m_x_coordinates, original_ids, thread_count),
+            gather_column(graph.m_nodes.m_y_coordinates, original_ids, thread_count),
+            gather_column(graph.m_nodes.m_z_index, original_ids, thread_count),
+            gather_column(features, original_ids, thread_count)...);
+    },
+        graph.m_nodes.m_features);
+
+    auto from = gather_column(graph.m_connections.m_from, connection_ids, thread_count);
+    auto to = gather_column(graph.m_connections.m_to, connection_ids, thread_count);
+
+    // Renumbers by the rank among the sorted original ids, so no graph-sized id map is needed
+    parallel::parallel_for(
+        0, connection_ids.size(),
+        [&](size_t i) {
+            from[i] = TId(std::lower_bound(original_ids.begin(), original_ids.end(), from[i]) - original_ids.begin());
+            to[i] = TId(std::lower_bound(original_ids.begin(), original_ids.end(), to[i]) - original_ids.begin());
+        },
+        thread_count, 4096);
+
+    return std::make_tuple(
+        ograph::BasicOGraph<TAllocator, TId, TConnectionWeight, TCoordinates, TZIndex, TNodeFeatures...>(
+            std::move(nodes),
+            Connections(std::move(from), std::move(to), gather_column(graph.m_connections.m_values, connection_ids, thread_count),
+                gather_column(graph.m_connections.m_z_index, connection_ids, thread_count))),
+        std::move(original_ids));
+}
+
+// Builds the undirected connection id index first; keep the index around for repeated queries
+template <
+    template <typename> typename TAllocator,
+    typename TId,
+    typename TConnectionWeight,
+    typename TCoordinates,
+    typename TZIndex,
+    typename... TNodeFeatures>
+std::tuple<ograph::BasicOGraph<TAllocator, TId, TConnectionWeight, TCoordinates, TZIndex, TNodeFeatures...>, std::vector<TId>> ego_network(
+    const ograph::BasicOGraph<TAllocator, TId, TConnectionWeight, TCoordinates, TZIndex, TNodeFeatures...>& graph,
+    size_t node,
+    size_t k,
+    size_t max_nodes = std::numeric_limits<size_t>::max(),
+    size_t thread_count = 0)
+{
+
+    auto index = ograph::create_connection_id_index(graph.node_count(), graph.m_connections, ograph::ConnectionDirection::Both);
+
+    return ego_network(graph, index, node, k, max_nodes, thread_count);
+}
+}
+
+#endif
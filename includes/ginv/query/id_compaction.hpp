@@ -0,0 +1,213 @@
+#ifndef ID_COMPACTION_HPP_
+#define ID_COMPACTION_HPP_
+
+#include <atomic>
+#include <bit>
+#include <cstdint>
+#include <span>
+#include <stdexcept>
+#include <string>
+#include <tuple>
+#include <vector>
+
+#include <ginv/parallel/parallel_for.hpp>
+#include <ginv/query/induced_subgraph.hpp>
+#include <ginv/query/predicate_scan.hpp>
+#include <osigma/ograph.hpp>
+
+namespace query {
+
+// Map between a sparse set of active ids and the dense range 0..k. Dense ids keep the order of the
+// original ids, so algorithms that break ties by id behave the same on the compacted ids.
+template <typename TId>
+class IdCompaction {
+
+public:
+    SelectionBitmap m_active;
+    // Number of active ids before every bitmap word
+    std::vector<size_t> m_word_ranks;
+    std::vector<TId> m_original_ids;
+
+    explicit IdCompaction(SelectionBitmap active, size_t thread_count = 0)
+        : m_active(std::move(active))
+        , m_word_ranks(m_active.m_words.size() + 1, 0)
+    {
+
+        size_t word_count = m_active.m_words.size();
+
+        for (size_t w = 0; w < word_count; w++) {
+
+            m_word_ranks[w + 1] = m_word_ranks[w] + std::popcount(m_active.m_words[w]);
+        }
+
+        m_original_ids.resize(m_word_ranks.back());
+
+        parallel::parallel_for(
+            0, word_count,
+            [&](size_t w) {
+                size_t rank = m_word_ranks[w];
+
+                for (uint64_t word = m_active.m_words[w]; word != 0; word &= word - 1) {
+
+                    m_original_ids[rank++] = TId((w << 6) + std::countr_zero(word));
+                }
+            },
+            thread_count, 4096);
+    }
+
+    size_t id_space() const
+    {
+
+        return m_active.size();
+    }
+
+    size_t active_count() const
+    {
+
+        return m_original_ids.size();
+    }
+
+    bool is_active(size_t original_id) const
+    {
+
+        return original_id < m_active.size() && m_active.test(original_id);
+    }
+
+    TId dense_id(size_t original_id) const
+    {
+
+        if (!is_active(original_id)) {
+
+            throw std::out_of_range("Id " + std::to_string(original_id) + " is not active");
+        }
+
+        uint64_t below = m_active.m_words[original_id >> 6] & ((uint64_t(1) << (original_id & 63)) - 1);
+
+        return TId(m_word_ranks[original_id >> 6] + std::popcount(below));
+    }
+
+    TId original_id(size_t dense_id) const
+    {
+
+        return m_original_ids[dense_id];
+    }
+
+    // Translates ids of a result on the compacted graph, e.g. its communities, back to the original ids
+    std::vector<std::vector<TId>> to_original(std::vector<std::vector<TId>> groups) const
+    {
+
+        for (auto& group : groups) {
+
+            for (auto& id : group) {
+
+                id = m_original_ids[id];
+            }
+        }
+
+        return groups;
+    }
+
+    std::string describe() const
+    {
+
+        return "IdCompaction(" + std::to_string(active_count()) + " of " + std::to_string(id_space()) + " ids active)";
+    }
+};
+
+// Ids that appear in any of the connection columns
+template <typename TId>
+SelectionBitmap active_ids(size_t id_space, std::span<const TId> from_ids, std::span<const TId> to_ids, size_t thread_count = 0)
+{
+
+    SelectionBitmap active(id_space);
+
+    auto mark = [&](std::span<const TId> ids) {
+        parallel::parallel_for_ranges(
+            0, ids.size(),
+            [&](size_t begin, size_t end, size_t) {
+                for (size_t i = begin; i < end; i++) {
+
+                    size_t id = size_t(ids[i]);
+
+                    if (id >= id_space) {
+
+                        throw std::out_of_range("Connection node " + std::to_string(id) + " is out of the node range");
+                    }
+
+                    uint64_t bit = uint64_t(1) << (id & 63);
+                    std::atomic_ref<uint64_t> word(active.m_words[id >> 6]);
+
+                    // Most ids repeat, so a plain load avoids most of the atomic writes
+                    if ((word.load(std::memory_order_relaxed) & bit) == 0) {
+
+                        word.fetch_or(bit, std::memory_order_relaxed);
+                    }
+                }
+            },
+            thread_count, 65536);
+    };
+
+    mark(from_ids);
+    mark(to_ids);
+
+    return active;
+}
+
+// Remaps a column of active ids to their dense ids
+template <typename TColumn, typename TId>
+TColumn compact_id_column(const IdCompaction<TId>& compaction, const TColumn& column, size_t thread_count = 0)
+{
+
+    TColumn result(column.size());
+
+    parallel::parallel_for(
+        0, column.size(), [&](size_t i) { result[i] = compaction.dense_id(column[i]); }, thread_count, 4096);
+
+    return result;
+}
+
+// Keeps only the nodes with connections, renumbered densely with all their features, and returns the
+// compaction to translate results back to the ids of the whole graph
+template <
+    template <typename> typename TAllocator,
+    typename TId,
+    typename TConnectionWeight,
+    typename TCoordinates,
+    typename TZIndex,
+    typename... TNodeFeatures>
+std::tuple<ograph::BasicOGraph<TAllocator, TId, TConnectionWeight, TCoordinates, TZIndex, TNodeFeatures...>, IdCompaction<TId>> compact_graph(
+    const ograph::BasicOGraph<TAllocator, TId, TConnectionWeight, TCoordinates, TZIndex, TNodeFeatures...>& graph,
+    size_t thread_count = 0)
+{
+
+    typedef ograph::BasicOSpatialNodes<TAllocator, TCoordinates, TZIndex, TNodeFeatures...> Nodes;
+    typedef ograph::BasicOSpatialConnections<TAllocator, TId, TConnectionWeight, TZIndex> Connections;
+
+    IdCompaction<TId> compaction(
+        active_ids(graph.node_count(), std::span<const TId>(graph.m_connections.m_from), std::span<const TId>(graph.m_connections.m_to), thread_count),
+        thread_count);
+
+    auto& original_ids = compaction.m_original_ids;
+
+    Nodes nodes = std::apply([&](auto&... features) {
+        return Nodes(
+            gather_column(graph.m_nodes.m_x_coordinates, original_ids, thread_count),
+            gather_column(graph.m_nodes.m_y_coordinates, original_ids, thread_count),
+            gather_column(graph.m_nodes.m_z_index, original_ids, thread_count),
+            gather_column(features, original_ids, thread_count)...);
+    },
+        graph.m_nodes.m_features);
+
+    Connections connections(
+        compact_id_column(compaction, graph.m_connections.m_from, thread_count),
+        compact_id_column(compaction, graph.m_connections.m_to, thread_count),
+        graph.m_connections.m_values,
+        graph.m_connections.m_z_index);
+
+    return std::make_tuple(
+        ograph::BasicOGraph<TAllocator, TId, TConnectionWeight, TCoordinates, TZIndex, TNodeFeatures...>(std::move(nodes), std::move(connections)),
+        std::move(compaction));
+}
+}
+
+#endif
@@ -0,0 +1,133 @@
+#ifndef INDUCED_SUBGRAPH_HPP_
+#define INDUCED_SUBGRAPH_HPP_
+
+#include <stdexcept>
+#include <tuple>
+#include <vector>
+
+#include <ginv/parallel/parallel_for.hpp>
+#include <ginv/query/predicate_scan.hpp>
+#include <osigma/ograph.hpp>
+
+namespace query {
+
+template <typename TColumn, typename TId>
+TColumn gather_column(const TColumn& column, const std::vector<TId>& ids, size_t thread_count = 0)
+{
+
+    TColumn result(ids.size());
+
+    parallel::parallel_for(
+        0, ids.size(), [&](size_t i) { result[i] = column[ids[i]]; }, thread_count, 4096);
+
+    return result;
+}
+
+// Keeps the selected nodes and the connections between them, optionally only the selected connections.
+// Nodes are renumbered in increasing original id order; returns the subgraph and the original ids of its nodes.
+template <
+    template <typename> typename TAllocator,
+    typename TId,
+    typename TConnectionWeight,
+    typename TCoordinates,
+    typename TZIndex,
+    typename... TNodeFeatures>
+std::tuple<ograph::BasicOGraph<TAllocator, TId, TConnectionWeight, TCoordinates, TZIndex, TNodeFeatures...>, std::vector<TId>> induced_subgraph(
+    const ograph::BasicOGraph<TAllocator, TId, TConnectionWeight, TCoordinates, TZIndex, TNodeFeatures...>& graph,
+    const SelectionBitmap& node_selection,
+    const SelectionBitmap* connection_selection = nullptr,
+    size_t thread_count = 0)
+{
+
+    typedef ograph::BasicOSpatialNodes<TAllocator, TCoordinates, TZIndex, TNodeFeatures...> Nodes;
+    typedef ograph::BasicOSpatialConnections<TAllocator, TId, TConnectionWeight, TZIndex> Connections;
+
+    size_t node_count = graph.node_count();
+    size_t connection_count = graph.m_connections.m_from.size();
+
+    if (node_selection.size() != node_count) {
+
+        throw std::invalid_argument("Node selection size does not match the graph");
+    }
+
+    if (connection_selection != nullptr && connection_selection->size() != connection_count) {
+
+        throw std::invalid_argument("Connection selection size does not match the graph");
+    }
+
+    std::vector<TId> original_ids = node_selection.template selected_ids<TId>();
+    std::vector<TId> new_ids(node_count, TId(-1));
+
+    for (size_t i = 0; i < original_ids.size(); i++) {
+
+        new_ids[original_ids[i]] = TId(i);
+    }
+
+    Nodes nodes = std::apply([&](auto&... features) {
+        return Nodes(
+            gather_column(graph.m_nodes.m_x_coordinates, original_ids, thread_count),
+            gather_column(graph.m_nodes.m_y_coordinates, original_ids, thread_count),
+            gather_column(graph.m_nodes.m_z_index, original_ids, thread_count),
+            gather_column(features, original_ids, thread_count)...);
+    },
+        graph.m_nodes.m_features);
+
+    auto keeps = [&](size_t i) {
+        return node_selection.test(graph.m_connections.m_from[i]) && node_selection.test(graph.m_connections.m_to[i])
+            && (connection_selection == nullptr || connection_selection->test(i));
+    };
+
+    // Counts kept connections per range first, so that every range writes to its own part of the columns
+    std::vector<size_t> range_offsets(parallel::resolve_thread_count(thread_count) + 1, 0);
+
+    parallel::parallel_for_ranges(
+        0, connection_count,
+        [&](size_t begin, size_t end, size_t thread_id) {
+            size_t count = 0;
+
+            for (size_t i = begin; i < end; i++) {
+
+                count += keeps(i);
+            }
+
+            range_offsets[thread_id + 1] = count;
+        },
+        thread_count, 65536);
+
+    for (size_t t = 1; t < range_offsets.size(); t++) {
+
+        range_offsets[t] += range_offsets[t - 1];
+    }
+
+    typename Connections::template TColumn<TId> from(range_offsets.back());
+    typename Connections::template TColumn<TId> to(range_offsets.back());
+    typename Connections::template TColumn<TConnectionWeight> values(range_offsets.back());
+    typename Connections::template TColumn<TZIndex> z_index(range_offsets.back());
+
+    parallel::parallel_for_ranges(
+        0, connection_count,
+        [&](size_t begin, size_t end, size_t thread_id) {
+            size_t position = range_offsets[thread_id];
+
+            for (size_t i = begin; i < end; i++) {
+
+                if (keeps(i)) {
+
+                    from[position] = new_ids[graph.m_connections.m_from[i]];
+                    to[position] = new_ids[graph.m_connections.m_to[i]];
+                    values[position] = graph.m_connections.m_values[i];
+                    z_index[position] = graph.m_connections.m_z_index[i];
+                    position++;
+                }
+            }
+        },
+        thread_count, 65536);
+
+    return std::make_tuple(
+        ograph::BasicOGraph<TAllocator, TId, TConnectionWeight, TCoordinates, TZIndex, TNodeFeatures...>(
+            std::move(nodes), Connections(std::move(from), std::move(to), std::move(values), std::move(z_index))),
+        std::move(original_ids));
+}
+}
+
+#endif
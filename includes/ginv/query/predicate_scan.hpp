@@ -0,0 +1,562 @@
+#ifndef PREDICATE_SCAN_HPP_
+#define PREDICATE_SCAN_HPP_
+
+#include <algorithm>
+#include <bit>
+#include <cmath>
+#include <cstdint>
+#include <limits>
+#include <optional>
+#include <span>
+#include <stdexcept>
+#include <string>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include <ginv/parallel/parallel_for.hpp>
+
+#if defined(__AVX2__)
+#include <immintrin.h>
+#endif
+
+namespace query {
+
+// One bit per row, bit i % 64 of word i / 64; bits past the size are always zero
+class SelectionBitmap {
+
+public:
+    std::vector<uint64_t> m_words;
+    size_t m_size;
+
+    explicit SelectionBitmap(size_t size, bool selected = false)
+        : m_words((size + 63) / 64, selected ? ~uint64_t(0) : 0)
+        , m_size(size)
+    {
+
+        clear_tail();
+    }
+
+    size_t size() const
+    {
+
+        return m_size;
+    }
+
+    bool test(size_t i) const
+    {
+
+        return (m_words[i >> 6] >> (i & 63)) & 1;
+    }
+
+    void set(size_t i, bool selected = true)
+    {
+
+        uint64_t bit = uint64_t(1) << (i & 63);
+        m_words[i >> 6] = selected ? (m_words[i >> 6] | bit) : (m_words[i >> 6] & ~bit);
+    }
+
+    size_t count() const
+    {
+
+        size_t result = 0;
+
+        for (uint64_t word : m_words) {
+
+            result += std::popcount(word);
+        }
+
+        return result;
+    }
+
+    SelectionBitmap& operator&=(const SelectionBitmap& other)
+    {
+
+        for (size_t i = 0; i < m_words.size(); i++) {
+
+            m_words[i] &= other.m_words[i];
+        }
+
+        return *this;
+    }
+
+    SelectionBitmap& operator|=(const SelectionBitmap& other)
+    {
+
+        for (size_t i = 0; i < m_words.size(); i++) {
+
+            m_words[i] |= other.m_words[i];
+        }
+
+        return *this;
+    }
+
+    template <typename TFunction>
+    void for_each_selected(TFunction function) const
+    {
+
+        for (size_t w = 0; w < m_words.size(); w++) {
+
+            for (uint64_t word = m_words[w]; word != 0; word &= word - 1) {
+
+                function((w << 6) + std::countr_zero(word));
+            }
+        }
+    }
+
+    template <typename TId>
+    std::vector<TId> selected_ids() const
+    {
+
+        std::vector<TId> result;
+        result.reserve(count());
+
+        for_each_selected([&](size_t i) { result.push_back(TId(i)); });
+
+        return result;
+    }
+
+    std::string describe() const
+    {
+
+        return "SelectionBitmap(" + std::to_string(count()) + " of " + std::to_string(m_size) + " selected)";
+    }
+
+    // private:
+    void clear_tail()
+    {
+
+        if (m_size % 64 != 0) {
+
+            m_words.back() &= (uint64_t(1) << (m_size % 64)) - 1;
+        }
+    }
+};
+
+enum class Comparison {
+    Less,
+    LessEqual,
+    Greater,
+    GreaterEqual,
+    Equal,
+    NotEqual,
+};
+
+inline std::string comparison_name(Comparison comparison)
+{
+
+    static const char* names[] = { "<", "<=", ">", ">=", "==", "!=" };
+    return names[size_t(comparison)];
+}
+
+// `column_index` selects the column of a features tuple, e.g. the volume column of the Istanbul nodes
+template <size_t column_index, typename TValue>
+class ColumnPredicate {
+
+public:
+    static constexpr size_t COLUMN_INDEX = column_index;
+
+    Comparison m_comparison;
+    TValue m_value;
+
+    explicit ColumnPredicate(Comparison comparison, TValue value)
+        : m_comparison(comparison)
+        , m_value(value)
+    {
+    }
+
+    std::string describe() const
+    {
+
+        return "column" + std::to_string(column_index) + " " + comparison_name(m_comparison) + " " + std::to_string(m_value);
+    }
+};
+
+// A predicate constant as a value of the column element type with the same result for every element.
+// Constants between two element values compare against the nearer side, constants that no element can reach
+// make the predicate constant, e.g. x < 2.5 becomes x <= 2 and x > -1 over unsigned elements is always true.
+template <typename TElement>
+class ElementBound {
+
+public:
+    Comparison m_comparison;
+    TElement m_value;
+    std::optional<bool> m_result;
+
+    std::string describe() const
+    {
+
+        return m_result.has_value() ? std::string(*m_result ? "ElementBound(true)" : "ElementBound(false)")
+                                    : "ElementBound(" + comparison_name(m_comparison) + " " + std::to_string(m_value) + ")";
+    }
+};
+
+template <typename TElement, typename TValue>
+ElementBound<TElement> element_bound(Comparison comparison, TValue value)
+{
+
+    static_assert(std::is_arithmetic_v<TElement> && std::is_arithmetic_v<TValue>, "Predicates compare numbers");
+
+    auto constant = [&](bool result) { return ElementBound<TElement> { comparison, TElement(), result }; };
+
+    // Below and above are the neighbouring element values of a constant that lies strictly between them
+    auto between = [&](TElement below, TElement above) {
+        switch (comparison) {
+        case Comparison::Less:
+        case Comparison::LessEqual:
+            return ElementBound<TElement> { Comparison::LessEqual, below, std::nullopt };
+        case Comparison::Greater:
+        case Comparison::GreaterEqual:
+            return ElementBound<TElement> { Comparison::GreaterEqual, above, std::nullopt };
+        case Comparison::Equal:
+            return constant(false);
+        case Comparison::NotEqual:
+            return constant(true);
+        }
+
+        return constant(false);
+    };
+
+    // Constants beyond the range of an integral element type
+    auto above_all = [&]() { return constant(comparison == Comparison::Less || comparison == Comparison::LessEqual || comparison == Comparison::NotEqual); };
+    auto below_all = [&]() { return constant(comparison == Comparison::Greater || comparison == Comparison::GreaterEqual || comparison == Comparison::NotEqual); };
+
+    if constexpr (std::is_integral_v<TElement> && std::is_integral_v<TValue>) {
+
+        if (std::cmp_greater(value, std::numeric_limits<TElement>::max())) {
+
+            return above_all();
+        }
+
+        if (std::cmp_less(value, std::numeric_limits<TElement>::lowest())) {
+
+            return below_all();
+        }
+
+        return ElementBound<TElement> { comparison, TElement(value), std::nullopt };
+    } else {
+
+        long double exact = (long double)value;
+        long double lowest = (long double)std::numeric_limits<TElement>::lowest();
+        long double highest = (long double)std::numeric_limits<TElement>::max();
+
+        if (std::isnan(exact)) {
+
+            return constant(comparison == Comparison::NotEqual);
+        }
+
+        if constexpr (std::is_integral_v<TElement>) {
+
+            if (exact > highest) {
+
+                return above_all();
+            }
+
+            if (exact < lowest) {
+
+                return below_all();
+            }
+
+            TElement below = TElement(std::floor(exact));
+            TElement above = TElement(std::ceil(exact));
+
+            return below == above ? ElementBound<TElement> { comparison, below, std::nullopt } : between(below, above);
+        } else {
+
+            constexpr TElement infinity = std::numeric_limits<TElement>::infinity();
+
+            if (!std::isinf(exact) && exact > highest) {
+
+                return between(std::numeric_limits<TElement>::max(), infinity);
+            }
+
+            if (!std::isinf(exact) && exact < lowest) {
+
+                return between(-infinity, std::numeric_limits<TElement>::lowest());
+            }
+
+            TElement nearest = TElement(exact);
+
+            if ((long double)nearest == exact) {
+
+                return ElementBound<TElement> { comparison, nearest, std::nullopt };
+            }
+
+            return (long double)nearest < exact ? between(nearest, std::nextafter(nearest, infinity)) : between(std::nextafter(nearest, -infinity), nearest);
+        }
+    }
+}
+
+template <typename... TPredicates>
+class Conjunction {
+
+public:
+    std::tuple<TPredicates...> m_predicates;
+
+    explicit Conjunction(std::tuple<TPredicates...> predicates)
+        : m_predicates(std::move(predicates))
+    {
+    }
+
+    std::string describe() const
+    {
+
+        std::string result = std::apply([](auto&... predicates) { return ((predicates.describe() + " && ") + ...); }, m_predicates);
+
+        return "Conjunction(" + result.substr(0, result.size() - 4) + ")";
+    }
+};
+
+// Builds predicates as column<5>() > x && column<3>() < y
+template <size_t column_index>
+class Column {
+
+public:
+    template <typename TValue>
+    ColumnPredicate<column_index, TValue> operator<(TValue value) const { return ColumnPredicate<column_index, TValue>(Comparison::Less, value); }
+    template <typename TValue>
+    ColumnPredicate<column_index, TValue> operator<=(TValue value) const { return ColumnPredicate<column_index, TValue>(Comparison::LessEqual, value); }
+    template <typename TValue>
+    ColumnPredicate<column_index, TValue> operator>(TValue value) const { return ColumnPredicate<column_index, TValue>(Comparison::Greater, value); }
+    template <typename TValue>
+    ColumnPredicate<column_index, TValue> operator>=(TValue value) const { return ColumnPredicate<column_index, TValue>(Comparison::GreaterEqual, value); }
+    template <typename TValue>
+    ColumnPredicate<column_index, TValue> operator==(TValue value) const { return ColumnPredicate<column_index, TValue>(Comparison::Equal, value); }
+    template <typename TValue>
+    ColumnPredicate<column_index, TValue> operator!=(TValue value) const { return ColumnPredicate<column_index, TValue>(Comparison::NotEqual, value); }
+};
+
+template <size_t column_index>
+Column<column_index> column()
+{
+
+    return Column<column_index>();
+}
+
+template <size_t column_index, typename TValue>
+Conjunction<ColumnPredicate<column_index, TValue>> as_conjunction(ColumnPredicate<column_index, TValue> predicate)
+{
+
+    return Conjunction<ColumnPredicate<column_index, TValue>>(std::make_tuple(predicate));
+}
+
+template <typename... TPredicates>
+Conjunction<TPredicates...> as_conjunction(Conjunction<TPredicates...> conjunction)
+{
+
+    return conjunction;
+}
+
+template <size_t a_index, typename TA, size_t b_index, typename TB>
+Conjunction<ColumnPredicate<a_index, TA>, ColumnPredicate<b_index, TB>> operator&&(ColumnPredicate<a_index, TA> a, ColumnPredicate<b_index, TB> b)
+{
+
+    return Conjunction<ColumnPredicate<a_index, TA>, ColumnPredicate<b_index, TB>>(std::make_tuple(a, b));
+}
+
+template <typename... TPredicates, size_t column_index, typename TValue>
+Conjunction<TPredicates..., ColumnPredicate<column_index, TValue>> operator&&(Conjunction<TPredicates...> a, ColumnPredicate<column_index, TValue> b)
+{
+
+    return Conjunction<TPredicates..., ColumnPredicate<column_index, TValue>>(std::tuple_cat(a.m_predicates, std::make_tuple(b)));
+}
+
+template <Comparison comparison, typename T>
+bool compare(T a, T b)
+{
+
+    if constexpr (comparison == Comparison::Less) {
+        return a < b;
+    } else if constexpr (comparison == Comparison::LessEqual) {
+        return a <= b;
+    } else if constexpr (comparison == Comparison::Greater) {
+        return a > b;
+    } else if constexpr (comparison == Comparison::GreaterEqual) {
+        return a >= b;
+    } else if constexpr (comparison == Comparison::Equal) {
+        return a == b;
+    } else {
+        return a != b;
+    }
+}
+
+// Compares up to 64 values of a column and returns their selection bits
+template <Comparison comparison, typename T>
+uint64_t compare_block(const T* data, size_t count, T value)
+{
+
+#if defined(__AVX2__)
+    if (count == 64) {
+
+        if constexpr (std::is_same_v<T, float>) {
+
+            constexpr int predicate = comparison == Comparison::Less ? _CMP_LT_OQ
+                : comparison == Comparison::LessEqual                ? _CMP_LE_OQ
+                : comparison == Comparison::Greater                  ? _CMP_GT_OQ
+                : comparison == Comparison::GreaterEqual             ? _CMP_GE_OQ
+                : comparison == Comparison::Equal                    ? _CMP_EQ_OQ
+                                                                     : _CMP_NEQ_UQ;
+
+            __m256 broadcast = _mm256_set1_ps(value);
+            uint64_t bits = 0;
+
+            for (size_t j = 0; j < 64; j += 8) {
+
+                __m256 mask = _mm256_cmp_ps(_mm256_loadu_ps(data + j), broadcast, predicate);
+                bits |= uint64_t(uint32_t(_mm256_movemask_ps(mask))) << j;
+            }
+
+            return bits;
+        } else if constexpr (std::is_same_v<T, int32_t>) {
+
+            __m256i broadcast = _mm256_set1_epi32(value);
+            uint64_t bits = 0;
+
+            for (size_t j = 0; j < 64; j += 8) {
+
+                __m256i values = _mm256_loadu_si256((const __m256i*)(data + j));
+                __m256i mask;
+
+                if constexpr (comparison == Comparison::Less || comparison == Comparison::GreaterEqual) {
+                    mask = _mm256_cmpgt_epi32(broadcast, values);
+                } else if constexpr (comparison == Comparison::Greater || comparison == Comparison::LessEqual) {
+                    mask = _mm256_cmpgt_epi32(values, broadcast);
+                } else {
+                    mask = _mm256_cmpeq_epi32(values, broadcast);
+                }
+
+                uint64_t lane_bits = uint32_t(_mm256_movemask_ps(_mm256_castsi256_ps(mask)));
+
+                if constexpr (comparison == Comparison::GreaterEqual || comparison == Comparison::LessEqual || comparison == Comparison::NotEqual) {
+                    lane_bits ^= 0xff;
+                }
+
+                bits |= lane_bits << j;
+            }
+
+            return bits;
+        }
+    }
+#endif
+
+    uint64_t bits = 0;
+
+    for (size_t j = 0; j < count; j++) {
+
+        bits |= uint64_t(compare<comparison>(data[j], value)) << j;
+    }
+
+    return bits;
+}
+
+// Evaluates one comparison over the words [word_begin, word_end) of the selection.
+// The first predicate overwrites the words, the next ones only refine words that still have selected rows.
+template <Comparison comparison, typename T>
+void scan_words(std::span<const T> data, T value, std::vector<uint64_t>& words, size_t word_begin, size_t word_end, bool first)
+{
+
+    for (size_t w = word_begin; w < word_end; w++) {
+
+        if (!first && words[w] == 0) {
+
+            continue;
+        }
+
+        size_t begin = w << 6;
+        size_t count = std::min<size_t>(64, data.size() - begin);
+        uint64_t bits = compare_block<comparison>(data.data() + begin, count, value);
+
+        words[w] = first ? bits : (words[w] & bits);
+    }
+}
+
+template <typename T>
+void scan_words(std::span<const T> data, Comparison comparison, T value, std::vector<uint64_t>& words, size_t word_begin, size_t word_end, bool first)
+{
+
+    switch (comparison) {
+    case Comparison::Less:
+        return scan_words<Comparison::Less>(data, value, words, word_begin, word_end, first);
+    case Comparison::LessEqual:
+        return scan_words<Comparison::LessEqual>(data, value, words, word_begin, word_end, first);
+    case Comparison::Greater:
+        return scan_words<Comparison::Greater>(data, value, words, word_begin, word_end, first);
+    case Comparison::GreaterEqual:
+        return scan_words<Comparison::GreaterEqual>(data, value, words, word_begin, word_end, first);
+    case Comparison::Equal:
+        return scan_words<Comparison::Equal>(data, value, words, word_begin, word_end, first);
+    case Comparison::NotEqual:
+        return scan_words<Comparison::NotEqual>(data, value, words, word_begin, word_end, first);
+    }
+}
+
+// Selects the rows of a tuple of equally sized columns that satisfy every predicate.
+// Each thread scans a range of 64-row words through all predicates while the range is in cache.
+template <typename... TColumns, typename TPredicate>
+SelectionBitmap select_rows(const std::tuple<TColumns...>& columns, TPredicate predicate, size_t thread_count = 0)
+{
+
+    auto conjunction = as_conjunction(predicate);
+    size_t row_count = std::get<0>(columns).size();
+
+    std::apply([&](auto&... column) {
+        if (((column.size() != row_count) || ...)) {
+
+            throw std::invalid_argument("select_rows needs columns of equal size");
+        }
+    },
+        columns);
+
+    SelectionBitmap result(row_count, true);
+
+    parallel::parallel_for_ranges(
+        0, result.m_words.size(),
+        [&](size_t word_begin, size_t word_end, size_t) {
+            bool first = true;
+
+            std::apply([&](auto&... predicates) {
+                auto scan = [&](auto& predicate) {
+                    auto& column = std::get<std::remove_reference_t<decltype(predicate)>::COLUMN_INDEX>(columns);
+                    typedef typename std::remove_reference_t<decltype(column)>::value_type TElement;
+
+                    auto bound = element_bound<TElement>(predicate.m_comparison, predicate.m_value);
+
+                    if (!bound.m_result.has_value()) {
+
+                        scan_words<TElement>(std::span<const TElement>(column.data(), column.size()), bound.m_comparison, bound.m_value,
+                            result.m_words, word_begin, word_end, first);
+                    } else if (!*bound.m_result) {
+
+                        std::fill(result.m_words.begin() + word_begin, result.m_words.begin() + word_end, uint64_t(0));
+                    }
+
+                    first = false;
+                };
+
+                (scan(predicates), ...);
+            },
+                conjunction.m_predicates);
+        },
+        thread_count, 1024);
+
+    return result;
+}
+
+// Node features are numbered as in the features tuple, e.g. column<5>() is the volume of the Istanbul nodes
+template <typename TNodes, typename TPredicate>
+SelectionBitmap select_nodes(const TNodes& nodes, TPredicate predicate, size_t thread_count = 0)
+{
+
+    return select_rows(nodes.m_features, predicate, thread_count);
+}
+
+template <typename TConnections, typename TPredicate>
+SelectionBitmap select_connections(const TConnections& connections, TPredicate predicate, size_t thread_count = 0)
+{
+
+    return select_rows(connections.m_features, predicate, thread_count);
+}
+}
+
+#endif
@@ -0,0 +1,232 @@
+#ifndef SPARSIFICATION_HPP_
+#define SPARSIFICATION_HPP_
+
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <cstdint>
+#include <span>
+#include <stdexcept>
+#include <tuple>
+#include <type_traits>
+#include <vector>
+
+#include <ginv/parallel/parallel_for.hpp>
+#include <ginv/query/induced_subgraph.hpp>
+#include <ginv/query/predicate_scan.hpp>
+#include <osigma/oconnection_index.hpp>
+#include <osigma/oconnections.hpp>
+#include <osigma/ograph.hpp>
+
+namespace query {
+
+// Connections with a value of at least `threshold`
+template <template <typename> typename TAllocator, typename TId, typename TValue, typename... TFeatures>
+SelectionBitmap weight_threshold_selection(
+    const ograph::BasicOConnections<TAllocator, TId, TValue, TFeatures...>& connections, std::type_identity_t<TValue> threshold, size_t thread_count = 0)
+{
+
+    size_t connection_count = connections.m_values.size();
+    SelectionBitmap selection(connection_count);
+
+    parallel::parallel_for(
+        0, selection.m_words.size(),
+        [&](size_t w) {
+            uint64_t word = 0;
+            size_t end = std::min(connection_count, (w + 1) << 6);
+
+            for (size_t i = w << 6; i < end; i++) {
+
+                word |= uint64_t(connections.m_values[i] >= threshold) << (i & 63);
+            }
+
+            selection.m_words[w] = word;
+        },
+        thread_count, 1024);
+
+    return selection;
+}
+
+// Connections among the k strongest of at least one of their nodes; equal values prefer earlier connections.
+// Takes a connection id index of the connections (create_connection_id_index).
+template <template <typename> typename TAllocator, typename TId, typename TValue, typename... TFeatures>
+SelectionBitmap top_k_selection(
+    const ograph::BasicOConnections<TAllocator, TId, TValue, TFeatures...>& connections,
+    const ograph::OConnectionIndex<TId, uint32_t>& connection_id_index,
+    size_t k,
+    size_t thread_count = 0)
+{
+
+    SelectionBitmap selection(connections.m_from.size());
+
+    parallel::parallel_for_ranges(
+        0, connection_id_index.node_count(),
+        [&](size_t begin, size_t end, size_t) {
+            std::vector<uint32_t> ids;
+
+            for (size_t v = begin; v < end; v++) {
+
+                auto node_ids = connection_id_index.values(v);
+
+                ids.assign(node_ids.begin(), node_ids.end());
+
+                auto stronger = [&](uint32_t a, uint32_t b) {
+                    return connections.m_values[a] > connections.m_values[b] || (connections.m_values[a] == connections.m_values[b] && a < b);
+                };
+
+                if (ids.size() > k) {
+
+                    std::nth_element(ids.begin(), ids.begin() + k, ids.end(), stronger);
+                    ids.resize(k);
+                }
+
+                for (uint32_t id : ids) {
+
+                    std::atomic_ref<uint64_t>(selection.m_words[id >> 6]).fetch_or(uint64_t(1) << (id & 63), std::memory_order_relaxed);
+                }
+            }
+        },
+        thread_count, 4096);
+
+    return selection;
+}
+
+template <template <typename> typename TAllocator, typename TId, typename TValue, typename... TFeatures>
+SelectionBitmap top_k_selection(
+    size_t node_count, const ograph::BasicOConnections<TAllocator, TId, TValue, TFeatures...>& connections, size_t k, size_t thread_count = 0)
+{
+
+    return top_k_selection(connections, ograph::create_connection_id_index(node_count, connections, ograph::ConnectionDirection::Both), k, thread_count);
+}
+
+// Disparity filter significance (Serrano, Boguna and Vespignani 2009) of every connection: the smaller of
+// (1 - w / s)^(k - 1) over its two nodes, where s is the strength and k the degree of the node.
+// Nodes with a single connection give no evidence and count as 1; parallel connections count separately.
+template <template <typename> typename TAllocator, typename TId, typename TValue, typename... TFeatures>
+std::vector<double> disparity_significance(
+    size_t node_count, const ograph::BasicOConnections<TAllocator, TId, TValue, TFeatures...>& connections, size_t thread_count = 0)
+{
+
+    auto index = ograph::create_connection_index(node_count, connections, ograph::ConnectionDirection::Both);
+    std::vector<double> strengths(node_count);
+
+    parallel::parallel_for(
+        0, node_count,
+        [&](size_t v) {
+            double strength = 0;
+
+            for (auto value : index.values(v)) {
+
+                strength += double(value);
+            }
+
+            strengths[v] = strength;
+        },
+        thread_count, 4096);
+
+    auto significance_at = [&](TId node, double weight) {
+        size_t degree = index.degree(node);
+        return degree > 1 && strengths[node] > 0 ? std::pow(1 - weight / strengths[node], double(degree - 1)) : 1.0;
+    };
+
+    std::vector<double> significance(connections.m_from.size());
+
+    parallel::parallel_for(
+        0, significance.size(),
+        [&](size_t i) {
+            double weight = double(connections.m_values[i]);
+            significance[i] = std::min(significance_at(connections.m_from[i], weight), significance_at(connections.m_to[i], weight));
+        },
+        thread_count, 4096);
+
+    return significance;
+}
+
+// Backbone of the connections that are significant at level `alpha` for at least one of their nodes
+template <template <typename> typename TAllocator, typename TId, typename TValue, typename... TFeatures>
+SelectionBitmap disparity_backbone_selection(
+    size_t node_count, const ograph::BasicOConnections<TAllocator, TId, TValue, TFeatures...>& connections, double alpha = 0.05, size_t thread_count = 0)
+{
+
+    std::vector<double> significance = disparity_significance(node_count, connections, thread_count);
+    SelectionBitmap selection(significance.size());
+
+    parallel::parallel_for(
+        0, selection.m_words.size(),
+        [&](size_t w) {
+            uint64_t word = 0;
+            size_t end = std::min(significance.size(), (w + 1) << 6);
+
+            for (size_t i = w << 6; i < end; i++) {
+
+                word |= uint64_t(significance[i] < alpha) << (i & 63);
+            }
+
+            selection.m_words[w] = word;
+        },
+        thread_count, 1024);
+
+    return selection;
+}
+
+// New connection set of the selected connections with all of their columns
+template <template <typename> typename TAllocator, typename TId, typename TValue, typename... TFeatures>
+ograph::BasicOConnections<TAllocator, TId, TValue, TFeatures...> filter_connections(
+    const ograph::BasicOConnections<TAllocator, TId, TValue, TFeatures...>& connections, const SelectionBitmap& selection, size_t thread_count = 0)
+{
+
+    std::vector<uint32_t> ids = selection.template selected_ids<uint32_t>();
+
+    return std::apply([&](auto&... features) {
+        return ograph::BasicOConnections<TAllocator, TId, TValue, TFeatures...>(
+            gather_column(connections.m_from, ids, thread_count),
+            gather_column(connections.m_to, ids, thread_count),
+            gather_column(connections.m_values, ids, thread_count),
+            gather_column(features, ids, thread_count)...);
+    },
+        connections.m_features);
+}
+
+template <template <typename> typename TAllocator, typename TId, typename TValue, typename TZIndex, typename... TFeatures>
+ograph::BasicOSpatialConnections<TAllocator, TId, TValue, TZIndex, TFeatures...> filter_connections(
+    const ograph::BasicOSpatialConnections<TAllocator, TId, TValue, TZIndex, TFeatures...>& connections, const SelectionBitmap& selection, size_t thread_count = 0)
+{
+
+    std::vector<uint32_t> ids = selection.template selected_ids<uint32_t>();
+
+    return std::apply([&](auto&... features) {
+        return ograph::BasicOSpatialConnections<TAllocator, TId, TValue, TZIndex, TFeatures...>(
+            gather_column(connections.m_from, ids, thread_count),
+            gather_column(connections.m_to, ids, thread_count),
+            gather_column(connections.m_values, ids, thread_count),
+            gather_column(connections.m_z_index, ids, thread_count),
+            gather_column(features, ids, thread_count)...);
+    },
+        connections.m_features);
+}
+
+// The graph with all of its nodes and only the selected connections
+template <
+    template <typename> typename TAllocator,
+    typename TId,
+    typename TConnectionWeight,
+    typename TCoordinates,
+    typename TZIndex,
+    typename... TNodeFeatures>
+ograph::BasicOGraph<TAllocator, TId, TConnectionWeight, TCoordinates, TZIndex, TNodeFeatures...> sparsify(
+    const ograph::BasicOGraph<TAllocator, TId, TConnectionWeight, TCoordinates, TZIndex, TNodeFeatures...>& graph,
+    const SelectionBitmap& connection_selection,
+    size_t thread_count = 0)
+{
+
+    if (connection_selection.size() != graph.m_connections.m_from.size()) {
+
+        throw std::invalid_argument("Connection selection size does not match the graph");
+    }
+
+    return ograph::BasicOGraph<TAllocator, TId, TConnectionWeight, TCoordinates, TZIndex, TNodeFeatures...>(
+        graph.m_nodes, filter_connections(graph.m_connections, connection_selection, thread_count));
+}
+}
+
+#endif
@@ -0,0 +1,371 @@
+#ifndef SCHEMA_DATASET_HPP_
+#define SCHEMA_DATASET_HPP_
+
+#include <cstdint>
+#include <fstream>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <nlohmann/json.hpp>
+#include <stdexcept>
+#include <string>
+#include <type_traits>
+#include <variant>
+#include <vector>
+
+#include <ginv/parallel/parallel_for.hpp>
+
+namespace dataset {
+
+// A column stored in `m_shards` binary files; `${FILE_ID}` in the file name is replaced by the shard number.
+// Columns of the "nodes" table have the "nodes" count of the dataset and "connections" columns the "links" count.
+class ColumnSchema {
+
+public:
+    std::string m_name;
+    std::string m_table;
+    std::string m_file;
+    std::string m_type;
+    size_t m_shards;
+
+    std::string describe() const
+    {
+
+        return "ColumnSchema(" + m_table + "." + m_name + " of " + m_type + " in " + std::to_string(m_shards) + " x " + m_file + ")";
+    }
+};
+
+// The layout of the Istanbul EIN files, used when global_params.json lists no "columns"
+inline std::vector<ColumnSchema> istanbul_ein_schema()
+{
+
+    return {
+        { "from", "connections", "ein_from_${FILE_ID}.bin", "int32", 2 },
+        { "to", "connections", "ein_to_${FILE_ID}.bin", "int32", 2 },
+        { "value", "connections", "ein_value_${FILE_ID}.bin", "uint8", 1 },
+        { "degree", "nodes", "feature_degree_${FILE_ID}.bin", "int32", 1 },
+        { "centrality", "nodes", "feature_centrality_${FILE_ID}.bin", "float32", 1 },
+        { "number_of_trades", "nodes", "feature_number_of_trades_${FILE_ID}.bin", "int32", 1 },
+        { "profits", "nodes", "feature_profits_${FILE_ID}.bin", "float32", 1 },
+        { "profits_excess", "nodes", "feature_profits_excess_${FILE_ID}.bin", "float32", 1 },
+        { "volume", "nodes", "feature_volume_${FILE_ID}.bin", "float32", 1 },
+    };
+}
+
+// "columns": [{ "name": "from", "table": "connections", "file": "ein_from_${FILE_ID}.bin", "type": "int32", "shards": 2 }, ...]
+inline std::vector<ColumnSchema> read_schema(const nlohmann::json& global_params)
+{
+
+    if (!global_params.contains("columns")) {
+
+        return istanbul_ein_schema();
+    }
+
+    std::vector<ColumnSchema> result;
+
+    for (auto& column : global_params["columns"]) {
+
+        result.push_back(ColumnSchema {
+            column.at("name").get<std::string>(),
+            column.at("table").get<std::string>(),
+            column.at("file").get<std::string>(),
+            column.at("type").get<std::string>(),
+            column.value("shards", size_t(1)),
+        });
+    }
+
+    return result;
+}
+
+typedef std::variant<
+    std::vector<int8_t>, std::vector<uint8_t>, std::vector<int16_t>, std::vector<uint16_t>,
+    std::vector<int32_t>, std::vector<uint32_t>, std::vector<int64_t>, std::vector<uint64_t>,
+    std::vector<float>, std::vector<double>>
+    ColumnData;
+
+inline ColumnData create_column_data(const std::string& type)
+{
+
+    static const std::map<std::string, ColumnData> types = {
+        { "int8", std::vector<int8_t>() }, { "uint8", std::vector<uint8_t>() },
+        { "int16", std::vector<int16_t>() }, { "uint16", std::vector<uint16_t>() },
+        { "int32", std::vector<int32_t>() }, { "uint32", std::vector<uint32_t>() },
+        { "int64", std::vector<int64_t>() }, { "uint64", std::vector<uint64_t>() },
+        { "float32", std::vector<float>() }, { "float", std::vector<float>() },
+        { "float64", std::vector<double>() }, { "double", std::vector<double>() },
+    };
+
+    auto type_data = types.find(type);
+
+    if (type_data == types.end()) {
+
+        throw std::invalid_argument("Unknown column type " + type);
+    }
+
+    return type_data->second;
+}
+
+// Name of a column type, the inverse of create_column_data
+template <typename T>
+std::string column_type_name()
+{
+
+    return std::is_floating_point_v<T> ? (sizeof(T) == 4 ? "float32" : "float64")
+                                       : (std::is_signed_v<T> ? "int" : "uint") + std::to_string(8 * sizeof(T));
+}
+
+inline std::string shard_file_name(const std::string& root, const ColumnSchema& schema, size_t shard)
+{
+
+    const std::string to_replace = "${FILE_ID}";
+
+    std::string file_name = root + "/" + schema.m_file;
+    size_t id_position = file_name.find(to_replace);
+
+    if (id_position != std::string::npos) {
+
+        file_name.replace(id_position, to_replace.size(), std::to_string(shard));
+    }
+
+    return file_name;
+}
+
+// Reads the shards one after another into a column of exactly `element_count` elements
+template <typename T>
+void read_shards(const std::string& root, const ColumnSchema& schema, size_t element_count, std::vector<T>& storage)
+{
+
+    storage.assign(element_count, T());
+    size_t offset = 0;
+
+    for (size_t i = 0; i < schema.m_shards; i++) {
+
+        std::string file_name = shard_file_name(root, schema, i);
+        std::ifstream file(file_name, std::ios::in | std::ios::binary | std::ios::ate);
+
+        if (!file) {
+
+            throw std::runtime_error("Cannot open " + file_name);
+        }
+
+        size_t file_size = file.tellg();
+
+        if (file_size % sizeof(T) != 0 || offset + file_size / sizeof(T) > element_count) {
+
+            throw std::runtime_error(file_name + " does not fit the " + std::to_string(element_count) + " " + schema.m_type + " elements of " + schema.m_name);
+        }
+
+        file.seekg(0, std::ios::beg);
+        file.read((char*)(storage.data() + offset), file_size);
+
+        if (!file) {
+
+            throw std::runtime_error("Cannot read " + file_name);
+        }
+
+        offset += file_size / sizeof(T);
+    }
+
+    if (offset != element_count) {
+
+        throw std::runtime_error("The shards of " + schema.m_name + " hold " + std::to_string(offset) + " instead of " + std::to_string(element_count) + " elements");
+    }
+}
+
+// Dataset whose columns are described by the schema in its global params file. Projected columns are
+// read in parallel by the constructor, all other columns are read on their first access.
+class SchemaDataset {
+
+public:
+    explicit SchemaDataset(
+        std::string root, std::vector<std::string> projection = {}, std::string global_params_file = "global_params.json", size_t thread_count = 0)
+        : m_root(std::move(root))
+    {
+
+        std::ifstream file(m_root + "/" + global_params_file);
+
+        if (!file) {
+
+            throw std::runtime_error("Cannot open " + m_root + "/" + global_params_file);
+        }
+
+        nlohmann::json global_params = nlohmann::json::parse(file);
+
+        m_node_count = global_params.at("nodes").get<size_t>();
+        m_connection_count = global_params.at("links").get<size_t>();
+
+        for (auto& schema : read_schema(global_params)) {
+
+            if (schema.m_table != "nodes" && schema.m_table != "connections") {
+
+                throw std::invalid_argument("Column " + schema.m_name + " belongs to the unknown table " + schema.m_table);
+            }
+
+            auto column = std::make_unique<Column>();
+            column->m_schema = schema;
+            column->m_data = create_column_data(schema.m_type);
+
+            m_column_ids[schema.m_name] = m_columns.size();
+            m_columns.push_back(std::move(column));
+        }
+
+        for (auto& name : projection) {
+
+            find(name);
+        }
+
+        parallel::parallel_for(
+            0, projection.size(), [&](size_t i) { load(find(projection[i])); }, thread_count);
+    }
+
+    size_t node_count() const
+    {
+
+        return m_node_count;
+    }
+
+    size_t connection_count() const
+    {
+
+        return m_connection_count;
+    }
+
+    bool has_column(const std::string& name) const
+    {
+
+        return m_column_ids.find(name) != m_column_ids.end();
+    }
+
+    bool is_loaded(const std::string& name) const
+    {
+
+        Column& column = find(name);
+        std::lock_guard<std::mutex> lock(column.m_mutex);
+
+        return column.m_loaded;
+    }
+
+    const ColumnSchema& schema(const std::string& name) const
+    {
+
+        return find(name).m_schema;
+    }
+
+    std::vector<std::string> column_names() const
+    {
+
+        std::vector<std::string> result;
+
+        for (auto& column : m_columns) {
+
+            result.push_back(column->m_schema.m_name);
+        }
+
+        return result;
+    }
+
+    // Loads the column on first access; T has to match the type of its schema
+    template <typename T>
+    const std::vector<T>& column(const std::string& name) const
+    {
+
+        Column& column = find(name);
+        load(column);
+
+        return typed<T>(column);
+    }
+
+    // Moves the column out of the dataset, e.g. into a graph; a later access reads it again
+    template <typename T>
+    std::vector<T> take_column(const std::string& name)
+    {
+
+        Column& column = find(name);
+        load(column);
+
+        std::lock_guard<std::mutex> lock(column.m_mutex);
+        std::vector<T> result = std::move(typed<T>(column));
+
+        column.m_data = create_column_data(column.m_schema.m_type);
+        column.m_loaded = false;
+
+        return result;
+    }
+
+    std::string describe() const
+    {
+
+        size_t loaded = 0;
+
+        for (auto& column : m_columns) {
+
+            std::lock_guard<std::mutex> lock(column->m_mutex);
+            loaded += column->m_loaded;
+        }
+
+        return "SchemaDataset(" + std::to_string(m_columns.size()) + " columns with " + std::to_string(loaded) + " loaded, "
+            + std::to_string(m_node_count) + " nodes and " + std::to_string(m_connection_count) + " connections)";
+    }
+
+private:
+    class Column {
+
+    public:
+        ColumnSchema m_schema;
+        ColumnData m_data;
+        bool m_loaded = false;
+        std::mutex m_mutex;
+    };
+
+    std::string m_root;
+    size_t m_node_count;
+    size_t m_connection_count;
+    std::vector<std::unique_ptr<Column>> m_columns;
+    std::map<std::string, size_t> m_column_ids;
+
+    Column& find(const std::string& name) const
+    {
+
+        auto id = m_column_ids.find(name);
+
+        if (id == m_column_ids.end()) {
+
+            throw std::out_of_range("The dataset has no column " + name);
+        }
+
+        return *m_columns[id->second];
+    }
+
+    void load(Column& column) const
+    {
+
+        std::lock_guard<std::mutex> lock(column.m_mutex);
+
+        if (column.m_loaded) {
+
+            return;
+        }
+
+        size_t element_count = column.m_schema.m_table == "nodes" ? m_node_count : m_connection_count;
+
+        std::visit([&](auto& storage) { read_shards(m_root, column.m_schema, element_count, storage); }, column.m_data);
+        column.m_loaded = true;
+    }
+
+    template <typename T>
+    static std::vector<T>& typed(Column& column)
+    {
+
+        auto* storage = std::get_if<std::vector<T>>(&column.m_data);
+
+        if (storage == nullptr) {
+
+            throw std::invalid_argument("Column " + column.m_schema.m_name + " holds " + column.m_schema.m_type + " elements");
+        }
+
+        return *storage;
+    }
+};
+}
+
+#endif
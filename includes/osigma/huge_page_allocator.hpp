@@ -0,0 +1,136 @@
+#ifndef HUGE_PAGE_ALLOCATOR_HPP_
+#define HUGE_PAGE_ALLOCATOR_HPP_
+
+#include <algorithm>
+#include <cstdlib>
+#include <cstring>
+#include <new>
+#include <thread>
+#include <vector>
+
+#ifdef __linux__
+#include <sys/mman.h>
+#endif
+
+namespace ograph {
+
+// Allocator for large SoA columns: storage is 64-byte aligned and allocations of at least a huge page are
+// huge-page aligned and advised as transparent huge pages. With FIRST_TOUCH, large allocations are first touched
+// by several threads so that their pages are spread over the NUMA nodes of the threads that use them; that starts
+// threads in every such allocate(), vector regrowth included, so it is left to FirstTouchHugePageAllocator.
+// Use it as BasicOGraph<HugePageAllocator, ...>.
+template <typename T, bool FIRST_TOUCH = false>
+class BasicHugePageAllocator {
+
+public:
+    typedef T value_type;
+
+    template <typename U>
+    struct rebind {
+        typedef BasicHugePageAllocator<U, FIRST_TOUCH> other;
+    };
+
+    static constexpr size_t ALIGNMENT = 64;
+    static constexpr size_t HUGE_PAGE_SIZE = 2 * 1024 * 1024;
+    static constexpr size_t FIRST_TOUCH_SIZE = 16 * HUGE_PAGE_SIZE;
+    static constexpr size_t MAX_FIRST_TOUCH_THREADS = 16;
+
+    BasicHugePageAllocator() noexcept = default;
+
+    template <typename U>
+    BasicHugePageAllocator(const BasicHugePageAllocator<U, FIRST_TOUCH>&) noexcept
+    {
+    }
+
+    T* allocate(size_t count)
+    {
+
+        if (count > size_t(-1) / sizeof(T)) {
+
+            throw std::bad_array_new_length();
+        }
+
+        size_t size = std::max<size_t>(count * sizeof(T), 1);
+        size_t alignment = size >= HUGE_PAGE_SIZE ? HUGE_PAGE_SIZE : ALIGNMENT;
+        size = (size + alignment - 1) / alignment * alignment;
+
+        void* data = std::aligned_alloc(alignment, size);
+
+        if (data == nullptr) {
+
+            throw std::bad_alloc();
+        }
+
+#ifdef MADV_HUGEPAGE
+        if (alignment == HUGE_PAGE_SIZE) {
+
+            madvise(data, size, MADV_HUGEPAGE);
+        }
+#endif
+
+        if constexpr (FIRST_TOUCH) {
+
+            if (size >= FIRST_TOUCH_SIZE) {
+
+                first_touch((char*)data, size);
+            }
+        }
+
+        return (T*)data;
+    }
+
+    void deallocate(T* data, size_t) noexcept
+    {
+
+        std::free(data);
+    }
+
+    template <typename U>
+    bool operator==(const BasicHugePageAllocator<U, FIRST_TOUCH>&) const noexcept
+    {
+
+        return true;
+    }
+
+    // private:
+    static void first_touch(char* data, size_t size)
+    {
+
+        size_t thread_count = std::clamp<size_t>(std::thread::hardware_concurrency(), 1, MAX_FIRST_TOUCH_THREADS);
+        size_t page_count = size / HUGE_PAGE_SIZE;
+        size_t pages_per_thread = (page_count + thread_count - 1) / thread_count;
+
+        auto touch = [&](size_t thread_id) {
+            size_t begin = std::min(size, thread_id * pages_per_thread * HUGE_PAGE_SIZE);
+            size_t end = std::min(size, begin + pages_per_thread * HUGE_PAGE_SIZE);
+
+            if (begin < end) {
+
+                std::memset(data + begin, 0, end - begin);
+            }
+        };
+
+        std::vector<std::thread> workers;
+
+        for (size_t t = 1; t < thread_count; t++) {
+
+            workers.emplace_back(touch, t);
+        }
+
+        touch(0);
+
+        for (auto& worker : workers) {
+
+            worker.join();
+        }
+    }
+};
+
+template <typename T>
+using HugePageAllocator = BasicHugePageAllocator<T, false>;
+
+template <typename T>
+using FirstTouchHugePageAllocator = BasicHugePageAllocator<T, true>;
+}
+
+#endif
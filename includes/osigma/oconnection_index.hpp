@@ -0,0 +1,156 @@
+#ifndef OCONNECTION_INDEX_HPP_
+#define OCONNECTION_INDEX_HPP_
+
+#include <cstdint>
+#include <limits>
+#include <numeric>
+#include <span>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include <osigma/oconnections.hpp>
+
+namespace ograph {
+
+enum class ConnectionDirection {
+    Outgoing,
+    Incoming,
+    Both,
+};
+
+// CSR view of connection columns: the neighbours of node i are m_neighbours[m_offsets[i]..m_offsets[i + 1])
+// with the connection weights in m_values. Neighbours keep the order of the connections.
+template <typename TId, typename TValue>
+class OConnectionIndex {
+
+public:
+    ConnectionDirection m_direction;
+    std::vector<size_t> m_offsets;
+    std::vector<TId> m_neighbours;
+    std::vector<TValue> m_values;
+
+    explicit OConnectionIndex(ConnectionDirection direction, std::vector<size_t> offsets, std::vector<TId> neighbours, std::vector<TValue> values)
+        : m_direction(direction)
+        , m_offsets(std::move(offsets))
+        , m_neighbours(std::move(neighbours))
+        , m_values(std::move(values))
+    {
+    }
+
+    size_t node_count() const
+    {
+
+        return m_offsets.size() - 1;
+    }
+
+    size_t degree(size_t node) const
+    {
+
+        return m_offsets[node + 1] - m_offsets[node];
+    }
+
+    std::span<const TId> neighbours(size_t node) const
+    {
+
+        return std::span<const TId>(m_neighbours.data() + m_offsets[node], degree(node));
+    }
+
+    std::span<const TValue> values(size_t node) const
+    {
+
+        return std::span<const TValue>(m_values.data() + m_offsets[node], degree(node));
+    }
+
+    std::string describe() const
+    {
+
+        return "OConnectionIndex(" + std::to_string(m_neighbours.size()) + " entries of " + std::to_string(node_count()) + " nodes)";
+    }
+};
+
+template <typename TId, typename TValue>
+OConnectionIndex<TId, TValue> create_connection_index(
+    size_t node_count,
+    std::span<const TId> from_ids,
+    std::span<const TId> to_ids,
+    std::span<const TValue> values,
+    ConnectionDirection direction = ConnectionDirection::Outgoing)
+{
+
+    std::vector<size_t> offsets(node_count + 1, 0);
+
+    auto for_each_entry = [&](auto function) {
+        for (size_t i = 0; i < from_ids.size(); i++) {
+
+            if (direction != ConnectionDirection::Incoming) {
+                function(from_ids[i], to_ids[i], values[i]);
+            }
+
+            if (direction != ConnectionDirection::Outgoing) {
+                function(to_ids[i], from_ids[i], values[i]);
+            }
+        }
+    };
+
+    for_each_entry([&](TId node, TId, TValue) {
+        if (size_t(node) >= node_count) {
+
+            throw std::out_of_range("Connection node " + std::to_string(node) + " is out of the node range");
+        }
+
+        offsets[node + 1]++;
+    });
+
+    for (size_t i = 0; i < node_count; i++) {
+
+        offsets[i + 1] += offsets[i];
+    }
+
+    std::vector<TId> neighbours(offsets.back());
+    std::vector<TValue> entry_values(offsets.back());
+    std::vector<size_t> cursors(offsets.begin(), offsets.end() - 1);
+
+    for_each_entry([&](TId node, TId neighbour, TValue value) {
+        size_t position = cursors[node]++;
+
+        neighbours[position] = neighbour;
+        entry_values[position] = value;
+    });
+
+    return OConnectionIndex<TId, TValue>(direction, std::move(offsets), std::move(neighbours), std::move(entry_values));
+}
+
+template <template <typename> typename TAllocator, typename TId, typename TValue, typename... TFeatures>
+OConnectionIndex<TId, TValue> create_connection_index(
+    size_t node_count,
+    const BasicOConnections<TAllocator, TId, TValue, TFeatures...>& connections,
+    ConnectionDirection direction = ConnectionDirection::Outgoing)
+{
+
+    return create_connection_index<TId, TValue>(
+        node_count, std::span<const TId>(connections.m_from), std::span<const TId>(connections.m_to), std::span<const TValue>(connections.m_values), direction);
+}
+
+// Index whose values are the positions of the connections in their columns, to get back to connection features
+template <template <typename> typename TAllocator, typename TId, typename TValue, typename... TFeatures>
+OConnectionIndex<TId, uint32_t> create_connection_id_index(
+    size_t node_count,
+    const BasicOConnections<TAllocator, TId, TValue, TFeatures...>& connections,
+    ConnectionDirection direction = ConnectionDirection::Both)
+{
+
+    if (connections.m_from.size() > size_t(std::numeric_limits<uint32_t>::max())) {
+
+        throw std::length_error("Connection ids do not fit 32 bits");
+    }
+
+    std::vector<uint32_t> connection_ids(connections.m_from.size());
+    std::iota(connection_ids.begin(), connection_ids.end(), uint32_t(0));
+
+    return create_connection_index<TId, uint32_t>(
+        node_count, std::span<const TId>(connections.m_from), std::span<const TId>(connections.m_to), std::span<const uint32_t>(connection_ids), direction);
+}
+}
+
+#endif
@@ -2,24 +2,30 @@
 #define OCONNECTIONS_HPP_
 
 #include <cstdarg>
+#include <memory>
 #include <string>
 #include <tuple>
 #include <vector>
 
 namespace ograph {
 
-template <typename TId, typename TValue, typename... TFeatures>
-class OConnections {
+// Columns are std::vector<T, TAllocator<T>>; OConnections and OSpatialConnections use the default allocator
+template <template <typename> typename TAllocator, typename TId, typename TValue, typename... TFeatures>
+class BasicOConnections {
+public:
+    template <typename T>
+    using TColumn = std::vector<T, TAllocator<T>>;
 
-    typedef std::tuple<std::vector<TFeatures>...> TFeaturesTuple;
+private:
+    typedef std::tuple<TColumn<TFeatures>...> TFeaturesTuple;
 
 public:
-    std::vector<TId> m_from;
-    std::vector<TId> m_to;
-    std::vector<TValue> m_values;
+    TColumn<TId> m_from;
+    TColumn<TId> m_to;
+    TColumn<TValue> m_values;
     TFeaturesTuple m_features;
 
-    explicit OConnections(std::vector<TId> from, std::vector<TId> to, std::vector<TValue> values, std::vector<TFeatures>... features)
+    explicit BasicOConnections(TColumn<TId> from, TColumn<TId> to, TColumn<TValue> values, TColumn<TFeatures>... features)
         : m_from(from)
         , m_to(to)
         , m_values(values)
@@ -34,16 +40,21 @@ public:
     }
 };
 
-template <typename TId, typename TValue, typename TZIndex, typename... TFeatures>
-class OSpatialConnections : public OConnections<TId, TValue, TFeatures...> {
+template <template <typename> typename TAllocator, typename TId, typename TValue, typename TZIndex, typename... TFeatures>
+class BasicOSpatialConnections : public BasicOConnections<TAllocator, TId, TValue, TFeatures...> {
+
+public:
+    template <typename T>
+    using TColumn = std::vector<T, TAllocator<T>>;
 
-    typedef std::tuple<std::vector<TFeatures>...> TFeaturesTuple;
+private:
+    typedef std::tuple<TColumn<TFeatures>...> TFeaturesTuple;
 
 public:
-    std::vector<TZIndex> m_z_index;
+    TColumn<TZIndex> m_z_index;
 
-    explicit OSpatialConnections(std::vector<TId> from, std::vector<TId> to, std::vector<TValue> values, std::vector<TZIndex> z_index, std::vector<TFeatures>... features)
-        : OConnections<TId, TValue, TFeatures...>(from, to, values, features...)
+    explicit BasicOSpatialConnections(TColumn<TId> from, TColumn<TId> to, TColumn<TValue> values, TColumn<TZIndex> z_index, TColumn<TFeatures>... features)
+        : BasicOConnections<TAllocator, TId, TValue, TFeatures...>(from, to, values, features...)
         , m_z_index(z_index)
     {
     }
@@ -53,6 +64,12 @@ public:
         return "OSpatialConnections(from, to, values, z_index + " + std::to_string(std::tuple_size<TFeaturesTuple>()) + " features of " + std::to_string(this->m_from.size()) + " connections)";
     }
 };
+
+template <typename TId, typename TValue, typename... TFeatures>
+using OConnections = BasicOConnections<std::allocator, TId, TValue, TFeatures...>;
+
+template <typename TId, typename TValue, typename TZIndex, typename... TFeatures>
+using OSpatialConnections = BasicOSpatialConnections<std::allocator, TId, TValue, TZIndex, TFeatures...>;
 }
 
 #endif
\ No newline at end of file
@@ -1,6 +1,7 @@
 #ifndef OGRAPH_HPP_
 #define OGRAPH_HPP_
 
+#include <memory>
 #include <string>
 #include <vector>
 
@@ -9,33 +10,35 @@
 
 namespace ograph {
 
+// All node and connection columns share the allocator; OGraph uses the default one
 template <
+    template <typename> typename TAllocator,
     typename TId,
     typename TConnectionWeight,
     typename TCoordinates,
     typename TZIndex,
     typename... TNodeFeatures>
-class OGraph {
+class BasicOGraph {
 
 public:
-    OSpatialNodes<TCoordinates, TZIndex, TNodeFeatures...> m_nodes;
-    OSpatialConnections<TId, TConnectionWeight, TZIndex> m_connections;
+    BasicOSpatialNodes<TAllocator, TCoordinates, TZIndex, TNodeFeatures...> m_nodes;
+    BasicOSpatialConnections<TAllocator, TId, TConnectionWeight, TZIndex> m_connections;
 
-    explicit OGraph(
-        OSpatialNodes<TCoordinates, TZIndex, TNodeFeatures...> nodes,
-        OSpatialConnections<TId, TConnectionWeight, TZIndex> connections)
+    explicit BasicOGraph(
+        BasicOSpatialNodes<TAllocator, TCoordinates, TZIndex, TNodeFeatures...> nodes,
+        BasicOSpatialConnections<TAllocator, TId, TConnectionWeight, TZIndex> connections)
         : m_nodes(nodes)
         , m_connections(connections)
     {
     }
 
-    size_t node_count()
+    size_t node_count() const
     {
 
         return m_nodes.m_x_coordinates.size();
     }
 
-    int connection_count()
+    int connection_count() const
     {
 
         return m_connections.m_from.size();
@@ -47,6 +50,14 @@ public:
         return "OGraph(with " + m_nodes.describe() + " and " + m_connections.describe() + ")";
     }
 };
+
+template <
+    typename TId,
+    typename TConnectionWeight,
+    typename TCoordinates,
+    typename TZIndex,
+    typename... TNodeFeatures>
+using OGraph = BasicOGraph<std::allocator, TId, TConnectionWeight, TCoordinates, TZIndex, TNodeFeatures...>;
 }
 
 #endif
\ No newline at end of file
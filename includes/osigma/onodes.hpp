@@ -2,20 +2,28 @@
 #define ONODES_HPP_
 
 #include <cstdarg>
+#include <memory>
 #include <string>
 #include <tuple>
+#include <type_traits>
 #include <vector>
 
 namespace ograph {
 
-template <typename... TFeatures>
-class ONodes {
-    typedef std::tuple<std::vector<TFeatures>...> TFeaturesTuple;
+// Columns are std::vector<T, TAllocator<T>>; ONodes and OSpatialNodes use the default allocator
+template <template <typename> typename TAllocator, typename... TFeatures>
+class BasicONodes {
+public:
+    template <typename T>
+    using TColumn = std::vector<T, TAllocator<T>>;
+
+private:
+    typedef std::tuple<TColumn<TFeatures>...> TFeaturesTuple;
 
 public:
     TFeaturesTuple m_features;
 
-    explicit ONodes(std::vector<TFeatures>... features)
+    explicit BasicONodes(TColumn<TFeatures>... features)
         : m_features(TFeaturesTuple(features...))
     {
     }
@@ -26,21 +34,27 @@ public:
     }
 };
 
-template <typename TCoordinates, typename TZIndex, typename... TFeatures>
-class OSpatialNodes : public ONodes<TFeatures...> {
+template <template <typename> typename TAllocator, typename TCoordinates, typename TZIndex, typename... TFeatures>
+class BasicOSpatialNodes : public BasicONodes<TAllocator, TFeatures...> {
 
-    typedef std::tuple<std::vector<TFeatures>...> TFeaturesTuple;
+public:
+    template <typename T>
+    using TColumn = std::vector<T, TAllocator<T>>;
+
+private:
+    typedef std::tuple<TColumn<TFeatures>...> TFeaturesTuple;
 
 public:
-    std::vector<TCoordinates> m_x_coordinates;
-    std::vector<TCoordinates> m_y_coordinates;
-    std::vector<TZIndex> m_z_index;
-
-    explicit OSpatialNodes(
-        std::vector<TCoordinates> x_coordinates, std::vector<TCoordinates> y_coordinates,
-        std::vector<TZIndex> z_index, std::vector<TFeatures>... features)
-        : ONodes<TFeatures...>(features...)
+    TColumn<TCoordinates> m_x_coordinates;
+    TColumn<TCoordinates> m_y_coordinates;
+    TColumn<TZIndex> m_z_index;
+
+    explicit BasicOSpatialNodes(
+        TColumn<TCoordinates> x_coordinates, TColumn<TCoordinates> y_coordinates,
+        TColumn<TZIndex> z_index, TColumn<TFeatures>... features)
+        : BasicONodes<TAllocator, TFeatures...>(features...)
         , m_x_coordinates(x_coordinates)
+        , m_y_coordinates(y_coordinates)
         , m_z_index(z_index)
     {
     }
@@ -50,6 +64,28 @@ public:
         return "OSpatialNodes(x, y + " + std::to_string(std::tuple_size<TFeaturesTuple>()) + " features of " + std::to_string(m_x_coordinates.size()) + " nodes)";
     }
 };
+
+template <typename... TFeatures>
+using ONodes = BasicONodes<std::allocator, TFeatures...>;
+
+// Overwrites the feature column `index` with `values` converted to the column type, e.g. recomputed centralities
+template <size_t index, template <typename> typename TAllocator, typename... TFeatures, typename TValues>
+void assign_feature_column(BasicONodes<TAllocator, TFeatures...>& nodes, const TValues& values)
+{
+
+    auto& column = std::get<index>(nodes.m_features);
+    typedef typename std::remove_reference_t<decltype(column)>::value_type TFeature;
+
+    column.resize(values.size());
+
+    for (size_t i = 0; i < values.size(); i++) {
+
+        column[i] = TFeature(values[i]);
+    }
+}
+
+template <typename TCoordinates, typename TZIndex, typename... TFeatures>
+using OSpatialNodes = BasicOSpatialNodes<std::allocator, TCoordinates, TZIndex, TFeatures...>;
 }
 
 #endif
\ No newline at end of file
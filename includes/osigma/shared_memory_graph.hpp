@@ -0,0 +1,466 @@
+#ifndef SHARED_MEMORY_GRAPH_HPP_
+#define SHARED_MEMORY_GRAPH_HPP_
+
+#include <atomic>
+#include <cerrno>
+#include <cstdint>
+#include <cstring>
+#include <span>
+#include <stdexcept>
+#include <string>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <osigma/oconnection_index.hpp>
+#include <osigma/ograph.hpp>
+
+namespace ograph {
+
+// A mapped POSIX shared memory object. The creating process maps it writable and owns the name;
+// other processes attach read-only. Unmapping does not remove the name, see unlink().
+class SharedMemorySegment {
+
+public:
+    static SharedMemorySegment create(const std::string& name, size_t size)
+    {
+
+        int descriptor = shm_open(name.c_str(), O_CREAT | O_EXCL | O_RDWR, 0600);
+
+        if (descriptor < 0) {
+
+            throw std::runtime_error("Cannot create shared memory " + name + ": " + std::strerror(errno));
+        }
+
+        if (ftruncate(descriptor, off_t(size)) != 0) {
+
+            int error = errno;
+            close(descriptor);
+            shm_unlink(name.c_str());
+
+            throw std::runtime_error("Cannot size shared memory " + name + ": " + std::strerror(error));
+        }
+
+        return SharedMemorySegment(name, descriptor, size, true);
+    }
+
+    static SharedMemorySegment attach(const std::string& name)
+    {
+
+        int descriptor = shm_open(name.c_str(), O_RDONLY, 0);
+
+        if (descriptor < 0) {
+
+            throw std::runtime_error("Cannot open shared memory " + name + ": " + std::strerror(errno));
+        }
+
+        struct stat status;
+
+        if (fstat(descriptor, &status) != 0) {
+
+            int error = errno;
+            close(descriptor);
+
+            throw std::runtime_error("Cannot inspect shared memory " + name + ": " + std::strerror(error));
+        }
+
+        return SharedMemorySegment(name, descriptor, size_t(status.st_size), false);
+    }
+
+    static void unlink(const std::string& name)
+    {
+
+        shm_unlink(name.c_str());
+    }
+
+    SharedMemorySegment(const SharedMemorySegment&) = delete;
+    SharedMemorySegment& operator=(const SharedMemorySegment&) = delete;
+
+    SharedMemorySegment(SharedMemorySegment&& other) noexcept
+        : m_name(std::move(other.m_name))
+        , m_data(std::exchange(other.m_data, nullptr))
+        , m_size(std::exchange(other.m_size, 0))
+        , m_writable(other.m_writable)
+    {
+    }
+
+    ~SharedMemorySegment()
+    {
+
+        if (m_data != nullptr) {
+
+            munmap(m_data, m_size);
+        }
+    }
+
+    const std::string& name() const
+    {
+
+        return m_name;
+    }
+
+    size_t size() const
+    {
+
+        return m_size;
+    }
+
+    bool is_writable() const
+    {
+
+        return m_writable;
+    }
+
+    const std::byte* data() const
+    {
+
+        return (const std::byte*)m_data;
+    }
+
+    std::byte* writable_data()
+    {
+
+        if (!m_writable) {
+
+            throw std::logic_error("Shared memory " + m_name + " is attached read-only");
+        }
+
+        return (std::byte*)m_data;
+    }
+
+    std::string describe() const
+    {
+
+        return "SharedMemorySegment(" + m_name + ", " + std::to_string(m_size) + " bytes, " + (m_writable ? "writable" : "read-only") + ")";
+    }
+
+private:
+    std::string m_name;
+    void* m_data = nullptr;
+    size_t m_size = 0;
+    bool m_writable;
+
+    explicit SharedMemorySegment(std::string name, int descriptor, size_t size, bool writable)
+        : m_name(std::move(name))
+        , m_size(size)
+        , m_writable(writable)
+    {
+
+        // The mapping keeps the object alive, so the descriptor is not needed after mapping it
+        void* data = size == 0 ? nullptr : mmap(nullptr, size, writable ? PROT_READ | PROT_WRITE : PROT_READ, MAP_SHARED, descriptor, 0);
+        close(descriptor);
+
+        if (data == MAP_FAILED) {
+
+            throw std::runtime_error("Cannot map shared memory " + m_name + ": " + std::strerror(errno));
+        }
+
+        m_data = data;
+    }
+};
+
+// Type code of a column element: 'i', 'u' or 'f' followed by the size in bytes
+template <typename T>
+constexpr uint16_t shared_column_type()
+{
+
+    return uint16_t((std::is_floating_point_v<T> ? 'f' : std::is_signed_v<T> ? 'i' : 'u') << 8) | uint16_t(sizeof(T));
+}
+
+// Layout: magic, column count, then one entry per column (name, type code, element count, byte offset),
+// then the columns, each aligned to 64 bytes
+inline constexpr char SHARED_GRAPH_MAGIC[8] = { 'G', 'I', 'N', 'V', 'S', 'M', '0', '1' };
+
+// The magic as the 64-bit word that is stored last when publishing
+inline uint64_t shared_graph_magic()
+{
+
+    uint64_t magic;
+    std::memcpy(&magic, SHARED_GRAPH_MAGIC, sizeof(magic));
+
+    return magic;
+}
+
+class SharedColumnEntry {
+
+public:
+    char m_name[46];
+    uint16_t m_type;
+    uint64_t m_count;
+    uint64_t m_offset;
+};
+
+// Collects named columns and publishes them into one shared memory segment
+class SharedGraphBuilder {
+
+public:
+    static constexpr size_t ALIGNMENT = 64;
+
+    explicit SharedGraphBuilder()
+    {
+    }
+
+    template <typename T>
+    SharedGraphBuilder& add_column(const std::string& name, std::span<const T> values)
+    {
+
+        if (name.size() >= sizeof(SharedColumnEntry::m_name)) {
+
+            throw std::invalid_argument("Shared column name " + name + " is too long");
+        }
+
+        m_columns.emplace_back(name, shared_column_type<T>(), values.size(), (const std::byte*)values.data(), values.size_bytes());
+
+        return *this;
+    }
+
+    template <typename TColumn>
+    SharedGraphBuilder& add_column(const std::string& name, const TColumn& column)
+    {
+
+        return add_column(name, std::span<const typename TColumn::value_type>(column.data(), column.size()));
+    }
+
+    // The segment stays named until SharedMemorySegment::unlink, also after the returned mapping is gone
+    SharedMemorySegment publish(const std::string& segment_name) const
+    {
+
+        size_t header_size = sizeof(SHARED_GRAPH_MAGIC) + sizeof(uint64_t) + m_columns.size() * sizeof(SharedColumnEntry);
+        std::vector<SharedColumnEntry> entries(m_columns.size());
+        size_t size = align(header_size);
+
+        for (size_t i = 0; i < m_columns.size(); i++) {
+
+            auto& [name, type, count, data, byte_count] = m_columns[i];
+
+            std::memset(entries[i].m_name, 0, sizeof(entries[i].m_name));
+            std::memcpy(entries[i].m_name, name.data(), name.size());
+            entries[i].m_type = type;
+            entries[i].m_count = count;
+            entries[i].m_offset = size;
+
+            size = align(size + byte_count);
+        }
+
+        SharedMemorySegment segment = SharedMemorySegment::create(segment_name, size);
+        std::byte* target = segment.writable_data();
+        uint64_t column_count = m_columns.size();
+
+        // Columns first, then the table, and the magic last: a reader that sees the magic sees the complete segment
+        for (size_t i = 0; i < m_columns.size(); i++) {
+
+            if (std::get<4>(m_columns[i]) > 0) {
+
+                std::memcpy(target + entries[i].m_offset, std::get<3>(m_columns[i]), std::get<4>(m_columns[i]));
+            }
+        }
+
+        std::memcpy(target + sizeof(SHARED_GRAPH_MAGIC), &column_count, sizeof(column_count));
+        std::memcpy(target + sizeof(SHARED_GRAPH_MAGIC) + sizeof(column_count), entries.data(), entries.size() * sizeof(SharedColumnEntry));
+        std::atomic_ref<uint64_t>(*(uint64_t*)target).store(shared_graph_magic(), std::memory_order_release);
+
+        return segment;
+    }
+
+private:
+    std::vector<std::tuple<std::string, uint16_t, size_t, const std::byte*, size_t>> m_columns;
+
+    static size_t align(size_t offset)
+    {
+
+        return (offset + ALIGNMENT - 1) / ALIGNMENT * ALIGNMENT;
+    }
+};
+
+// Read-only, zero-copy view of the columns of an attached segment
+class SharedGraphView {
+
+public:
+    explicit SharedGraphView(SharedMemorySegment segment)
+        : m_segment(std::move(segment))
+    {
+
+        const std::byte* data = m_segment.data();
+        size_t size = m_segment.size();
+        uint64_t column_count = 0;
+        size_t header_size = sizeof(SHARED_GRAPH_MAGIC) + sizeof(column_count);
+
+        if (size < header_size || std::atomic_ref<uint64_t>(*(uint64_t*)data).load(std::memory_order_acquire) != shared_graph_magic()) {
+
+            throw std::runtime_error(m_segment.name() + " does not hold a shared graph");
+        }
+
+        std::memcpy(&column_count, data + sizeof(SHARED_GRAPH_MAGIC), sizeof(column_count));
+
+        if (column_count > (size - header_size) / sizeof(SharedColumnEntry)) {
+
+            throw std::runtime_error(m_segment.name() + " has a column table past its end");
+        }
+
+        m_entries.resize(column_count);
+        std::memcpy(m_entries.data(), data + header_size, column_count * sizeof(SharedColumnEntry));
+
+        for (auto& entry : m_entries) {
+
+            size_t element_size = entry.m_type & 0xff;
+
+            if (std::memchr(entry.m_name, 0, sizeof(entry.m_name)) == nullptr) {
+
+                throw std::runtime_error(m_segment.name() + " has a column without a name");
+            }
+
+            if (element_size == 0 || entry.m_offset > size || entry.m_offset % element_size != 0 || entry.m_count > (size - entry.m_offset) / element_size) {
+
+                throw std::runtime_error("Shared column " + std::string(entry.m_name) + " lies outside of " + m_segment.name());
+            }
+        }
+    }
+
+    static SharedGraphView attach(const std::string& segment_name)
+    {
+
+        return SharedGraphView(SharedMemorySegment::attach(segment_name));
+    }
+
+    bool has_column(const std::string& name) const
+    {
+
+        return find(name) != nullptr;
+    }
+
+    size_t column_size(const std::string& name) const
+    {
+
+        const SharedColumnEntry* entry = find(name);
+
+        if (entry == nullptr) {
+
+            throw std::out_of_range(m_segment.name() + " has no column " + name);
+        }
+
+        return entry->m_count;
+    }
+
+    // Nodes of a graph published with publish_graph
+    size_t node_count() const
+    {
+
+        return column_size("x");
+    }
+
+    template <typename T>
+    std::span<const T> column(const std::string& name) const
+    {
+
+        const SharedColumnEntry* entry = find(name);
+
+        if (entry == nullptr) {
+
+            throw std::out_of_range(m_segment.name() + " has no column " + name);
+        }
+
+        if (entry->m_type != shared_column_type<T>()) {
+
+            throw std::invalid_argument("Shared column " + name + " holds other elements");
+        }
+
+        return std::span<const T>((const T*)(m_segment.data() + entry->m_offset), entry->m_count);
+    }
+
+    std::vector<std::string> column_names() const
+    {
+
+        std::vector<std::string> result;
+
+        for (auto& entry : m_entries) {
+
+            result.emplace_back(entry.m_name);
+        }
+
+        return result;
+    }
+
+    const SharedMemorySegment& segment() const
+    {
+
+        return m_segment;
+    }
+
+    std::string describe() const
+    {
+
+        return "SharedGraphView(" + std::to_string(m_entries.size()) + " columns in " + m_segment.describe() + ")";
+    }
+
+private:
+    SharedMemorySegment m_segment;
+    std::vector<SharedColumnEntry> m_entries;
+
+    const SharedColumnEntry* find(const std::string& name) const
+    {
+
+        for (auto& entry : m_entries) {
+
+            if (name == entry.m_name) {
+
+                return &entry;
+            }
+        }
+
+        return nullptr;
+    }
+};
+
+// Publishes the node and connection columns of a graph as x, y, z_index, feature_<i>, from, to, values and
+// connection_z_index, and with `with_index` also the derived columns: the undirected CSR as index_offsets,
+// index_neighbours and index_values. Further columns can be added to `builder` beforehand.
+template <
+    template <typename> typename TAllocator,
+    typename TId,
+    typename TConnectionWeight,
+    typename TCoordinates,
+    typename TZIndex,
+    typename... TNodeFeatures>
+SharedMemorySegment publish_graph(
+    const std::string& segment_name,
+    const BasicOGraph<TAllocator, TId, TConnectionWeight, TCoordinates, TZIndex, TNodeFeatures...>& graph,
+    bool with_index = true,
+    SharedGraphBuilder builder = SharedGraphBuilder())
+{
+
+    builder.add_column("x", graph.m_nodes.m_x_coordinates);
+    builder.add_column("y", graph.m_nodes.m_y_coordinates);
+    builder.add_column("z_index", graph.m_nodes.m_z_index);
+
+    [&]<size_t... indices>(std::index_sequence<indices...>) {
+        (builder.add_column("feature_" + std::to_string(indices), std::get<indices>(graph.m_nodes.m_features)), ...);
+    }(std::index_sequence_for<TNodeFeatures...>());
+
+    builder.add_column("from", graph.m_connections.m_from);
+    builder.add_column("to", graph.m_connections.m_to);
+    builder.add_column("values", graph.m_connections.m_values);
+    builder.add_column("connection_z_index", graph.m_connections.m_z_index);
+
+    if (!with_index) {
+
+        return builder.publish(segment_name);
+    }
+
+    auto index = create_connection_index(graph.node_count(), graph.m_connections, ConnectionDirection::Both);
+    std::vector<uint64_t> offsets(index.m_offsets.begin(), index.m_offsets.end());
+
+    builder.add_column("index_offsets", offsets);
+    builder.add_column("index_neighbours", index.m_neighbours);
+    builder.add_column("index_values", index.m_values);
+
+    return builder.publish(segment_name);
+}
+}
+
+#endif
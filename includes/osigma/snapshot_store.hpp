@@ -0,0 +1,281 @@
+#ifndef SNAPSHOT_STORE_HPP_
+#define SNAPSHOT_STORE_HPP_
+
+#include <algorithm>
+#include <cstdint>
+#include <memory>
+#include <numeric>
+#include <span>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include <osigma/oconnections.hpp>
+#include <osigma/ograph.hpp>
+#include <osigma/onodes.hpp>
+
+namespace ograph {
+
+// Snapshots of the connections of a fixed node set over periods. The base connections are stored once;
+// every period stores only its delta to the base: added and changed connections with their values and
+// removed connections, sorted by (from, to). Connections are keyed by (from, to) and parallel connections
+// of a snapshot are summed. A base close to the typical snapshot, e.g. the first one, keeps deltas small.
+template <template <typename> typename TAllocator, typename TId, typename TValue>
+class BasicSnapshotStore {
+
+public:
+    template <typename T>
+    using TColumn = std::vector<T, TAllocator<T>>;
+
+    typedef BasicOConnections<TAllocator, TId, TValue> Connections;
+
+    size_t m_node_count;
+    Connections m_base;
+    std::vector<size_t> m_delta_offsets;
+    TColumn<TId> m_delta_from;
+    TColumn<TId> m_delta_to;
+    TColumn<TValue> m_delta_values;
+    TColumn<uint8_t> m_delta_removed;
+
+    explicit BasicSnapshotStore(size_t node_count, const Connections& base)
+        : m_node_count(node_count)
+        , m_base(normalize(node_count, base))
+        , m_delta_offsets { 0 }
+    {
+    }
+
+    size_t period_count() const
+    {
+
+        return m_delta_offsets.size() - 1;
+    }
+
+    size_t delta_size(size_t period) const
+    {
+
+        return m_delta_offsets.at(period + 1) - m_delta_offsets.at(period);
+    }
+
+    // Stores the delta of a snapshot to the base and returns its period
+    size_t add_period(const Connections& snapshot)
+    {
+
+        Connections normal = normalize(m_node_count, snapshot);
+        size_t base_position = 0;
+        size_t position = 0;
+        size_t base_count = m_base.m_from.size();
+        size_t count = normal.m_from.size();
+
+        auto add_delta = [&](TId from, TId to, TValue value, bool removed) {
+            m_delta_from.push_back(from);
+            m_delta_to.push_back(to);
+            m_delta_values.push_back(value);
+            m_delta_removed.push_back(removed);
+        };
+
+        while (base_position < base_count || position < count) {
+
+            int order = base_position == base_count ? 1
+                : position == count                 ? -1
+                                                    : compare(m_base, base_position, normal, position);
+
+            if (order < 0) {
+
+                add_delta(m_base.m_from[base_position], m_base.m_to[base_position], TValue(), true);
+                base_position++;
+            } else if (order > 0) {
+
+                add_delta(normal.m_from[position], normal.m_to[position], normal.m_values[position], false);
+                position++;
+            } else {
+
+                if (m_base.m_values[base_position] != normal.m_values[position]) {
+
+                    add_delta(normal.m_from[position], normal.m_to[position], normal.m_values[position], false);
+                }
+
+                base_position++;
+                position++;
+            }
+        }
+
+        m_delta_offsets.push_back(m_delta_from.size());
+
+        return period_count() - 1;
+    }
+
+    // Connections of one period, sorted by (from, to)
+    Connections materialize(size_t period) const
+    {
+
+        return materialize_window(period, period + 1);
+    }
+
+    // Connections present in any period of [begin, end) with their values summed over the window
+    Connections materialize_window(size_t begin, size_t end) const
+    {
+
+        if (begin >= end || end > period_count()) {
+
+            throw std::out_of_range("Snapshot window [" + std::to_string(begin) + ", " + std::to_string(end) + ") is outside of "
+                + std::to_string(period_count()) + " periods");
+        }
+
+        // Delta entries of the window ordered by key; a base connection not named by a period keeps its base value there
+        std::vector<size_t> entries(m_delta_offsets[end] - m_delta_offsets[begin]);
+        std::iota(entries.begin(), entries.end(), m_delta_offsets[begin]);
+
+        if (end - begin > 1) {
+
+            std::stable_sort(entries.begin(), entries.end(), [&](size_t a, size_t b) {
+                return m_delta_from[a] < m_delta_from[b] || (m_delta_from[a] == m_delta_from[b] && m_delta_to[a] < m_delta_to[b]);
+            });
+        }
+
+        Connections result { TColumn<TId>(), TColumn<TId>(), TColumn<TValue>() };
+        size_t period_count = end - begin;
+        size_t base_position = 0;
+        size_t position = 0;
+        size_t base_count = m_base.m_from.size();
+
+        result.m_from.reserve(base_count + entries.size());
+        result.m_to.reserve(base_count + entries.size());
+        result.m_values.reserve(base_count + entries.size());
+
+        while (base_position < base_count || position < entries.size()) {
+
+            TId from;
+            TId to;
+            TValue value = TValue();
+            size_t named_periods = 0;
+            bool present = false;
+
+            if (position == entries.size()
+                || (base_position < base_count && key_less(m_base.m_from[base_position], m_base.m_to[base_position], m_delta_from[entries[position]], m_delta_to[entries[position]]))) {
+
+                from = m_base.m_from[base_position];
+                to = m_base.m_to[base_position];
+            } else {
+
+                from = m_delta_from[entries[position]];
+                to = m_delta_to[entries[position]];
+            }
+
+            for (; position < entries.size() && m_delta_from[entries[position]] == from && m_delta_to[entries[position]] == to; position++) {
+
+                named_periods++;
+
+                if (!m_delta_removed[entries[position]]) {
+
+                    value += m_delta_values[entries[position]];
+                    present = true;
+                }
+            }
+
+            if (base_position < base_count && m_base.m_from[base_position] == from && m_base.m_to[base_position] == to) {
+
+                if (named_periods < period_count) {
+
+                    value += TValue(period_count - named_periods) * m_base.m_values[base_position];
+                    present = true;
+                }
+
+                base_position++;
+            }
+
+            if (present) {
+
+                result.m_from.push_back(from);
+                result.m_to.push_back(to);
+                result.m_values.push_back(value);
+            }
+        }
+
+        return result;
+    }
+
+    // The nodes with the connections of a window, with z-indices of 0
+    template <typename TCoordinates, typename TZIndex, typename... TNodeFeatures>
+    BasicOGraph<TAllocator, TId, TValue, TCoordinates, TZIndex, TNodeFeatures...> materialize_graph(
+        const BasicOSpatialNodes<TAllocator, TCoordinates, TZIndex, TNodeFeatures...>& nodes, size_t begin, size_t end) const
+    {
+
+        Connections connections = materialize_window(begin, end);
+        size_t count = connections.m_from.size();
+
+        return BasicOGraph<TAllocator, TId, TValue, TCoordinates, TZIndex, TNodeFeatures...>(
+            nodes,
+            BasicOSpatialConnections<TAllocator, TId, TValue, TZIndex>(
+                std::move(connections.m_from), std::move(connections.m_to), std::move(connections.m_values), TColumn<TZIndex>(count)));
+    }
+
+    size_t delta_entry_count() const
+    {
+
+        return m_delta_from.size();
+    }
+
+    std::string describe() const
+    {
+
+        return "SnapshotStore(" + std::to_string(period_count()) + " periods of " + std::to_string(m_node_count) + " nodes, "
+            + std::to_string(m_base.m_from.size()) + " base connections and " + std::to_string(delta_entry_count()) + " delta entries)";
+    }
+
+    // private:
+    static bool key_less(TId from_a, TId to_a, TId from_b, TId to_b)
+    {
+
+        return from_a < from_b || (from_a == from_b && to_a < to_b);
+    }
+
+    static int compare(const Connections& a, size_t i, const Connections& b, size_t j)
+    {
+
+        return key_less(a.m_from[i], a.m_to[i], b.m_from[j], b.m_to[j]) ? -1 : key_less(b.m_from[j], b.m_to[j], a.m_from[i], a.m_to[i]) ? 1 : 0;
+    }
+
+    // Sorted by (from, to) with parallel connections summed
+    static Connections normalize(size_t node_count, const Connections& connections)
+    {
+
+        size_t count = connections.m_from.size();
+        std::vector<size_t> order(count);
+        std::iota(order.begin(), order.end(), size_t(0));
+
+        for (size_t i = 0; i < count; i++) {
+
+            if (size_t(connections.m_from[i]) >= node_count || size_t(connections.m_to[i]) >= node_count) {
+
+                throw std::out_of_range("Snapshot connection " + std::to_string(i) + " is out of the node range");
+            }
+        }
+
+        std::stable_sort(order.begin(), order.end(), [&](size_t a, size_t b) {
+            return key_less(connections.m_from[a], connections.m_to[a], connections.m_from[b], connections.m_to[b]);
+        });
+
+        Connections result { TColumn<TId>(), TColumn<TId>(), TColumn<TValue>() };
+
+        for (size_t i : order) {
+
+            if (!result.m_from.empty() && result.m_from.back() == connections.m_from[i] && result.m_to.back() == connections.m_to[i]) {
+
+                result.m_values.back() += connections.m_values[i];
+            } else {
+
+                result.m_from.push_back(connections.m_from[i]);
+                result.m_to.push_back(connections.m_to[i]);
+                result.m_values.push_back(connections.m_values[i]);
+            }
+        }
+
+        return result;
+    }
+};
+
+template <typename TId, typename TValue>
+using SnapshotStore = BasicSnapshotStore<std::allocator, TId, TValue>;
+}
+
+#endif
@@ -1,3 +1,5 @@
+#include <chrono>
+#include <cstdint>
 #include <iostream>
 #include <tuple>
 #include <vector>
@@ -5,7 +7,9 @@
 #include <fstream>
 
 #include <ginv/clustering/clauset_newman_moore.hpp>
+#include <ginv/clustering/community_labels.hpp>
 #include <ginv/clustering/decaying_max_heap.hpp>
+#include <ginv/clustering/instrumentation.hpp>
 #include <ginv/istanbul_ein_dataset.hpp>
 #include <osigma/oconnections.hpp>
 #include <osigma/ograph.hpp>
@@ -73,15 +77,84 @@ void create_communities(size_t node_count=0, std::string data_path = "./data/ist
     auto communities = clustering::greedy_modularity_communities<float>(istanbul_dataset, 1.0f, 1, true);
     
 
+    auto labels = clustering::create_community_labels(istanbul_dataset.node_count(), communities);
+
     std::ofstream file("./communities_" + std::to_string(node_count) + ".txt");
-    clustering::display_communities(communities, false, file);
-    clustering::display_communities(communities, true, file);
+    clustering::write_communities_text(labels, file, false);
+    clustering::write_communities_text(labels, file, true);
     file.close();
+
+    clustering::write_community_labels(labels, "./communities_" + std::to_string(node_count) + ".bin");
+}
+
+template <typename TMergeHeap>
+void benchmark_merge_heap(std::string name, const ograph::OGraph<int32_t, float, float, uint8_t, float>& graph)
+{
+
+    clustering::ClusteringStats stats;
+
+    auto start = std::chrono::steady_clock::now();
+    auto communities = clustering::greedy_modularity_communities<float, TMergeHeap>(
+        graph, 1.0f, 1, false, -2605, 0, clustering::StatsInstrumentation(stats));
+    std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+
+    std::cout << name << ": " << communities.size() << " communities in " << elapsed.count() << "s, "
+              << stats.phase_seconds(clustering::ClusteringPhase::Merges) << "s merging" << std::endl;
+    std::cout << "    " << stats.describe() << std::endl;
+}
+
+// Clusters a random graph of dense groups with both merge heap modes
+void benchmark_merge_heaps(size_t node_count, size_t connection_count, size_t group_size = 50)
+{
+
+    ograph::OGraph<int32_t, float, float, uint8_t, float> graph(
+        ograph::OSpatialNodes<float, uint8_t, float>(
+            std::vector<float>(0 + node_count),
+            std::vector<float>(node_count),
+            std::vector<uint8_t>(node_count),
+            std::vector<float>(node_count)),
+        ograph::OSpatialConnections<int32_t, float, uint8_t>(
+            std::vector<int32_t>(connection_count),
+            std::vector<int32_t>(connection_count),
+            std::vector<float>(connection_count, 1),
+            std::vector<uint8_t>(connection_count)));
+
+    uint64_t seed = 2605;
+
+    auto next_random = [&seed]() {
+
+        seed = seed * 6364136223846793005ULL + 1442695040888963407ULL;
+        return size_t(seed >> 33);
+    };
+
+    for (size_t i = 0; i < connection_count; i++) {
+
+        size_t from = next_random() % node_count;
+        size_t to = (i % 8 == 0) ? next_random() % node_count : std::min(node_count - 1, (from / group_size) * group_size + next_random() % group_size);
+
+        graph.m_connections.m_from[i] = int32_t(from);
+        graph.m_connections.m_to[i] = int32_t(to == from ? (from + 1) % node_count : to);
+    }
+
+    std::cout << graph.describe() << std::endl;
+
+    benchmark_merge_heap<clustering::ExactMergeHeap>("exact merge heap", graph);
+    benchmark_merge_heap<clustering::LazyMergeHeap>("lazy merge heap", graph);
 }
 
 int main(int argc, char** argv)
 {
 
+    if (argc > 1 && std::string(argv[1]) == "benchmark-merge-heaps") {
+
+        size_t node_count = argc > 2 ? std::stoul(argv[2]) : 20000;
+        size_t connection_count = argc > 3 ? std::stoul(argv[3]) : 8 * node_count;
+
+        benchmark_merge_heaps(node_count, connection_count);
+
+        return 0;
+    }
+
     create_communities(1000);
 
     return 0;
@@ -0,0 +1,79 @@
+#ifndef RANDOM_TEST_GRAPH_HPP_
+#define RANDOM_TEST_GRAPH_HPP_
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include <osigma/ograph.hpp>
+
+// The linear congruential generator of the randomized tests, so a seed draws the same values in every test
+class TestRandom {
+
+public:
+    explicit TestRandom(uint32_t seed)
+        : m_seed(seed)
+    {
+    }
+
+    uint32_t next()
+    {
+
+        m_seed = m_seed * 1664525u + 1013904223u;
+
+        return m_seed;
+    }
+
+    // Drops the low bits, which repeat with short periods
+    uint32_t below(size_t bound)
+    {
+
+        return uint32_t((next() >> 8) % bound);
+    }
+
+    std::string describe() const
+    {
+
+        return "TestRandom(" + std::to_string(m_seed) + ")";
+    }
+
+private:
+    uint32_t m_seed;
+};
+
+// Appends `connection_count` connections between random nodes below `node_count`
+inline void add_random_test_connections(TestRandom& random, size_t node_count, size_t connection_count, std::vector<int32_t>& from, std::vector<int32_t>& to)
+{
+
+    for (size_t i = 0; i < connection_count; i++) {
+
+        from.push_back(int32_t(random.below(node_count)));
+        to.push_back(int32_t(random.below(node_count)));
+    }
+}
+
+// A graph of the connections with every node at the origin; the connection weights are 1 when `values` is empty
+template <typename... TNodeFeatures>
+ograph::OGraph<int32_t, float, float, uint8_t, TNodeFeatures...> create_test_graph(
+    size_t node_count,
+    std::vector<int32_t> from,
+    std::vector<int32_t> to,
+    std::vector<float> values = {},
+    std::vector<TNodeFeatures>... features)
+{
+
+    if (values.empty()) {
+
+        values.resize(from.size(), 1);
+    }
+
+    size_t connection_count = from.size();
+
+    return ograph::OGraph<int32_t, float, float, uint8_t, TNodeFeatures...>(
+        ograph::OSpatialNodes<float, uint8_t, TNodeFeatures...>(std::vector<float>(0 + node_count), std::vector<float>(node_count), std::vector<uint8_t>(node_count), std::move(features)...),
+        ograph::OSpatialConnections<int32_t, float, uint8_t>(std::move(from), std::move(to), std::move(values), std::vector<uint8_t>(connection_count)));
+}
+
+#endif
@@ -0,0 +1,49 @@
+#include <ginv/centrality/betweenness_centrality.hpp>
+#include <gtest/gtest.h>
+#include <cstdint>
+#include <vector>
+
+TEST(CentralityBetweennessCentrality, IsExactWhenSamplingEveryNode)
+{
+
+    // A path 0 - 1 - 2 - 3 - 4 and a separate edge 5 - 6
+    ograph::OConnections<int32_t, float> connections(
+        std::vector<int32_t> { 0, 1, 2, 3, 5 },
+        std::vector<int32_t> { 1, 2, 3, 4, 6 },
+        std::vector<float>(5, 1));
+
+    auto both = ograph::create_connection_index(7, connections, ograph::ConnectionDirection::Both);
+
+    EXPECT_EQ((std::vector<double> { 0, 3, 4, 3, 0, 0, 0 }), centrality::sampled_betweenness_centrality<double>(both, 7, 1, 3));
+
+    auto outgoing = ograph::create_connection_index(7, connections);
+
+    EXPECT_EQ((std::vector<double> { 0, 3, 4, 3, 0, 0, 0 }), centrality::sampled_betweenness_centrality<double>(outgoing, 100, 1, 1));
+}
+
+TEST(CentralityBetweennessCentrality, EstimatesFromSampledSources)
+{
+
+    // A star with center 0 lies on every path between leaves
+    size_t leaf_count = 200;
+    std::vector<int32_t> from(leaf_count, 0);
+    std::vector<int32_t> to(leaf_count);
+
+    for (size_t i = 0; i < leaf_count; i++) {
+
+        to[i] = int32_t(i + 1);
+    }
+
+    ograph::OConnections<int32_t, float> connections(from, to, std::vector<float>(leaf_count, 1));
+    auto both = ograph::create_connection_index(leaf_count + 1, connections, ograph::ConnectionDirection::Both);
+
+    auto estimate = centrality::sampled_betweenness_centrality<double>(both, 50, 7, 2);
+    double exact = double(leaf_count) * double(leaf_count - 1) / 2;
+
+    EXPECT_NEAR(exact, estimate[0], 0.1 * exact);
+
+    for (size_t i = 1; i <= leaf_count; i++) {
+
+        EXPECT_EQ(0, estimate[i]);
+    }
+}
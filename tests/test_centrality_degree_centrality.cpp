@@ -0,0 +1,19 @@
+#include <ginv/centrality/degree_centrality.hpp>
+#include <gtest/gtest.h>
+#include <cstdint>
+#include <vector>
+
+TEST(CentralityDegreeCentrality, SumsConnectionWeights)
+{
+
+    ograph::OConnections<int32_t, float> connections(
+        std::vector<int32_t> { 0, 0, 2, 3 },
+        std::vector<int32_t> { 1, 2, 1, 0 },
+        std::vector<float> { 1, 2, 3, 4 });
+
+    auto both = ograph::create_connection_index(5, connections, ograph::ConnectionDirection::Both);
+    auto outgoing = ograph::create_connection_index(5, connections);
+
+    EXPECT_EQ((std::vector<float> { 7, 4, 5, 4, 0 }), centrality::weighted_degree_centrality<float>(both, false));
+    EXPECT_EQ((std::vector<float> { 0.75f, 0, 0.75f, 1, 0 }), centrality::weighted_degree_centrality<float>(outgoing, true, 2));
+}
@@ -0,0 +1,54 @@
+#include <ginv/centrality/pagerank.hpp>
+#include <gtest/gtest.h>
+#include "random_test_graph.hpp"
+#include <cstdint>
+#include <vector>
+
+ograph::OGraph<int32_t, float, float, uint8_t, float> create_pagerank_test_graph()
+{
+
+    return create_test_graph(5, { 0, 0, 1, 2, 3 }, { 1, 2, 2, 0, 2 }, { 1, 2, 1, 1, 1 }, std::vector<float>(5));
+}
+
+TEST(CentralityPagerank, RanksWeightedDirectedGraph)
+{
+
+    auto g = create_pagerank_test_graph();
+    auto [ranks, iterations] = centrality::pagerank<double>(g, true, 0.85, 1e-12, 1000, 1);
+
+    auto target = std::vector { 0.379741364821582, 0.143737965012701, 0.404231513539210, 0.036144578313253, 0.036144578313253 };
+
+    ASSERT_EQ(target.size(), ranks.size());
+    EXPECT_LT(iterations, 1000);
+
+    for (size_t i = 0; i < target.size(); i++) {
+
+        EXPECT_NEAR(target[i], ranks[i], 1e-9);
+    }
+
+    auto [multi_thread_ranks, multi_thread_iterations] = centrality::pagerank<double>(g, true, 0.85, 1e-12, 1000, 3);
+
+    for (size_t i = 0; i < target.size(); i++) {
+
+        EXPECT_NEAR(ranks[i], multi_thread_ranks[i], 1e-12);
+    }
+}
+
+TEST(CentralityPagerank, WritesRanksIntoFeatureColumn)
+{
+
+    auto g = create_pagerank_test_graph();
+    auto [ranks, iterations] = centrality::pagerank<float>(g, false);
+
+    ograph::assign_feature_column<0>(g.m_nodes, ranks);
+
+    float sum = 0;
+
+    for (auto rank : std::get<0>(g.m_nodes.m_features)) {
+
+        sum += rank;
+    }
+
+    EXPECT_NEAR(1.0f, sum, 1e-5f);
+    EXPECT_EQ(ranks, std::get<0>(g.m_nodes.m_features));
+}
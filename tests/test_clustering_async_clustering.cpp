@@ -0,0 +1,42 @@
+#include <ginv/clustering/async_clustering.hpp>
+#include <gtest/gtest.h>
+#include "random_test_graph.hpp"
+#include <cstdint>
+#include <future>
+#include <vector>
+
+TEST(ClusteringAsyncClustering, MatchesBlockingRunsOfManySmallGraphs)
+{
+
+    typedef ograph::OGraph<int32_t, float, float, uint8_t> Graph;
+
+    std::vector<Graph> graphs;
+    TestRandom random(3);
+
+    for (size_t g = 0; g < 24; g++) {
+
+        size_t node_count = 20 + g;
+        std::vector<int32_t> from;
+        std::vector<int32_t> to;
+
+        add_random_test_connections(random, node_count, 3 * node_count, from, to);
+        graphs.push_back(create_test_graph(node_count, from, to));
+    }
+
+    parallel::WorkStealingPool pool(4);
+    std::vector<std::future<std::vector<std::vector<int32_t>>>> futures;
+
+    for (auto& graph : graphs) {
+
+        futures.push_back(clustering::greedy_modularity_communities_async<float>(graph, 1.0f, 1, pool));
+    }
+
+    for (size_t g = 0; g < graphs.size(); g++) {
+
+        EXPECT_EQ(clustering::greedy_modularity_communities<float>(graphs[g]), futures[g].get()) << g;
+    }
+
+    auto lazy = clustering::greedy_modularity_communities_async<float, clustering::LazyMergeHeap>(graphs[0]);
+
+    EXPECT_FALSE(lazy.get().empty());
+}
@@ -1,5 +1,7 @@
+#include <algorithm>
 #include <ginv/clustering/clauset_newman_moore.hpp>
 #include <gtest/gtest.h>
+#include "random_test_graph.hpp"
 #include <iostream>
 #include <tuple>
 #include <vector>
@@ -385,3 +387,60 @@ TEST(ClusteringClausetNewmanMoore, CombinesAllNodesOfTwoBigFullGraphsInParallel)
 
     EXPECT_EQ(2, communities.size());
 }
+
+TEST(ClusteringClausetNewmanMoore, CreatesSameCommunitiesWithAnyThreadCount)
+{
+
+    ograph::OGraph<int32_t, float, float, uint8_t, float> g(
+        ograph::OSpatialNodes<float, uint8_t, float>(
+            std::vector<float>(8),
+            std::vector<float>(8),
+            std::vector<uint8_t>(8),
+            std::vector<float>(8)),
+        ograph::OSpatialConnections<int32_t, float, uint8_t>(
+            std::vector<int32_t> { 0, 0, 1, 2, 4, 4, 5, 6, 3 },
+            std::vector<int32_t> { 1, 2, 2, 3, 5, 6, 6, 7, 4 },
+            std::vector<float> { 1, 1, 1, 1, 2, 2, 2, 1, 1 },
+            std::vector<uint8_t>(9)));
+
+    auto single_thread_communities = clustering::greedy_modularity_communities<float>(g, 1.0f, 1, false, -2605, 1);
+    auto multi_thread_communities = clustering::greedy_modularity_communities<float>(g, 1.0f, 1, false, -2605, 4);
+
+    EXPECT_EQ(single_thread_communities, multi_thread_communities);
+}
+
+TEST(ClusteringClausetNewmanMoore, CreatesSameCommunitiesWithLazyMergeHeap)
+{
+    int node_count = 200;
+    int connection_count = 1000;
+    std::vector<int32_t> from_ids;
+    std::vector<int32_t> to_ids;
+    TestRandom random(7);
+
+    for (int t = 0; t < connection_count; t++) {
+
+        int from = random.below(node_count);
+        int to = (t % 4 == 0) ? random.below(node_count) : (from / 20) * 20 + random.below(20);
+
+        from_ids.push_back(from);
+        to_ids.push_back(to == from ? (from + 1) % node_count : to);
+    }
+
+    auto g = create_test_graph(node_count, from_ids, to_ids);
+
+    auto exact_communities = clustering::greedy_modularity_communities<float>(g);
+    auto lazy_communities = clustering::greedy_modularity_communities<float, clustering::LazyMergeHeap>(g);
+
+    // Equal gains may be merged in another order, so only the partitions are compared
+    auto normalize = [](std::vector<std::vector<int32_t>> communities) {
+        for (auto& community : communities) {
+            std::sort(community.begin(), community.end());
+        }
+
+        std::sort(communities.begin(), communities.end());
+
+        return communities;
+    };
+
+    EXPECT_EQ(normalize(exact_communities), normalize(lazy_communities));
+}
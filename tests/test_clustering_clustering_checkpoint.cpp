@@ -0,0 +1,144 @@
+#include <ginv/clustering/clauset_newman_moore.hpp>
+#include <ginv/clustering/clustering_checkpoint.hpp>
+#include <gtest/gtest.h>
+#include "random_test_graph.hpp"
+#include <cstdint>
+#include <filesystem>
+#include <fstream>
+#include <string>
+#include <vector>
+
+ograph::OGraph<int32_t, float, float, uint8_t> create_checkpoint_test_graph()
+{
+
+    std::vector<int32_t> from;
+    std::vector<int32_t> to;
+    std::vector<float> values;
+    TestRandom random(23);
+    size_t node_count = 120;
+
+    for (size_t i = 0; i < 4 * node_count; i++) {
+
+        from.push_back(int32_t(random.below(node_count)));
+        to.push_back(int32_t(random.below(node_count)));
+        values.push_back(1.0f + float(random.below(1000)) / 100.0f);
+    }
+
+    return create_test_graph(node_count, from, to, values);
+}
+
+TEST(ClusteringClusteringCheckpoint, ResumesAnInterruptedRunToTheSameCommunities)
+{
+
+    auto g = create_checkpoint_test_graph();
+    auto path = (std::filesystem::temp_directory_path() / "ginv_test_clustering_checkpoint.bin").string();
+    std::filesystem::remove(path);
+
+    clustering::RunControl<float> complete_control;
+    auto expected = clustering::greedy_modularity_communities<float>(g, 1.0f, 1, false, -2605, 1, clustering::NoInstrumentation(), &complete_control);
+
+    // Preempted after 40 merges, with a checkpoint every 15
+    clustering::RunControl<float> interrupted_control;
+    interrupted_control.with_step_budget(40);
+    clustering::CheckpointSettings settings(path, 15);
+
+    auto partial = clustering::greedy_modularity_communities<float>(g, 1.0f, 1, false, -2605, 1, clustering::NoInstrumentation(), &interrupted_control, &settings);
+
+    EXPECT_EQ(interrupted_control.m_stop_reason, clustering::StopReason::StepBudget);
+    EXPECT_EQ(settings.m_written, 3u);
+    EXPECT_EQ(partial.size(), 80u);
+
+    auto state = clustering::read_clustering_checkpoint<float, int32_t>(path);
+
+    EXPECT_EQ(state.m_steps, 40u);
+    EXPECT_EQ(state.m_community_count, 80u);
+    EXPECT_EQ(state.m_delta_q.size(), 80u);
+    EXPECT_FLOAT_EQ(state.m_modularity, interrupted_control.m_modularity);
+
+    EXPECT_FALSE(state.m_row_heap_keys.empty());
+    EXPECT_EQ(state.m_merge_heap.m_kind, clustering::ExactMergeHeap::CHECKPOINT_KIND);
+
+    // The heap orders are restored, so ties between equal delta Q values are broken as in the uninterrupted run
+    clustering::RunControl<float> resumed_control;
+    clustering::CheckpointSettings resumed_settings(path, 1000000);
+
+    auto resumed = clustering::resume_greedy_modularity_communities<float, int32_t>(path, 1, 1, &resumed_control, &resumed_settings);
+
+    EXPECT_EQ(expected, resumed);
+    EXPECT_EQ(resumed_control.m_stop_reason, clustering::StopReason::Converged);
+    EXPECT_EQ(resumed_control.m_steps, complete_control.m_steps);
+    EXPECT_EQ(resumed_control.m_community_count, resumed.size());
+    EXPECT_EQ(resumed_control.m_modularity, complete_control.m_modularity);
+    EXPECT_EQ(resumed_settings.m_written, 0u);
+
+    auto lazy_expected = clustering::greedy_modularity_communities<float, clustering::LazyMergeHeap>(g, 1.0f, 1, false, -2605, 1);
+    clustering::RunControl<float> lazy_control;
+    lazy_control.with_step_budget(40);
+    clustering::CheckpointSettings lazy_settings(path);
+
+    clustering::greedy_modularity_communities<float, clustering::LazyMergeHeap>(g, 1.0f, 1, false, -2605, 1, clustering::NoInstrumentation(), &lazy_control, &lazy_settings);
+
+    EXPECT_EQ(lazy_settings.m_written, 1u);
+    EXPECT_EQ(lazy_expected, (clustering::resume_greedy_modularity_communities<float, int32_t, clustering::LazyMergeHeap>(path, 1, 1)));
+
+    EXPECT_THROW((clustering::read_clustering_checkpoint<double, int32_t>(path)), std::invalid_argument);
+
+    std::filesystem::resize_file(path, std::filesystem::file_size(path) / 2);
+
+    EXPECT_THROW((clustering::read_clustering_checkpoint<float, int32_t>(path)), std::runtime_error);
+
+    std::filesystem::remove(path);
+}
+
+TEST(ClusteringClusteringCheckpoint, RejectsIdsOutsideOfTheNodes)
+{
+
+    auto path = (std::filesystem::temp_directory_path() / "ginv_test_clustering_checkpoint_ids.bin").string();
+
+    clustering::ClusteringState<float, int32_t> state;
+    state.m_a = { 0.25f, 0.25f, 0.5f };
+    state.m_communities = { { 0, 1 }, {}, { 2 } };
+    state.m_delta_q[0][2] = 0.1f;
+    state.m_delta_q[2][0] = 0.1f;
+    state.m_community_count = 2;
+    state.m_merge_heap.m_kind = clustering::ExactMergeHeap::CHECKPOINT_KIND;
+    state.m_merge_heap.m_rows = { 0, 2 };
+    state.m_merge_heap.m_keys = { 2, 0 };
+    state.m_merge_heap.m_values = { 0.1f, 0.1f };
+
+    clustering::write_clustering_checkpoint(state, path);
+
+    EXPECT_EQ((clustering::read_clustering_checkpoint<float, int32_t>(path).m_merge_heap.m_rows), state.m_merge_heap.m_rows);
+
+    auto corrupted = state;
+    corrupted.m_communities[2] = { 3 };
+    clustering::write_clustering_checkpoint(corrupted, path);
+
+    EXPECT_THROW((clustering::read_clustering_checkpoint<float, int32_t>(path)), std::runtime_error);
+
+    corrupted = state;
+    corrupted.m_delta_q[2][-1] = 0.1f;
+    clustering::write_clustering_checkpoint(corrupted, path);
+
+    EXPECT_THROW((clustering::read_clustering_checkpoint<float, int32_t>(path)), std::runtime_error);
+
+    corrupted = state;
+    corrupted.m_merge_heap.m_rows = { 0, 7 };
+    clustering::write_clustering_checkpoint(corrupted, path);
+
+    EXPECT_THROW((clustering::read_clustering_checkpoint<float, int32_t>(path)), std::runtime_error);
+
+    // A lazy heap element whose row has no version
+    corrupted = state;
+    corrupted.m_merge_heap.m_kind = clustering::LazyMergeHeap::CHECKPOINT_KIND;
+    corrupted.m_merge_heap.m_versions = { 1, 1 };
+    corrupted.m_merge_heap.m_row_versions = { 1 };
+    corrupted.m_merge_heap.m_row_keys = { 2 };
+    corrupted.m_merge_heap.m_row_values = { 0.1f };
+    corrupted.m_merge_heap.m_row_live = { 1 };
+    clustering::write_clustering_checkpoint(corrupted, path);
+
+    EXPECT_THROW((clustering::read_clustering_checkpoint<float, int32_t>(path)), std::runtime_error);
+
+    std::filesystem::remove(path);
+}
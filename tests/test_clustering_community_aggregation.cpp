@@ -0,0 +1,70 @@
+#include <ginv/clustering/community_aggregation.hpp>
+#include <gtest/gtest.h>
+#include <cstdint>
+#include <vector>
+
+TEST(ClusteringCommunityAggregation, AggregatesEveryFeatureColumn)
+{
+
+    ograph::ONodes<int32_t, float, float, uint8_t> nodes(
+        std::vector<int32_t> { 1, 2, 3, 4, 5, 6 },
+        std::vector<float> { 0.5f, 0.1f, 0.9f, 0.3f, 0.2f, 0.7f },
+        std::vector<float> { 10, 20, 30, 40, 50, 60 },
+        std::vector<uint8_t> { 200, 100, 200, 100, 1, 2 });
+
+    auto labels = clustering::create_community_labels<int32_t>(6, std::vector {
+                                                                       std::vector<int32_t> { 4, 0, 2 },
+                                                                       std::vector<int32_t> {},
+                                                                       std::vector<int32_t> { 1, 3, 5 },
+                                                                   });
+
+    auto aggregated = clustering::aggregate_communities<
+        clustering::SumAggregation, clustering::MaxAggregation, clustering::MeanAggregation, clustering::MinAggregation>(labels, nodes);
+
+    EXPECT_EQ((std::vector<int64_t> { 9, 0, 12 }), std::get<0>(aggregated.m_features));
+    EXPECT_EQ((std::vector<float> { 0.9f, 0.0f, 0.7f }), std::get<1>(aggregated.m_features));
+    EXPECT_EQ((std::vector<double> { 30, 0, 40 }), std::get<2>(aggregated.m_features));
+    EXPECT_EQ((std::vector<uint8_t> { 1, 0, 2 }), std::get<3>(aggregated.m_features));
+
+    auto summed = clustering::aggregate_communities(labels, nodes);
+
+    EXPECT_EQ((std::vector<uint64_t> { 401, 0, 202 }), std::get<3>(summed.m_features));
+}
+
+TEST(ClusteringCommunityAggregation, SplitsWorkByMembersAcrossThreads)
+{
+
+    size_t node_count = 50000;
+    std::vector<int32_t> values(node_count);
+    std::vector<std::vector<int32_t>> communities(7);
+
+    for (size_t i = 0; i < node_count; i++) {
+
+        values[i] = int32_t(i % 11);
+        communities[i < node_count / 2 ? 0 : 1 + i % 6].push_back(int32_t(i));
+    }
+
+    auto labels = clustering::create_community_labels<int32_t>(node_count, communities);
+    ograph::ONodes<int32_t> nodes(values);
+
+    auto single_thread = clustering::aggregate_communities(labels, nodes, 1);
+    auto multi_thread = clustering::aggregate_communities(labels, nodes, 8);
+
+    EXPECT_EQ(std::get<0>(single_thread.m_features), std::get<0>(multi_thread.m_features));
+
+    int64_t total = 0;
+
+    for (auto sum : std::get<0>(multi_thread.m_features)) {
+
+        total += sum;
+    }
+
+    int64_t target = 0;
+
+    for (auto value : values) {
+
+        target += value;
+    }
+
+    EXPECT_EQ(target, total);
+}
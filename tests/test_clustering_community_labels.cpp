@@ -0,0 +1,108 @@
+#include <ginv/clustering/clauset_newman_moore.hpp>
+#include <ginv/clustering/community_labels.hpp>
+#include <gtest/gtest.h>
+#include <cstring>
+#include <sstream>
+#include <stdexcept>
+#include <vector>
+
+TEST(ClusteringCommunityLabels, LabelsNodesAndListsMembers)
+{
+
+    auto communities = std::vector {
+        std::vector<int32_t> { 4, 2 },
+        std::vector<int32_t> { 0, 1, 3 },
+    };
+
+    auto labels = clustering::create_community_labels<int32_t>(6, communities);
+
+    EXPECT_EQ(2, labels.community_count());
+    EXPECT_EQ((std::vector<int32_t> { 1, 1, 0, 1, 0, clustering::CommunityLabels<int32_t>::NO_COMMUNITY }), labels.m_labels);
+    EXPECT_EQ((std::vector<size_t> { 0, 2, 5 }), labels.m_offsets);
+    EXPECT_EQ(3, labels.community_size(1));
+    EXPECT_EQ(communities, labels.to_communities());
+}
+
+TEST(ClusteringCommunityLabels, WritesAndReadsBinary)
+{
+
+    auto communities = std::vector {
+        std::vector<int32_t> { 4, 2 },
+        std::vector<int32_t> {},
+        std::vector<int32_t> { 0, 1, 3 },
+    };
+
+    auto labels = clustering::create_community_labels<int32_t>(6, communities);
+
+    std::stringstream stream;
+    clustering::write_community_labels(labels, stream);
+
+    auto restored = clustering::read_community_labels<int32_t>(stream);
+
+    EXPECT_EQ(labels.m_labels, restored.m_labels);
+    EXPECT_EQ(labels.m_offsets, restored.m_offsets);
+    EXPECT_EQ(labels.m_members, restored.m_members);
+
+    std::stringstream wide_stream(stream.str());
+    EXPECT_THROW(clustering::read_community_labels<int64_t>(wide_stream), std::runtime_error);
+
+    std::stringstream truncated_stream(stream.str().substr(0, stream.str().size() - 2));
+    EXPECT_THROW(clustering::read_community_labels<int32_t>(truncated_stream), std::runtime_error);
+}
+
+TEST(ClusteringCommunityLabels, RejectsMalformedBinary)
+{
+
+    auto labels = clustering::create_community_labels<int32_t>(6, std::vector { std::vector<int32_t> { 4, 2 }, std::vector<int32_t> { 0 }, std::vector<int32_t> { 1, 3 } });
+
+    std::stringstream stream;
+    clustering::write_community_labels(labels, stream);
+
+    // Offsets 0, 2, 3, 5 follow the magic and the four header words, the members follow the offsets
+    size_t offsets_position = sizeof(clustering::COMMUNITY_LABELS_MAGIC) + 4 * sizeof(uint64_t);
+    size_t members_position = offsets_position + 4 * sizeof(uint64_t);
+
+    auto read_patched = [&](size_t position, auto value) {
+        std::string bytes = stream.str();
+        std::memcpy(bytes.data() + position, &value, sizeof(value));
+        std::stringstream patched(bytes);
+
+        return clustering::read_community_labels<int32_t>(patched);
+    };
+
+    EXPECT_NO_THROW(read_patched(members_position, int32_t(5)));
+    EXPECT_THROW(read_patched(offsets_position, uint64_t(1)), std::runtime_error);
+    EXPECT_THROW(read_patched(offsets_position + sizeof(uint64_t), uint64_t(4)), std::runtime_error);
+    EXPECT_THROW(read_patched(offsets_position + sizeof(uint64_t), uint64_t(9)), std::runtime_error);
+    EXPECT_THROW(read_patched(members_position, int32_t(6)), std::runtime_error);
+    EXPECT_THROW(read_patched(members_position, int32_t(-1)), std::runtime_error);
+}
+
+TEST(ClusteringCommunityLabels, FormatsAsDisplayCommunities)
+{
+
+    std::vector<std::vector<int32_t>> communities;
+
+    for (int32_t i = 0; i < 3000; i++) {
+
+        std::vector<int32_t> community;
+
+        for (int32_t q = 0; q < i % 7; q++) {
+
+            community.push_back(10 * i + q);
+        }
+
+        communities.push_back(community);
+    }
+
+    auto labels = clustering::create_community_labels<int32_t>(30000, communities);
+
+    for (bool show_size : { false, true }) {
+
+        std::stringstream target;
+        clustering::display_communities(communities, show_size, target);
+
+        EXPECT_EQ(target.str(), clustering::format_communities(labels, show_size, 4));
+        EXPECT_EQ(target.str(), clustering::format_communities(labels, show_size, 1));
+    }
+}
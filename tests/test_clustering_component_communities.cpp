@@ -0,0 +1,79 @@
+#include <ginv/clustering/component_communities.hpp>
+#include <gtest/gtest.h>
+#include "random_test_graph.hpp"
+#include <algorithm>
+#include <vector>
+
+std::vector<std::vector<int32_t>> normalize_communities(std::vector<std::vector<int32_t>> communities)
+{
+
+    for (auto& community : communities) {
+
+        std::sort(community.begin(), community.end());
+    }
+
+    std::sort(communities.begin(), communities.end());
+
+    return communities;
+}
+
+TEST(ClusteringComponentCommunities, ResolvesSingletonsAndPairsWithoutHeaps)
+{
+
+    auto g = create_test_graph(5, { 2 }, { 3 }, { 1 });
+
+    auto target = std::vector {
+        std::vector { 0 },
+        std::vector { 1 },
+        std::vector { 3, 2 },
+        std::vector { 4 },
+    };
+
+    auto communities = clustering::greedy_modularity_communities_by_components<float>(g);
+
+    EXPECT_EQ(target, communities);
+}
+
+TEST(ClusteringComponentCommunities, MatchesWholeGraphClusteringOfSeparateComponents)
+{
+
+    auto g = create_test_graph(
+        12,
+        { 0, 1, 2, 3, 5, 5, 6, 7, 8, 10 },
+        { 1, 2, 3, 4, 6, 7, 7, 8, 9, 11 },
+        { 1, 1, 1, 1, 2, 2, 2, 1, 1, 3 });
+
+    auto target = clustering::greedy_modularity_communities<float>(g);
+    auto communities = clustering::greedy_modularity_communities_by_components<float>(g, 1.0f, false, -2605, 4);
+
+    EXPECT_EQ(normalize_communities(target), normalize_communities(communities));
+}
+
+TEST(ClusteringComponentCommunities, CombinesAllNodesOfTwoFullGraphsInParallel)
+{
+    int node_count_a = 26;
+    int node_count_b = 5;
+
+    std::vector<int32_t> from;
+    std::vector<int32_t> to;
+
+    for (int i = 0; i < node_count_a; i++) {
+        for (int j = 0; j < i; j++) {
+            from.push_back(i);
+            to.push_back(j);
+        }
+    }
+
+    for (int i = 0; i < node_count_b; i++) {
+        for (int j = 0; j < i; j++) {
+            from.push_back(i + node_count_a);
+            to.push_back(j + node_count_a);
+        }
+    }
+
+    auto g = create_test_graph(node_count_a + node_count_b, from, to);
+
+    auto communities = clustering::greedy_modularity_communities_by_components<float>(g, 1.0f, false, -2605, 2);
+
+    EXPECT_EQ(2, communities.size());
+}
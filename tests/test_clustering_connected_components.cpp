@@ -0,0 +1,44 @@
+#include <ginv/clustering/connected_components.hpp>
+#include <gtest/gtest.h>
+#include <vector>
+
+TEST(ClusteringConnectedComponents, LabelsComponentsByTheirSmallestNode)
+{
+
+    ograph::OConnections<int32_t, float> connections(
+        std::vector<int32_t> { 5, 3, 6, 2, 4 },
+        std::vector<int32_t> { 1, 5, 6, 7, 7 },
+        std::vector<float> { 1, 1, 1, 1, 1 });
+
+    auto components = clustering::connected_components(8, connections, 4);
+
+    ASSERT_EQ(4, components.component_count());
+    EXPECT_EQ((std::vector<int32_t> { 0, 1, 2, 1, 2, 1, 3, 2 }), components.m_labels);
+    EXPECT_EQ((std::vector<int32_t> { 0 }), std::vector<int32_t>(components.component_nodes(0).begin(), components.component_nodes(0).end()));
+    EXPECT_EQ((std::vector<int32_t> { 1, 3, 5 }), std::vector<int32_t>(components.component_nodes(1).begin(), components.component_nodes(1).end()));
+    EXPECT_EQ((std::vector<int32_t> { 2, 4, 7 }), std::vector<int32_t>(components.component_nodes(2).begin(), components.component_nodes(2).end()));
+    EXPECT_EQ((std::vector<int32_t> { 6 }), std::vector<int32_t>(components.component_nodes(3).begin(), components.component_nodes(3).end()));
+}
+
+TEST(ClusteringConnectedComponents, FindsSameComponentsWithAnyThreadCount)
+{
+    int node_count = 10000;
+
+    std::vector<int32_t> from;
+    std::vector<int32_t> to;
+
+    for (int i = 0; i + 7 < node_count; i += 3) {
+
+        from.push_back(i);
+        to.push_back(i + 7);
+    }
+
+    ograph::OConnections<int32_t, float> connections(from, to, std::vector<float>(from.size(), 1));
+
+    auto single_thread_components = clustering::connected_components(node_count, connections, 1);
+    auto multi_thread_components = clustering::connected_components(node_count, connections, 8);
+
+    EXPECT_EQ(single_thread_components.m_labels, multi_thread_components.m_labels);
+    EXPECT_EQ(single_thread_components.m_offsets, multi_thread_components.m_offsets);
+    EXPECT_EQ(single_thread_components.m_nodes, multi_thread_components.m_nodes);
+}
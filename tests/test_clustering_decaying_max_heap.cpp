@@ -3,6 +3,7 @@
 #include <tuple>
 #include <vector>
 #include <iostream>
+#include <type_traits>
 
 TEST(ClusteringDecayingMaxHeap, MaxSortedPopsSingleKey)
 {
@@ -182,3 +183,100 @@ TEST(ClusteringDecayingMaxHeap, UpdatesValues)
         EXPECT_EQ(target[i], result[i]);
     }
 }
+
+TEST(ClusteringDecayingMaxHeap, MaxSortedPopsBulkConstructed)
+{
+
+    clustering::DecayingMaxHeap<float, uint8_t, int32_t> heap(
+        std::vector<uint8_t> { 11, 14, 10, 13, 12, 15 },
+        std::vector<int32_t> { 21, 24, 20, 23, 22, 25 },
+        std::vector<float> { 1.0f, 4.0f, 0.0f, 3.0f, 2.0f, -1.0f });
+
+    auto target = std::vector {
+        std::make_tuple(14, 24, 4.0f),
+        std::make_tuple(13, 23, 3.0f),
+        std::make_tuple(12, 22, 2.0f),
+        std::make_tuple(11, 21, 1.0f),
+        std::make_tuple(10, 20, 0.0f),
+        std::make_tuple(15, 25, -1.0f),
+    };
+
+    std::vector<std::tuple<uint8_t, int32_t, float>> result;
+
+    while (heap.size() > 0) {
+
+        result.push_back(heap.pop());
+    }
+
+    ASSERT_EQ(target.size(), result.size());
+
+    for (size_t i = 0; i < result.size(); i++) {
+
+        EXPECT_EQ(target[i], result[i]);
+    }
+}
+
+TEST(ClusteringDecayingMaxHeap, BulkConstructedHeapTracksPositions)
+{
+
+    clustering::DecayingMaxHeap<float, uint8_t> heap(
+        std::vector<uint8_t> { 10, 11, 12, 13, 14 },
+        std::vector<float> { 0.0f, 1.0f, 2.0f, 3.0f, 4.0f });
+
+    auto target = std::vector {
+        std::make_tuple(11, 5.0f),
+        std::make_tuple(12, 2.0f),
+        std::make_tuple(10, 0.0f),
+    };
+
+    heap.remove(13);
+    heap.update_value(11, 5.0f);
+    heap.remove(14);
+
+    std::vector<std::tuple<uint8_t, float>> result;
+
+    while (heap.size() > 0) {
+
+        result.push_back(heap.pop());
+    }
+
+    ASSERT_EQ(target.size(), result.size());
+
+    for (size_t i = 0; i < result.size(); i++) {
+
+        EXPECT_EQ(target[i], result[i]);
+    }
+}
+
+TEST(ClusteringDecayingMaxHeap, PacksSmallIntegerKeysIntoSingleWord)
+{
+
+    static_assert(clustering::packable_keys<int32_t, int32_t>);
+    static_assert(clustering::packable_keys<uint8_t, uint8_t, int32_t>);
+    static_assert(!clustering::packable_keys<int32_t>);
+    static_assert(!clustering::packable_keys<int64_t, int32_t>);
+    static_assert(!clustering::packable_keys<float, int32_t>);
+
+    typedef clustering::PackedKeyStorage<int32_t, int32_t> Storage;
+
+    auto keys = std::make_tuple(int32_t(-7), int32_t(2147483647));
+
+    EXPECT_EQ(keys, Storage::load(Storage::store(keys)));
+    EXPECT_NE(Storage::store(std::make_tuple(1, 2)), Storage::store(std::make_tuple(2, 1)));
+
+    clustering::DecayingMaxHeap<float, int32_t, int32_t> heap(10);
+
+    static_assert(std::is_same_v<std::vector<uint64_t>, decltype(heap.m_heap_keys.m_keys)>);
+
+    heap.push(-1, 3, 1.0f);
+    heap.push(4, -2, 3.0f);
+    heap.push(0, 0, 2.0f);
+
+    heap.update_value(-1, 3, 4.0f);
+    heap.remove(0, 0);
+
+    EXPECT_EQ(std::make_tuple(-1, 3, 4.0f), heap.pop());
+    EXPECT_EQ(std::make_tuple(4, -2, 3.0f), heap.pop());
+    EXPECT_EQ(0, heap.size());
+    EXPECT_THROW(heap.remove(0, 0), std::out_of_range);
+}
@@ -0,0 +1,98 @@
+#include <ginv/clustering/graph_reduction.hpp>
+#include <gtest/gtest.h>
+#include "random_test_graph.hpp"
+#include <algorithm>
+#include <vector>
+
+TEST(ClusteringGraphReduction, RemovesIsolatedNodesAndAbsorbsPairs)
+{
+
+    auto g = create_test_graph(5, { 2 }, { 3 }, { 1 });
+
+    auto target = std::vector {
+        std::vector { 0 },
+        std::vector { 1 },
+        std::vector { 3, 2 },
+        std::vector { 4 },
+    };
+
+    auto communities = clustering::greedy_modularity_communities_with_reduction<float>(g);
+
+    EXPECT_EQ(target, communities);
+}
+
+TEST(ClusteringGraphReduction, AbsorbsLeafChainsWhileModularityDoesNotDecrease)
+{
+
+    auto g = create_test_graph(5, { 0, 1, 2, 3 }, { 1, 2, 3, 4 }, { 1, 1, 1, 1 });
+
+    auto [a, reverse_m] = clustering::create_normal_weighted_degrees<float>(
+        5, std::span<const int32_t>(g.m_connections.m_from), std::span<const int32_t>(g.m_connections.m_to), std::span<const float>(g.m_connections.m_values));
+
+    auto reduction = clustering::reduce_graph<float, int32_t, float>(
+        5, std::span<const int32_t>(g.m_connections.m_from), std::span<const int32_t>(g.m_connections.m_to), std::span<const float>(g.m_connections.m_values),
+        a, reverse_m);
+
+    ASSERT_EQ(2, reduction.m_node_count);
+    EXPECT_EQ((std::vector<int32_t> { 2, 3 }), reduction.m_original_ids);
+    EXPECT_FLOAT_EQ(5.0f / 8, reduction.m_a[0]);
+    EXPECT_FLOAT_EQ(3.0f / 8, reduction.m_a[1]);
+
+    auto target = std::vector {
+        std::vector { 2, 0, 1 },
+        std::vector { 3, 4 },
+    };
+
+    auto communities = clustering::greedy_modularity_communities_with_reduction<float>(g);
+
+    EXPECT_EQ(target, communities);
+}
+
+TEST(ClusteringGraphReduction, KeepsCommunitySizesOfTwoFullGraphsWithLeaves)
+{
+    int node_count_a = 26;
+    int node_count_b = 5;
+    int leaf_count = 4;
+
+    std::vector<int32_t> from;
+    std::vector<int32_t> to;
+
+    for (int i = 0; i < node_count_a; i++) {
+        for (int j = 0; j < i; j++) {
+            from.push_back(i);
+            to.push_back(j);
+        }
+    }
+
+    for (int i = 0; i < node_count_b; i++) {
+        for (int j = 0; j < i; j++) {
+            from.push_back(i + node_count_a);
+            to.push_back(j + node_count_a);
+        }
+    }
+
+    for (int i = 0; i < leaf_count; i++) {
+        from.push_back(node_count_a + node_count_b + i);
+        to.push_back(i * 2);
+    }
+
+    auto g = create_test_graph(node_count_a + node_count_b + leaf_count, from, to);
+
+    auto community_sizes = [](auto communities) {
+        std::vector<size_t> sizes;
+
+        for (auto const& community : communities) {
+
+            sizes.push_back(community.size());
+        }
+
+        std::sort(sizes.begin(), sizes.end());
+
+        return sizes;
+    };
+
+    auto target = clustering::greedy_modularity_communities<float>(g);
+    auto communities = clustering::greedy_modularity_communities_with_reduction<float>(g);
+
+    EXPECT_EQ(community_sizes(target), community_sizes(communities));
+}
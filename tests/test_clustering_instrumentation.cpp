@@ -0,0 +1,65 @@
+#include <ginv/clustering/clauset_newman_moore.hpp>
+#include <ginv/clustering/decaying_max_heap.hpp>
+#include <ginv/clustering/instrumentation.hpp>
+#include <gtest/gtest.h>
+#include <map>
+#include <tuple>
+#include <type_traits>
+#include <vector>
+
+TEST(ClusteringInstrumentation, DisabledInstrumentationTakesNoSpace)
+{
+
+    EXPECT_TRUE(std::is_empty_v<clustering::NoInstrumentation>);
+    EXPECT_TRUE(std::is_empty_v<clustering::NoPhaseTimer>);
+    EXPECT_EQ(
+        sizeof(std::tuple<std::vector<int32_t>>) + sizeof(std::vector<float>) + sizeof(std::map<std::tuple<int32_t>, size_t>),
+        sizeof(clustering::DecayingMaxHeap<float, int32_t>));
+}
+
+TEST(ClusteringInstrumentation, CountsHeapSiftsAndMapLookups)
+{
+
+    clustering::ClusteringStats stats;
+    clustering::InstrumentedDecayingMaxHeap<clustering::StatsInstrumentation, float, uint8_t> heap(10, clustering::StatsInstrumentation(stats));
+
+    heap.push(10, 0.0f);
+    heap.push(11, 1.0f);
+    heap.push(12, 2.0f);
+
+    EXPECT_EQ(2, stats.m_sifts);
+    EXPECT_EQ(5, stats.m_map_lookups);
+
+    heap.remove(11);
+
+    EXPECT_EQ(7, stats.m_map_lookups);
+}
+
+TEST(ClusteringInstrumentation, CollectsClusteringStats)
+{
+
+    ograph::OGraph<int32_t, float, float, uint8_t, float> g(
+        ograph::OSpatialNodes<float, uint8_t, float>(
+            std::vector<float>(5),
+            std::vector<float>(5),
+            std::vector<uint8_t>(5),
+            std::vector<float>(5)),
+        ograph::OSpatialConnections<int32_t, float, uint8_t>(
+            std::vector<int32_t> { 2, 2, 1 },
+            std::vector<int32_t> { 3, 0, 4 },
+            std::vector<float> { 1, 1, 1 },
+            std::vector<uint8_t> { 0, 0, 0 }));
+
+    clustering::ClusteringStats stats;
+
+    auto communities = clustering::greedy_modularity_communities<float>(g, 1.0f, 1, false, -2605, 1, clustering::StatsInstrumentation(stats));
+    auto target = clustering::greedy_modularity_communities<float>(g);
+
+    EXPECT_EQ(target, communities);
+    EXPECT_EQ(3, stats.m_merges);
+    EXPECT_EQ(5, stats.m_rows);
+    EXPECT_EQ(6, stats.m_row_size_total);
+    EXPECT_EQ(2, stats.m_max_row_size);
+    EXPECT_GT(stats.m_map_lookups, 0);
+    EXPECT_GT(stats.m_phase_nanoseconds[size_t(clustering::ClusteringPhase::Merges)], 0);
+}
@@ -0,0 +1,89 @@
+#include <ginv/clustering/lazy_decaying_max_heap.hpp>
+#include <gtest/gtest.h>
+#include <stdexcept>
+#include <tuple>
+#include <vector>
+
+TEST(ClusteringLazyDecayingMaxHeap, MaxSortedPops)
+{
+
+    clustering::LazyDecayingMaxHeap<clustering::NoInstrumentation, float, int32_t, int32_t> heap(10);
+
+    heap.push(4, 24, 4.0f);
+    heap.push(1, 21, 1.0f);
+    heap.push(3, 23, 3.0f);
+    heap.push(0, 20, 0.0f);
+    heap.push(2, 22, 2.0f);
+
+    auto target = std::vector {
+        std::make_tuple(4, 24, 4.0f),
+        std::make_tuple(3, 23, 3.0f),
+        std::make_tuple(2, 22, 2.0f),
+        std::make_tuple(1, 21, 1.0f),
+        std::make_tuple(0, 20, 0.0f),
+    };
+
+    std::vector<std::tuple<int32_t, int32_t, float>> result;
+
+    while (heap.size() > 0) {
+
+        result.push_back(heap.pop());
+    }
+
+    EXPECT_EQ(target, result);
+}
+
+TEST(ClusteringLazyDecayingMaxHeap, SkipsRemovedAndReplacedRows)
+{
+
+    clustering::LazyDecayingMaxHeap<clustering::NoInstrumentation, float, int32_t, int32_t> heap(
+        std::vector<int32_t> { 0, 1, 2, 3 },
+        std::vector<int32_t> { 10, 11, 12, 13 },
+        std::vector<float> { 5.0f, 4.0f, 3.0f, 2.0f });
+
+    EXPECT_EQ(5.0f, heap.remove(0, 10));
+    EXPECT_THROW(heap.remove(0, 10), std::out_of_range);
+    EXPECT_THROW(heap.remove(1, 12), std::out_of_range);
+
+    heap.push(1, 21, 1.0f);
+    heap.push(3, 23, 6.0f);
+
+    EXPECT_EQ(3, heap.size());
+    EXPECT_EQ(6, heap.stored_size());
+
+    auto target = std::vector {
+        std::make_tuple(3, 23, 6.0f),
+        std::make_tuple(2, 12, 3.0f),
+        std::make_tuple(1, 21, 1.0f),
+    };
+
+    std::vector<std::tuple<int32_t, int32_t, float>> result;
+
+    while (heap.size() > 0) {
+
+        result.push_back(heap.pop());
+    }
+
+    EXPECT_EQ(target, result);
+}
+
+TEST(ClusteringLazyDecayingMaxHeap, CompactsWhenStaleElementsDominate)
+{
+
+    typedef clustering::LazyDecayingMaxHeap<clustering::StatsInstrumentation, float, int32_t, int32_t> Heap;
+
+    clustering::ClusteringStats stats;
+    Heap heap(0, clustering::StatsInstrumentation(stats));
+
+    size_t updates = 4 * Heap::MIN_COMPACTION_SIZE;
+
+    for (size_t i = 0; i < updates; i++) {
+
+        heap.push(int32_t(i % 3), int32_t(i), float(i));
+    }
+
+    EXPECT_EQ(3, heap.size());
+    EXPECT_GT(stats.m_compactions, 0);
+    EXPECT_LT(heap.stored_size(), 2 * Heap::MIN_COMPACTION_SIZE + 3);
+    EXPECT_EQ(std::make_tuple(int32_t((updates - 1) % 3), int32_t(updates - 1), float(updates - 1)), heap.pop());
+}
@@ -0,0 +1,43 @@
+#include <ginv/clustering/modularity_adjacency.hpp>
+#include <gtest/gtest.h>
+#include <cstdint>
+#include <vector>
+
+TEST(ClusteringModularityAdjacency, SumsParallelConnectionsWithoutSelfConnections)
+{
+
+    std::vector<int32_t> from { 0, 1, 2, 0, 3, 2 };
+    std::vector<int32_t> to { 1, 0, 2, 2, 0, 0 };
+    std::vector<uint8_t> values { 1, 2, 7, 3, 4, 5 };
+
+    auto adjacency = clustering::create_modularity_adjacency<float, int32_t, uint8_t>(
+        4, std::span<const int32_t>(from), std::span<const int32_t>(to), std::span<const uint8_t>(values), std::vector<float>(4), 0.5f, 2);
+
+    EXPECT_EQ((std::vector<size_t> { 0, 3, 4, 5, 6 }), adjacency.m_offsets);
+    EXPECT_EQ((std::vector<int32_t> { 1, 2, 3, 0, 0, 0 }), adjacency.m_neighbours);
+    EXPECT_EQ((std::vector<float> { 3, 8, 4, 3, 8, 4 }), adjacency.m_weights);
+}
+
+TEST(ClusteringModularityAdjacency, ComputesModularityOfPartitions)
+{
+
+    // Two triangles joined by one connection
+    std::vector<int32_t> from { 0, 1, 2, 3, 4, 5, 0 };
+    std::vector<int32_t> to { 1, 2, 0, 4, 5, 3, 3 };
+    std::vector<float> values(7, 1.0f);
+    std::vector<float> a { 3, 2, 2, 3, 2, 2 };
+
+    for (auto& value : a) {
+
+        value /= 14.0f;
+    }
+
+    auto adjacency = clustering::create_modularity_adjacency<float, int32_t, float>(
+        6, std::span<const int32_t>(from), std::span<const int32_t>(to), std::span<const float>(values), a, 1.0f / 7);
+
+    std::vector<std::vector<int32_t>> triangles { { 0, 1, 2 }, { 3, 4, 5 } };
+
+    EXPECT_NEAR(6.0 / 7 - 2 * 0.25, clustering::modularity(adjacency, triangles), 1e-6);
+    EXPECT_NEAR(6.0 / 7 - 2 * 0.5 * 0.25, clustering::modularity(adjacency, triangles, 0.5f), 1e-6);
+    EXPECT_NEAR(0.0, clustering::modularity(adjacency, std::vector<std::vector<int32_t>> { { 0, 1, 2, 3, 4, 5 } }), 1e-6);
+}
@@ -0,0 +1,64 @@
+#include <ginv/clustering/resolution_sweep.hpp>
+#include <gtest/gtest.h>
+#include "random_test_graph.hpp"
+#include <cstdint>
+#include <vector>
+
+ograph::OGraph<int32_t, float, float, uint8_t> create_resolution_sweep_test_graph()
+{
+
+    // Cliques of 2 to 9 nodes in a ring, joined by single connections
+    std::vector<int32_t> from;
+    std::vector<int32_t> to;
+    int32_t first = 0;
+    int32_t previous_first = -1;
+
+    for (int32_t size = 2; size < 10; size++) {
+
+        for (int32_t i = 0; i < size; i++) {
+            for (int32_t j = 0; j < i; j++) {
+
+                from.push_back(first + i);
+                to.push_back(first + j);
+            }
+        }
+
+        if (previous_first >= 0) {
+
+            from.push_back(previous_first);
+            to.push_back(first);
+        }
+
+        previous_first = first;
+        first += size;
+    }
+
+    return create_test_graph(first, from, to);
+}
+
+TEST(ClusteringResolutionSweep, MatchesSeparateRunsPerResolution)
+{
+
+    auto g = create_resolution_sweep_test_graph();
+    std::vector<float> resolutions { 0.25f, 0.5f, 1.0f, 2.0f, 4.0f };
+
+    auto results = clustering::resolution_sweep(g, resolutions, 1, 3);
+
+    ASSERT_EQ(resolutions.size(), results.size());
+
+    for (size_t r = 0; r < resolutions.size(); r++) {
+
+        clustering::RunControl<float> run_control;
+        auto communities = clustering::greedy_modularity_communities<float>(
+            g, resolutions[r], 1, false, -2605.0f, 1, clustering::NoInstrumentation(), &run_control);
+
+        EXPECT_EQ(resolutions[r], results[r].m_resolution);
+        EXPECT_EQ(communities, results[r].m_communities) << resolutions[r];
+        EXPECT_EQ(run_control.m_steps, results[r].m_steps);
+        EXPECT_NEAR(run_control.m_modularity, results[r].m_modularity, 1e-4);
+    }
+
+    EXPECT_GE(results[0].m_communities.size(), 1u);
+    EXPECT_LE(results[0].m_communities.size(), results.back().m_communities.size());
+    EXPECT_NEAR(results[2].m_modularity, results[2].m_standard_modularity, 1e-9);
+}
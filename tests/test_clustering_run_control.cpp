@@ -0,0 +1,148 @@
+#include <ginv/clustering/clauset_newman_moore.hpp>
+#include <ginv/clustering/run_control.hpp>
+#include <gtest/gtest.h>
+#include "random_test_graph.hpp"
+#include <chrono>
+#include <span>
+#include <vector>
+
+ograph::OGraph<int32_t, float, float, uint8_t, float> create_run_control_test_graph()
+{
+
+    return create_test_graph(5, { 2, 2, 1 }, { 3, 0, 4 }, { 1, 1, 1 }, std::vector<float>(5));
+}
+
+TEST(ClusteringRunControl, ReportsProgressAndFinalModularity)
+{
+
+    auto g = create_run_control_test_graph();
+
+    std::vector<size_t> steps;
+    std::vector<size_t> community_counts;
+    std::vector<float> modularities;
+
+    clustering::RunControl<float> run_control([&](size_t step, float modularity, size_t community_count) {
+        steps.push_back(step);
+        modularities.push_back(modularity);
+        community_counts.push_back(community_count);
+    });
+
+    auto communities = clustering::greedy_modularity_communities<float>(g, 1.0f, 1, false, -2605, 1, clustering::NoInstrumentation(), &run_control);
+
+    EXPECT_EQ(clustering::greedy_modularity_communities<float>(g), communities);
+    EXPECT_EQ((std::vector<size_t> { 1, 2, 3 }), steps);
+    EXPECT_EQ((std::vector<size_t> { 4, 3, 2 }), community_counts);
+    EXPECT_LT(modularities[0], modularities[1]);
+    EXPECT_LE(modularities[1], modularities[2]);
+    EXPECT_NEAR(4.0f / 9, run_control.m_modularity, 1e-5);
+    EXPECT_EQ(clustering::StopReason::Converged, run_control.m_stop_reason);
+}
+
+TEST(ClusteringRunControl, StopsAtStepBudgetWithPartialPartition)
+{
+
+    auto g = create_run_control_test_graph();
+
+    clustering::RunControl<float> run_control;
+    run_control.with_step_budget(1);
+
+    auto communities = clustering::greedy_modularity_communities<float>(g, 1.0f, 1, false, -2605, 1, clustering::NoInstrumentation(), &run_control);
+
+    EXPECT_EQ(4, communities.size());
+    EXPECT_EQ(1, run_control.m_steps);
+    EXPECT_EQ(clustering::StopReason::StepBudget, run_control.m_stop_reason);
+}
+
+TEST(ClusteringRunControl, ReturnsSingletonsWhenCancelledOrOutOfTime)
+{
+
+    auto g = create_run_control_test_graph();
+
+    clustering::CancellationToken cancellation;
+    clustering::RunControl<float> cancelled_run_control;
+    cancelled_run_control.with_cancellation(cancellation);
+    cancellation.cancel();
+
+    auto cancelled_communities = clustering::greedy_modularity_communities<float>(g, 1.0f, 1, false, -2605, 1, clustering::NoInstrumentation(), &cancelled_run_control);
+
+    EXPECT_EQ(5, cancelled_communities.size());
+    EXPECT_EQ(clustering::StopReason::Cancelled, cancelled_run_control.m_stop_reason);
+
+    clustering::RunControl<float> timed_run_control;
+    timed_run_control.with_deadline(std::chrono::steady_clock::now() - std::chrono::seconds(1));
+
+    auto timed_communities = clustering::greedy_modularity_communities<float>(g, 1.0f, 1, false, -2605, 1, clustering::NoInstrumentation(), &timed_run_control);
+
+    EXPECT_EQ(5, timed_communities.size());
+    EXPECT_EQ(clustering::StopReason::TimeBudget, timed_run_control.m_stop_reason);
+}
+
+// Cancels the run when a phase starts, to stop it inside the phases before the first merge
+class CancellingInstrumentation : public clustering::NoInstrumentation {
+
+public:
+    clustering::ClusteringPhase m_phase;
+    clustering::CancellationToken m_cancellation;
+
+    explicit CancellingInstrumentation(clustering::ClusteringPhase phase, clustering::CancellationToken cancellation)
+        : m_phase(phase)
+        , m_cancellation(std::move(cancellation))
+    {
+    }
+
+    clustering::NoPhaseTimer time_phase(clustering::ClusteringPhase phase) const
+    {
+
+        if (phase == m_phase) {
+
+            m_cancellation.cancel();
+        }
+
+        return clustering::NoPhaseTimer();
+    }
+};
+
+TEST(ClusteringRunControl, StopsInsideThePhasesBeforeTheFirstMerge)
+{
+
+    auto g = create_run_control_test_graph();
+
+    for (auto phase : { clustering::ClusteringPhase::Degrees, clustering::ClusteringPhase::DeltaQ, clustering::ClusteringPhase::Heaps }) {
+
+        clustering::CancellationToken cancellation;
+        clustering::RunControl<float> run_control;
+        run_control.with_cancellation(cancellation);
+
+        auto communities = clustering::greedy_modularity_communities<float>(
+            g, 1.0f, 1, false, -2605, 1, CancellingInstrumentation(phase, cancellation), &run_control);
+
+        EXPECT_EQ(5, communities.size());
+        EXPECT_EQ(0, run_control.m_steps);
+        EXPECT_EQ(5, run_control.m_community_count);
+        EXPECT_EQ(clustering::StopReason::Cancelled, run_control.m_stop_reason);
+    }
+
+    clustering::CancellationToken cancellation;
+    clustering::RunControl<float> run_control;
+    run_control.with_cancellation(cancellation);
+    cancellation.cancel();
+
+    auto adjacency = clustering::create_modularity_adjacency<float, int32_t, float>(
+        g.node_count(), std::span<const int32_t>(g.m_connections.m_from), std::span<const int32_t>(g.m_connections.m_to),
+        std::span<const float>(g.m_connections.m_values), std::vector<float>(5), 1.0f, 1, &run_control);
+
+    EXPECT_TRUE(adjacency.m_neighbours.empty());
+}
+
+TEST(ClusteringRunControl, StopsAtCommunityCountCutoff)
+{
+
+    auto g = create_run_control_test_graph();
+
+    clustering::RunControl<float> run_control;
+
+    auto communities = clustering::greedy_modularity_communities<float>(g, 1.0f, 3, false, -2605, 1, clustering::NoInstrumentation(), &run_control);
+
+    EXPECT_EQ(3, communities.size());
+    EXPECT_EQ(clustering::StopReason::Cutoff, run_control.m_stop_reason);
+}
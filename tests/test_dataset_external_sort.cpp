@@ -0,0 +1,230 @@
+#include <ginv/external_sort.hpp>
+#include <ginv/schema_dataset.hpp>
+#include <gtest/gtest.h>
+#include "random_test_graph.hpp"
+#include <algorithm>
+#include <cstdint>
+#include <filesystem>
+#include <fstream>
+#include <map>
+#include <numeric>
+#include <string>
+#include <tuple>
+#include <vector>
+
+template <typename T>
+void write_external_sort_test_file(const std::string& file_name, const std::vector<T>& values)
+{
+
+    std::ofstream file(file_name, std::ios::out | std::ios::binary);
+    file.write((const char*)values.data(), values.size() * sizeof(T));
+}
+
+TEST(DatasetExternalSort, SortsAndSumsDuplicatesAcrossRuns)
+{
+
+    auto root = (std::filesystem::temp_directory_path() / "ginv_test_external_sort").string();
+    std::filesystem::remove_all(root);
+    std::filesystem::create_directories(root + "/input");
+
+    std::vector<int32_t> from;
+    std::vector<int32_t> to;
+    std::vector<uint8_t> values;
+    TestRandom random(17);
+
+    add_random_test_connections(random, 30, 1000, from, to);
+
+    for (size_t i = 0; i < 1000; i++) {
+
+        values.push_back(uint8_t(200 + i % 50));
+    }
+
+    std::ofstream(root + "/input/global_params.json") << R"({ "nodes": 30, "links": 1000, "name": "test" })";
+
+    write_external_sort_test_file(root + "/input/ein_from_0.bin", std::vector<int32_t>(from.begin(), from.begin() + 400));
+    write_external_sort_test_file(root + "/input/ein_from_1.bin", std::vector<int32_t>(from.begin() + 400, from.end()));
+    write_external_sort_test_file(root + "/input/ein_to_0.bin", std::vector<int32_t>(to.begin(), to.begin() + 700));
+    write_external_sort_test_file(root + "/input/ein_to_1.bin", std::vector<int32_t>(to.begin() + 700, to.end()));
+    write_external_sort_test_file(root + "/input/ein_value_0.bin", values);
+
+    for (auto& schema : dataset::istanbul_ein_schema()) {
+
+        if (schema.m_table == "nodes") {
+
+            write_external_sort_test_file(dataset::shard_file_name(root + "/input", schema, 0), std::vector<float>(30, 1.5f));
+        }
+    }
+
+    for (bool undirected : { false, true }) {
+
+        std::map<std::tuple<int32_t, int32_t>, uint32_t> expected;
+
+        for (size_t i = 0; i < from.size(); i++) {
+
+            expected[undirected ? std::make_tuple(std::min(from[i], to[i]), std::max(from[i], to[i])) : std::make_tuple(from[i], to[i])] += values[i];
+        }
+
+        dataset::ExternalSortSettings settings;
+        settings.m_run_size = 97;
+        settings.m_shard_size = 150;
+        settings.m_merge_buffer_size = 5;
+        settings.m_undirected = undirected;
+        settings.m_thread_count = 3;
+
+        std::string output = root + (undirected ? "/undirected" : "/directed");
+        auto result = dataset::external_sort_connections<int32_t, uint8_t, uint32_t>(root + "/input", output, settings);
+
+        EXPECT_EQ(result.m_input_connections, 1000u);
+        EXPECT_EQ(result.m_run_count, 11u);
+        EXPECT_EQ(result.m_merge_pass_count, 1u);
+        EXPECT_EQ(result.m_output_connections, expected.size());
+        EXPECT_EQ(result.m_shard_count, (expected.size() + 149) / 150);
+        EXPECT_FALSE(std::filesystem::exists(output + "/external_sort_run_0.bin"));
+
+        dataset::SchemaDataset sorted(output);
+
+        EXPECT_EQ(sorted.connection_count(), expected.size());
+        EXPECT_EQ(sorted.schema("value").m_type, "uint32");
+        EXPECT_EQ(sorted.column<float>("volume"), std::vector<float>(30, 1.5f));
+
+        auto& sorted_from = sorted.column<int32_t>("from");
+        auto& sorted_to = sorted.column<int32_t>("to");
+        auto& sorted_values = sorted.column<uint32_t>("value");
+        size_t i = 0;
+
+        for (auto& [connection, value] : expected) {
+
+            EXPECT_EQ(std::make_tuple(sorted_from[i], sorted_to[i]), connection) << i;
+            EXPECT_EQ(sorted_values[i], value) << i;
+            i++;
+        }
+    }
+
+    // The default sums are 64 bits wide, so repeated uint8 weights do not wrap
+    std::map<std::tuple<int32_t, int32_t>, uint64_t> expected;
+
+    for (size_t i = 0; i < from.size(); i++) {
+
+        expected[std::make_tuple(from[i], to[i])] += values[i];
+    }
+
+    dataset::external_sort_connections(root + "/input", root + "/wide");
+    dataset::SchemaDataset wide(root + "/wide");
+
+    EXPECT_EQ(wide.schema("value").m_type, "uint64");
+    EXPECT_GT(std::max_element(expected.begin(), expected.end(), [](auto& a, auto& b) { return a.second < b.second; })->second, 255u);
+    EXPECT_EQ(wide.column<uint64_t>("value")[0], expected.begin()->second);
+    EXPECT_EQ(std::accumulate(wide.column<uint64_t>("value").begin(), wide.column<uint64_t>("value").end(), uint64_t(0)),
+        std::accumulate(values.begin(), values.end(), uint64_t(0)));
+
+    EXPECT_THROW((dataset::external_sort_connections<int32_t, int32_t>(root + "/input", root + "/typed")), std::invalid_argument);
+    EXPECT_THROW(dataset::external_sort_connections(root + "/input", root + "/input"), std::invalid_argument);
+
+    std::filesystem::remove_all(root);
+}
+
+TEST(DatasetExternalSort, MergesInPassesAndShardsPatternsWithoutFileId)
+{
+
+    auto root = (std::filesystem::temp_directory_path() / "ginv_test_external_sort_passes").string();
+    std::filesystem::remove_all(root);
+    std::filesystem::create_directories(root + "/input");
+
+    std::vector<int32_t> from;
+    std::vector<int32_t> to;
+    std::vector<uint8_t> values;
+    std::map<std::tuple<int32_t, int32_t>, uint32_t> expected;
+
+    for (size_t i = 0; i < 600; i++) {
+
+        from.push_back(int32_t(i * 7 % 40));
+        to.push_back(int32_t(i * 13 % 40));
+        values.push_back(uint8_t(i % 200));
+        expected[std::make_tuple(from.back(), to.back())] += values.back();
+    }
+
+    std::ofstream(root + "/input/global_params.json") << R"({ "nodes": 40, "links": 600, "columns": [
+        { "name": "from", "table": "connections", "file": "from.bin", "type": "int32" },
+        { "name": "to", "table": "connections", "file": "to.bin", "type": "int32" },
+        { "name": "value", "table": "connections", "file": "value.bin", "type": "uint8" } ] })";
+
+    write_external_sort_test_file(root + "/input/from.bin", from);
+    write_external_sort_test_file(root + "/input/to.bin", to);
+    write_external_sort_test_file(root + "/input/value.bin", values);
+
+    dataset::ExternalSortSettings settings;
+    settings.m_run_size = 50;
+    settings.m_shard_size = 15;
+    settings.m_max_fan_in = 3;
+
+    auto result = dataset::external_sort_connections<int32_t, uint8_t, uint32_t>(root + "/input", root + "/output", settings);
+
+    EXPECT_EQ(result.m_run_count, 12u);
+    EXPECT_EQ(result.m_merge_pass_count, 3u);
+    EXPECT_EQ(result.m_output_connections, expected.size());
+    EXPECT_GT(result.m_shard_count, 1u);
+    EXPECT_TRUE(std::filesystem::exists(root + "/output/from_1.bin"));
+    EXPECT_FALSE(std::filesystem::exists(root + "/output/from.bin"));
+
+    dataset::SchemaDataset sorted(root + "/output");
+
+    EXPECT_EQ(sorted.schema("from").m_file, "from_${FILE_ID}.bin");
+    EXPECT_EQ(sorted.connection_count(), expected.size());
+
+    size_t i = 0;
+
+    for (auto& [connection, value] : expected) {
+
+        EXPECT_EQ(std::make_tuple(sorted.column<int32_t>("from")[i], sorted.column<int32_t>("to")[i]), connection) << i;
+        EXPECT_EQ(sorted.column<uint32_t>("value")[i], value) << i;
+        i++;
+    }
+
+    for (auto& entry : std::filesystem::directory_iterator(root + "/output")) {
+
+        EXPECT_EQ(entry.path().filename().string().find("external_sort_run_"), std::string::npos) << entry.path();
+    }
+
+    std::filesystem::remove_all(root);
+}
+
+TEST(DatasetExternalSort, RemovesTheRunFilesWhenTheSortFails)
+{
+
+    auto root = (std::filesystem::temp_directory_path() / "ginv_test_external_sort_failure").string();
+    std::filesystem::remove_all(root);
+    std::filesystem::create_directories(root + "/input");
+
+    std::ofstream(root + "/input/global_params.json") << R"({ "nodes": 10, "links": 99, "columns": [
+        { "name": "from", "table": "connections", "file": "from_${FILE_ID}.bin", "type": "int32" },
+        { "name": "to", "table": "connections", "file": "to_${FILE_ID}.bin", "type": "int32" },
+        { "name": "value", "table": "connections", "file": "value_${FILE_ID}.bin", "type": "uint8" } ] })";
+
+    write_external_sort_test_file(root + "/input/from_0.bin", std::vector<int32_t>(20, 1));
+    write_external_sort_test_file(root + "/input/to_0.bin", std::vector<int32_t>(20, 2));
+    write_external_sort_test_file(root + "/input/value_0.bin", std::vector<uint8_t>(20, 3));
+
+    dataset::ExternalSortSettings settings;
+    settings.m_run_size = 4;
+
+    EXPECT_THROW(dataset::external_sort_connections(root + "/input", root + "/output", settings), std::runtime_error);
+    EXPECT_TRUE(std::filesystem::is_empty(root + "/output"));
+
+    std::filesystem::remove_all(root);
+}
+
+TEST(DatasetExternalSort, SortKeysKeepTheOrderOfSignedIds)
+{
+
+    std::vector<std::tuple<int16_t, int16_t>> connections = { { -5, 3 }, { -5, -7 }, { 0, 0 }, { -32768, 32767 }, { 12, -1 } };
+
+    for (auto& a : connections) {
+
+        EXPECT_EQ(dataset::connection_of_sort_key<int16_t>(dataset::connection_sort_key(std::get<0>(a), std::get<1>(a))), a);
+
+        for (auto& b : connections) {
+
+            EXPECT_EQ(a < b, dataset::connection_sort_key(std::get<0>(a), std::get<1>(a)) < dataset::connection_sort_key(std::get<0>(b), std::get<1>(b)));
+        }
+    }
+}
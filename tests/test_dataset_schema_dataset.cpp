@@ -0,0 +1,80 @@
+#include <ginv/schema_dataset.hpp>
+#include <gtest/gtest.h>
+#include <cstdint>
+#include <filesystem>
+#include <fstream>
+#include <string>
+#include <vector>
+
+template <typename T>
+void write_schema_dataset_test_file(const std::string& file_name, const std::vector<T>& values)
+{
+
+    std::ofstream file(file_name, std::ios::out | std::ios::binary);
+    file.write((const char*)values.data(), values.size() * sizeof(T));
+}
+
+TEST(DatasetSchemaDataset, LoadsProjectedColumnsFirstAndOthersOnAccess)
+{
+
+    auto root = (std::filesystem::temp_directory_path() / "ginv_test_schema_dataset").string();
+    std::filesystem::remove_all(root);
+    std::filesystem::create_directories(root);
+
+    std::ofstream(root + "/global_params.json") << R"({
+        "nodes": 4,
+        "links": 5,
+        "columns": [
+            { "name": "from", "table": "connections", "file": "from_${FILE_ID}.bin", "type": "int32", "shards": 2 },
+            { "name": "value", "table": "connections", "file": "value.bin", "type": "uint8" },
+            { "name": "volume", "table": "nodes", "file": "volume_${FILE_ID}.bin", "type": "float64" }
+        ]
+    })";
+
+    write_schema_dataset_test_file<int32_t>(root + "/from_0.bin", { 0, 1, 2 });
+    write_schema_dataset_test_file<int32_t>(root + "/from_1.bin", { 3, 0 });
+    write_schema_dataset_test_file<uint8_t>(root + "/value.bin", { 5, 6, 7, 8, 9 });
+    write_schema_dataset_test_file<double>(root + "/volume_0.bin", { 1.5, 2.5 });
+
+    dataset::SchemaDataset data(root, { "from", "value" }, "global_params.json", 2);
+
+    EXPECT_EQ(4u, data.node_count());
+    EXPECT_TRUE(data.is_loaded("from"));
+    EXPECT_FALSE(data.is_loaded("volume"));
+    EXPECT_EQ((std::vector<int32_t> { 0, 1, 2, 3, 0 }), data.column<int32_t>("from"));
+
+    // Shards that hold fewer elements than the node count are an error as well
+    EXPECT_THROW(data.column<double>("volume"), std::runtime_error);
+    EXPECT_FALSE(data.is_loaded("volume"));
+
+    write_schema_dataset_test_file<double>(root + "/volume_0.bin", { 1.5, 2.5, 3.5, 4.5 });
+
+    EXPECT_EQ((std::vector<double> { 1.5, 2.5, 3.5, 4.5 }), data.column<double>("volume"));
+    EXPECT_TRUE(data.is_loaded("volume"));
+
+    EXPECT_THROW(data.column<float>("volume"), std::invalid_argument);
+    EXPECT_THROW(data.column<float>("profits"), std::out_of_range);
+
+    auto values = data.take_column<uint8_t>("value");
+
+    EXPECT_EQ((std::vector<uint8_t> { 5, 6, 7, 8, 9 }), values);
+    EXPECT_FALSE(data.is_loaded("value"));
+    EXPECT_EQ(values, data.column<uint8_t>("value"));
+
+    write_schema_dataset_test_file<int32_t>(root + "/from_1.bin", { 3, 0, 1 });
+
+    EXPECT_THROW(dataset::SchemaDataset(root, { "from" }), std::runtime_error);
+
+    std::filesystem::remove_all(root);
+}
+
+TEST(DatasetSchemaDataset, FallsBackToTheIstanbulLayout)
+{
+
+    auto schema = dataset::read_schema(nlohmann::json::parse(R"({ "nodes": 1, "links": 1 })"));
+
+    ASSERT_EQ(9u, schema.size());
+    EXPECT_EQ("from", schema[0].m_name);
+    EXPECT_EQ(2u, schema[0].m_shards);
+    EXPECT_EQ("uint8", schema[2].m_type);
+}
@@ -0,0 +1,72 @@
+#include <ginv/layout/barnes_hut_quadtree.hpp>
+#include <gtest/gtest.h>
+#include <cmath>
+#include <random>
+#include <vector>
+
+TEST(LayoutBarnesHutQuadtree, AggregatesMassAndCenterOfMass)
+{
+
+    std::vector<float> x { 0, 4, 0, 4 };
+    std::vector<float> y { 0, 0, 4, 4 };
+    std::vector<float> masses { 1, 1, 1, 5 };
+
+    layout::BarnesHutQuadtree<float> tree(x, y, masses);
+
+    EXPECT_EQ(5, tree.m_cells.size());
+    EXPECT_FLOAT_EQ(8, tree.m_cells[0].m_mass);
+    EXPECT_FLOAT_EQ(3, tree.m_cells[0].m_mass_x);
+    EXPECT_FLOAT_EQ(3, tree.m_cells[0].m_mass_y);
+}
+
+TEST(LayoutBarnesHutQuadtree, MatchesExactRepulsionWithZeroTheta)
+{
+
+    size_t count = 300;
+    std::mt19937_64 random(7);
+    std::uniform_real_distribution<double> distribution(-10, 10);
+
+    std::vector<double> x(count);
+    std::vector<double> y(count);
+    std::vector<double> masses(count);
+
+    for (size_t i = 0; i < count; i++) {
+
+        x[i] = distribution(random);
+        y[i] = distribution(random);
+        masses[i] = double(1 + i % 4);
+    }
+
+    x[1] = x[0];
+    y[1] = y[0];
+
+    layout::BarnesHutQuadtree<double> tree(x, y, masses);
+    std::vector<int32_t> stack;
+
+    for (size_t i = 2; i < count; i += 37) {
+
+        double target_x = 0;
+        double target_y = 0;
+
+        for (size_t j = 0; j < count; j++) {
+
+            double dx = x[i] - x[j];
+            double dy = y[i] - y[j];
+            double distance2 = dx * dx + dy * dy;
+
+            if (distance2 > 0) {
+
+                target_x += dx * 2 * masses[i] * masses[j] / distance2;
+                target_y += dy * 2 * masses[i] * masses[j] / distance2;
+            }
+        }
+
+        auto [exact_x, exact_y] = tree.repulsion(int32_t(i), x[i], y[i], masses[i], 0.0, 2.0, stack);
+        auto [approximate_x, approximate_y] = tree.repulsion(int32_t(i), x[i], y[i], masses[i], 0.5, 2.0, stack);
+
+        EXPECT_NEAR(target_x, exact_x, 1e-9 * std::abs(target_x) + 1e-9);
+        EXPECT_NEAR(target_y, exact_y, 1e-9 * std::abs(target_y) + 1e-9);
+        EXPECT_NEAR(target_x, approximate_x, 0.05 * std::hypot(target_x, target_y) + 1e-6);
+        EXPECT_NEAR(target_y, approximate_y, 0.05 * std::hypot(target_x, target_y) + 1e-6);
+    }
+}
@@ -0,0 +1,94 @@
+#include <ginv/layout/force_atlas2.hpp>
+#include <gtest/gtest.h>
+#include "random_test_graph.hpp"
+#include <cmath>
+#include <cstdint>
+#include <vector>
+
+ograph::OGraph<int32_t, float, float, uint8_t, float> create_layout_test_graph(int group_size)
+{
+
+    std::vector<int32_t> from;
+    std::vector<int32_t> to;
+
+    for (int group = 0; group < 2; group++) {
+        for (int i = 0; i < group_size; i++) {
+            for (int j = 0; j < i; j++) {
+
+                from.push_back(group * group_size + i);
+                to.push_back(group * group_size + j);
+            }
+        }
+    }
+
+    from.push_back(0);
+    to.push_back(group_size);
+
+    return create_test_graph(2 * group_size, from, to, {}, std::vector<float>(2 * group_size));
+}
+
+// Mean distance between nodes of the same group relative to the distance between the group centers
+float layout_group_separation(const ograph::OGraph<int32_t, float, float, uint8_t, float>& g, int group_size)
+{
+
+    auto& x = g.m_nodes.m_x_coordinates;
+    auto& y = g.m_nodes.m_y_coordinates;
+
+    float center_x[2] = { 0, 0 };
+    float center_y[2] = { 0, 0 };
+
+    for (int i = 0; i < 2 * group_size; i++) {
+
+        center_x[i / group_size] += x[i] / group_size;
+        center_y[i / group_size] += y[i] / group_size;
+    }
+
+    float spread = 0;
+
+    for (int i = 0; i < 2 * group_size; i++) {
+
+        spread += std::hypot(x[i] - center_x[i / group_size], y[i] - center_y[i / group_size]) / (2 * group_size);
+    }
+
+    return spread / std::hypot(center_x[0] - center_x[1], center_y[0] - center_y[1]);
+}
+
+TEST(LayoutForceAtlas2, SeparatesDenseGroups)
+{
+
+    for (bool barnes_hut : { true, false }) {
+
+        auto g = create_layout_test_graph(20);
+
+        layout::ForceAtlas2Settings<float> settings;
+        settings.m_barnes_hut = barnes_hut;
+        settings.m_max_iterations = 300;
+        settings.m_thread_count = 2;
+
+        EXPECT_EQ(300, layout::force_atlas2_layout(g, settings));
+        ASSERT_EQ(40, g.m_nodes.m_y_coordinates.size());
+
+        for (int i = 0; i < 40; i++) {
+
+            ASSERT_TRUE(std::isfinite(g.m_nodes.m_x_coordinates[i]));
+            ASSERT_TRUE(std::isfinite(g.m_nodes.m_y_coordinates[i]));
+        }
+
+        EXPECT_LT(layout_group_separation(g, 20), 0.5f) << (barnes_hut ? "barnes-hut" : "exact");
+    }
+}
+
+TEST(LayoutForceAtlas2, StopsWhenConverged)
+{
+
+    auto g = create_layout_test_graph(10);
+
+    layout::ForceAtlas2Settings<float> settings;
+    settings.m_max_iterations = 10000;
+    settings.m_tolerance = 0.01f;
+
+    size_t iterations = layout::force_atlas2_layout(g, settings);
+
+    EXPECT_GT(iterations, 1);
+    EXPECT_LT(iterations, 10000);
+}
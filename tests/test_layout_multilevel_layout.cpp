@@ -0,0 +1,87 @@
+#include <ginv/layout/multilevel_layout.hpp>
+#include <gtest/gtest.h>
+#include <cmath>
+#include <cstdint>
+#include <stdexcept>
+#include <vector>
+
+TEST(LayoutMultilevelLayout, PlacesCommunitiesApart)
+{
+
+    int group_count = 4;
+    int group_size = 15;
+    int node_count = group_count * group_size;
+
+    std::vector<int32_t> from;
+    std::vector<int32_t> to;
+    std::vector<std::vector<int32_t>> communities(group_count);
+
+    for (int group = 0; group < group_count; group++) {
+        for (int i = 0; i < group_size; i++) {
+
+            communities[group].push_back(group * group_size + i);
+
+            for (int j = 0; j < i; j++) {
+
+                from.push_back(group * group_size + i);
+                to.push_back(group * group_size + j);
+            }
+        }
+
+        from.push_back(group * group_size);
+        to.push_back(((group + 1) % group_count) * group_size + 1);
+    }
+
+    size_t connection_count = from.size();
+
+    ograph::OGraph<int32_t, float, float, uint8_t, float> g(
+        ograph::OSpatialNodes<float, uint8_t, float>(
+            std::vector<float>(0 + node_count),
+            std::vector<float>(node_count),
+            std::vector<uint8_t>(node_count),
+            std::vector<float>(node_count)),
+        ograph::OSpatialConnections<int32_t, float, uint8_t>(
+            from, to, std::vector<float>(connection_count, 1), std::vector<uint8_t>(connection_count)));
+
+    auto labels = clustering::create_community_labels<int32_t>(node_count, communities);
+
+    layout::MultilevelLayoutSettings<float> settings;
+    settings.m_thread_count = 2;
+
+    layout::multilevel_layout(g, labels, settings);
+
+    auto& x = g.m_nodes.m_x_coordinates;
+    auto& y = g.m_nodes.m_y_coordinates;
+
+    std::vector<float> center_x(group_count, 0);
+    std::vector<float> center_y(group_count, 0);
+    std::vector<float> radius(group_count, 0);
+
+    for (int i = 0; i < node_count; i++) {
+
+        ASSERT_TRUE(std::isfinite(x[i]) && std::isfinite(y[i]));
+
+        center_x[i / group_size] += x[i] / group_size;
+        center_y[i / group_size] += y[i] / group_size;
+    }
+
+    for (int i = 0; i < node_count; i++) {
+
+        int group = i / group_size;
+        radius[group] = std::max(radius[group], std::hypot(x[i] - center_x[group], y[i] - center_y[group]));
+    }
+
+    for (int a = 0; a < group_count; a++) {
+
+        EXPECT_NEAR(std::sqrt(float(group_size)), radius[a], 1e-3f);
+
+        for (int b = 0; b < a; b++) {
+
+            EXPECT_GT(std::hypot(center_x[a] - center_x[b], center_y[a] - center_y[b]), radius[a] + radius[b]) << a << " and " << b;
+        }
+    }
+
+    std::vector<std::vector<int32_t>> partial_communities(communities.begin(), communities.end() - 1);
+
+    EXPECT_THROW(layout::multilevel_layout<float>(g, clustering::create_community_labels<int32_t>(node_count, partial_communities)), std::invalid_argument);
+}
@@ -0,0 +1,78 @@
+#include <ginv/layout/tile_export.hpp>
+#include <gtest/gtest.h>
+#include <algorithm>
+#include <cstdint>
+#include <filesystem>
+#include <vector>
+
+TEST(LayoutTileExport, WritesEveryNodeAndConnectionToItsTiles)
+{
+
+    // Node i sits at (i % 4, i / 4) on a 4x4 grid; node 0 is level 0, nodes 1..4 level 1 and the rest level 2
+    size_t node_count = 16;
+    std::vector<float> x(node_count);
+    std::vector<float> y(node_count);
+    std::vector<uint8_t> z(node_count, 2);
+
+    for (size_t i = 0; i < node_count; i++) {
+
+        x[i] = float(i % 4);
+        y[i] = float(i / 4);
+    }
+
+    z[0] = 0;
+    std::fill(z.begin() + 1, z.begin() + 5, uint8_t(1));
+
+    ograph::OGraph<int32_t, float, float, uint8_t> g(
+        ograph::OSpatialNodes<float, uint8_t>(x, y, z),
+        ograph::OSpatialConnections<int32_t, float, uint8_t>(
+            std::vector<int32_t>({ 0, 1, 5 }), std::vector<int32_t>({ 1, 15, 6 }), std::vector<float>({ 1, 2, 3 }), std::vector<uint8_t>({ 1, 2, 2 })));
+
+    auto directory = (std::filesystem::temp_directory_path() / "ginv_test_tile_export").string();
+    std::filesystem::remove_all(directory);
+
+    auto pyramid = layout::export_tiles(g, directory, 2);
+
+    EXPECT_EQ(3u, pyramid.m_level_count);
+
+    std::vector<int> node_tile_counts(node_count, 0);
+    size_t connection_entries = 0;
+
+    for (auto& info : pyramid.m_tiles) {
+
+        auto tile = layout::read_tile<int32_t, float, float>(directory + "/" + layout::TilePyramid::tile_path(info.m_level, info.m_x, info.m_y));
+
+        EXPECT_EQ(info.m_node_count, tile.m_node_ids.size());
+        EXPECT_EQ(info.m_connection_count, tile.m_from.size());
+
+        for (size_t q = 0; q < tile.m_node_ids.size(); q++) {
+
+            int32_t node = tile.m_node_ids[q];
+            node_tile_counts[node]++;
+
+            EXPECT_EQ(z[node], tile.m_level);
+            EXPECT_EQ(x[node], tile.m_x_coordinates[q]);
+            EXPECT_EQ(pyramid.tile_of(tile.m_level, x[node], y[node]), std::make_tuple(tile.m_x, tile.m_y));
+        }
+
+        for (size_t q = 0; q < tile.m_from.size(); q++) {
+
+            EXPECT_EQ(x[tile.m_to[q]], tile.m_to_x[q]);
+            EXPECT_EQ(y[tile.m_from[q]], tile.m_from_y[q]);
+        }
+
+        connection_entries += tile.m_from.size();
+    }
+
+    EXPECT_EQ(std::vector<int>(node_count, 1), node_tile_counts);
+
+    // 0-1 shares a tile of level 1, while 1-15 and 5-6 cross tiles of level 2
+    EXPECT_EQ(5u, connection_entries);
+
+    auto manifest = layout::read_tile_pyramid(directory + "/pyramid.bin");
+
+    EXPECT_EQ(pyramid.m_tiles.size(), manifest.m_tiles.size());
+    EXPECT_EQ(pyramid.m_size, manifest.m_size);
+
+    std::filesystem::remove_all(directory);
+}
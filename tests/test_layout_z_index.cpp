@@ -0,0 +1,62 @@
+#include <ginv/layout/z_index.hpp>
+#include <gtest/gtest.h>
+#include <cstdint>
+#include <vector>
+
+TEST(LayoutZIndex, AssignsQuadrupledLevelsByImportance)
+{
+
+    std::vector<float> importance(30);
+
+    for (size_t i = 0; i < importance.size(); i++) {
+
+        importance[i] = float(i % 10);
+    }
+
+    auto levels = layout::assign_z_levels<uint8_t>(std::span<const float>(importance), 3, 2, 2);
+
+    std::vector<size_t> level_sizes(3, 0);
+
+    for (auto level : levels) {
+
+        level_sizes[level]++;
+    }
+
+    EXPECT_EQ(std::vector<size_t>({ 2, 8, 20 }), level_sizes);
+
+    // Equal importance keeps node order: the nines are nodes 9, 19 and 29
+    EXPECT_EQ(0, levels[9]);
+    EXPECT_EQ(0, levels[19]);
+    EXPECT_EQ(1, levels[29]);
+    EXPECT_EQ(2, levels[0]);
+
+    EXPECT_THROW(layout::assign_z_levels<uint8_t>(std::span<const float>(importance), 300), std::invalid_argument);
+}
+
+TEST(LayoutZIndex, GivesConnectionsTheLevelOfTheirLaterEndpoint)
+{
+
+    size_t node_count = 6;
+
+    ograph::OGraph<int32_t, float, float, uint8_t> g(
+        ograph::OSpatialNodes<float, uint8_t>(
+            std::vector<float>(0 + node_count), std::vector<float>(node_count), std::vector<uint8_t>(node_count)),
+        ograph::OSpatialConnections<int32_t, float, uint8_t>(
+            std::vector<int32_t>({ 0, 1, 4 }), std::vector<int32_t>({ 1, 5, 5 }), std::vector<float>(3, 1), std::vector<uint8_t>(0)));
+
+    std::vector<double> importance = { 6, 5, 4, 3, 2, 1 };
+
+    layout::assign_z_index(g, std::span<const double>(importance), 4, 1);
+
+    EXPECT_EQ(std::vector<uint8_t>({ 0, 1, 1, 1, 1, 2 }), std::vector<uint8_t>(g.m_nodes.m_z_index.begin(), g.m_nodes.m_z_index.end()));
+    EXPECT_EQ(std::vector<uint8_t>({ 1, 2, 2 }), std::vector<uint8_t>(g.m_connections.m_z_index.begin(), g.m_connections.m_z_index.end()));
+}
+
+TEST(LayoutZIndex, UsesCommunitySizesAsImportance)
+{
+
+    auto labels = clustering::create_community_labels<int32_t>(5, std::vector<std::vector<int32_t>>({ { 3 }, { 0, 2, 4 } }));
+    auto importance = layout::community_size_importance(labels);
+
+    EXPECT_EQ(std::vector<double>({ 3, 0, 3, 1, 3 }), importance);
+}
@@ -0,0 +1,59 @@
+#include <ginv/clustering/clauset_newman_moore.hpp>
+#include <gtest/gtest.h>
+#include <osigma/huge_page_allocator.hpp>
+#include <osigma/ograph.hpp>
+#include <cstdint>
+#include <vector>
+
+TEST(OsigmaHugePageAllocator, AlignsSmallAndLargeColumns)
+{
+
+    std::vector<float, ograph::HugePageAllocator<float>> small(3, 1.0f);
+    std::vector<uint8_t, ograph::HugePageAllocator<uint8_t>> large(ograph::HugePageAllocator<uint8_t>::FIRST_TOUCH_SIZE + 1);
+
+    EXPECT_EQ(0, uintptr_t(small.data()) % ograph::HugePageAllocator<float>::ALIGNMENT);
+    EXPECT_EQ(0, uintptr_t(large.data()) % ograph::HugePageAllocator<uint8_t>::HUGE_PAGE_SIZE);
+    EXPECT_EQ(1.0f, small[2]);
+    EXPECT_EQ(0, large[0]);
+    EXPECT_EQ(0, large.back());
+
+    // Only the opt-in allocator touches large allocations from several threads
+    std::vector<uint8_t, ograph::FirstTouchHugePageAllocator<uint8_t>> touched(ograph::FirstTouchHugePageAllocator<uint8_t>::FIRST_TOUCH_SIZE + 1, 3);
+
+    EXPECT_EQ(0, uintptr_t(touched.data()) % ograph::FirstTouchHugePageAllocator<uint8_t>::HUGE_PAGE_SIZE);
+    EXPECT_EQ(3, touched[0]);
+    EXPECT_EQ(3, touched.back());
+}
+
+TEST(OsigmaHugePageAllocator, ClustersGraphWithAllocatedColumns)
+{
+
+    auto from = std::vector<int32_t> { 0, 0, 1, 2, 4, 4, 5, 6, 3 };
+    auto to = std::vector<int32_t> { 1, 2, 2, 3, 5, 6, 6, 7, 4 };
+    auto values = std::vector<float> { 1, 1, 1, 1, 2, 2, 2, 1, 1 };
+
+    ograph::OGraph<int32_t, float, float, uint8_t, float> g(
+        ograph::OSpatialNodes<float, uint8_t, float>(
+            std::vector<float>(8),
+            std::vector<float>(8),
+            std::vector<uint8_t>(8),
+            std::vector<float>(8)),
+        ograph::OSpatialConnections<int32_t, float, uint8_t>(from, to, values, std::vector<uint8_t>(9)));
+
+    typedef ograph::BasicOSpatialNodes<ograph::HugePageAllocator, float, uint8_t, float> AlignedNodes;
+    typedef ograph::BasicOSpatialConnections<ograph::HugePageAllocator, int32_t, float, uint8_t> AlignedConnections;
+
+    ograph::BasicOGraph<ograph::HugePageAllocator, int32_t, float, float, uint8_t, float> aligned_g(
+        AlignedNodes(
+            AlignedNodes::TColumn<float>(8),
+            AlignedNodes::TColumn<float>(8),
+            AlignedNodes::TColumn<uint8_t>(8),
+            AlignedNodes::TColumn<float>(8)),
+        AlignedConnections(
+            AlignedConnections::TColumn<int32_t>(from.begin(), from.end()),
+            AlignedConnections::TColumn<int32_t>(to.begin(), to.end()),
+            AlignedConnections::TColumn<float>(values.begin(), values.end()),
+            AlignedConnections::TColumn<uint8_t>(9)));
+
+    EXPECT_EQ(clustering::greedy_modularity_communities<float>(g), clustering::greedy_modularity_communities<float>(aligned_g));
+}
@@ -0,0 +1,32 @@
+#include <gtest/gtest.h>
+#include <osigma/oconnection_index.hpp>
+#include <osigma/oconnections.hpp>
+#include <cstdint>
+#include <stdexcept>
+#include <vector>
+
+TEST(OsigmaOConnectionIndex, IndexesConnectionsByDirection)
+{
+
+    ograph::OConnections<int32_t, float> connections(
+        std::vector<int32_t> { 0, 0, 2, 3 },
+        std::vector<int32_t> { 1, 2, 1, 0 },
+        std::vector<float> { 1, 2, 3, 4 });
+
+    auto outgoing = ograph::create_connection_index(4, connections);
+    auto incoming = ograph::create_connection_index(4, connections, ograph::ConnectionDirection::Incoming);
+    auto both = ograph::create_connection_index(4, connections, ograph::ConnectionDirection::Both);
+
+    EXPECT_EQ((std::vector<size_t> { 0, 2, 2, 3, 4 }), outgoing.m_offsets);
+    EXPECT_EQ((std::vector<int32_t> { 1, 2, 1, 0 }), outgoing.m_neighbours);
+    EXPECT_EQ((std::vector<float> { 1, 2, 3, 4 }), outgoing.m_values);
+
+    EXPECT_EQ((std::vector<size_t> { 0, 1, 3, 4, 4 }), incoming.m_offsets);
+    EXPECT_EQ((std::vector<int32_t> { 3, 0, 2, 0 }), incoming.m_neighbours);
+
+    EXPECT_EQ(3, both.degree(0));
+    EXPECT_EQ((std::vector<int32_t> { 1, 2, 3 }), std::vector<int32_t>(both.neighbours(0).begin(), both.neighbours(0).end()));
+    EXPECT_EQ((std::vector<float> { 1, 2, 4 }), std::vector<float>(both.values(0).begin(), both.values(0).end()));
+
+    EXPECT_THROW(ograph::create_connection_index(3, connections), std::out_of_range);
+}
@@ -0,0 +1,225 @@
+#include <ginv/clustering/shared_clustering.hpp>
+#include <osigma/shared_memory_graph.hpp>
+#include <gtest/gtest.h>
+#include "random_test_graph.hpp"
+#include <cstdint>
+#include <cstring>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include <sys/wait.h>
+#include <unistd.h>
+
+namespace {
+
+ograph::OGraph<int32_t, float, float, uint8_t, uint16_t> create_shared_test_graph(size_t node_count, uint32_t seed)
+{
+
+    TestRandom random(seed);
+    std::vector<int32_t> from;
+    std::vector<int32_t> to;
+    std::vector<uint16_t> feature(node_count);
+
+    add_random_test_connections(random, node_count, 4 * node_count, from, to);
+
+    for (size_t i = 0; i < node_count; i++) {
+
+        feature[i] = uint16_t(i * 7);
+    }
+
+    return create_test_graph(node_count, from, to, {}, feature);
+}
+
+std::string shared_test_segment_name(const char* suffix)
+{
+
+    return "/ginv_test_" + std::to_string(getpid()) + "_" + suffix;
+}
+}
+
+TEST(OSigmaSharedMemoryGraph, AttachedColumnsMatchThePublishedGraph)
+{
+
+    auto graph = create_shared_test_graph(50, 11);
+    std::string name = shared_test_segment_name("columns");
+
+    {
+        auto segment = ograph::publish_graph(name, graph);
+        auto view = ograph::SharedGraphView::attach(name);
+
+        EXPECT_FALSE(view.segment().is_writable());
+        EXPECT_EQ(view.node_count(), 50u);
+
+        auto from = view.column<int32_t>("from");
+        auto feature = view.column<uint16_t>("feature_0");
+
+        ASSERT_EQ(from.size(), graph.m_connections.m_from.size());
+        EXPECT_TRUE(std::equal(from.begin(), from.end(), graph.m_connections.m_from.begin()));
+        EXPECT_EQ(feature[3], 21);
+        EXPECT_EQ(reinterpret_cast<uintptr_t>(feature.data()) % ograph::SharedGraphBuilder::ALIGNMENT, 0u);
+
+        auto index = ograph::create_connection_index(50, graph.m_connections, ograph::ConnectionDirection::Both);
+        auto offsets = view.column<uint64_t>("index_offsets");
+        auto neighbours = view.column<int32_t>("index_neighbours");
+
+        EXPECT_EQ(offsets.back(), index.m_offsets.back());
+        EXPECT_TRUE(std::equal(neighbours.begin(), neighbours.end(), index.m_neighbours.begin()));
+
+        EXPECT_THROW(view.column<float>("from"), std::invalid_argument);
+        EXPECT_THROW(view.column<int32_t>("missing"), std::out_of_range);
+        EXPECT_THROW(ograph::publish_graph(name, graph), std::runtime_error);
+    }
+
+    ograph::SharedMemorySegment::unlink(name);
+
+    EXPECT_THROW(ograph::SharedGraphView::attach(name), std::runtime_error);
+}
+
+TEST(OSigmaSharedMemoryGraph, WorkerProcessesClusterTheSharedGraph)
+{
+
+    auto graph = create_shared_test_graph(80, 5);
+    auto expected = clustering::greedy_modularity_communities<float>(graph);
+    std::string name = shared_test_segment_name("workers");
+
+    auto segment = clustering::publish_clustering_graph(name, graph, 1);
+    std::vector<pid_t> workers;
+
+    for (size_t w = 0; w < 3; w++) {
+
+        pid_t pid = fork();
+
+        if (pid == 0) {
+
+            int status = 1;
+
+            try {
+
+                auto view = ograph::SharedGraphView::attach(name);
+                auto communities = clustering::greedy_modularity_communities<float, int32_t, float>(view, 1.0f, 1, 1);
+
+                status = communities == expected ? 0 : 2;
+            } catch (...) {
+
+                status = 3;
+            }
+
+            _exit(status);
+        }
+
+        ASSERT_GT(pid, 0);
+        workers.push_back(pid);
+    }
+
+    for (pid_t pid : workers) {
+
+        int status = 0;
+
+        ASSERT_EQ(waitpid(pid, &status, 0), pid);
+        EXPECT_TRUE(WIFEXITED(status));
+        EXPECT_EQ(WEXITSTATUS(status), 0);
+    }
+
+    auto view = ograph::SharedGraphView(ograph::SharedMemorySegment::attach(name));
+
+    EXPECT_TRUE(view.has_column("adjacency_offsets"));
+    EXPECT_EQ((clustering::greedy_modularity_communities<float, int32_t, float, clustering::LazyMergeHeap>(view)),
+        (clustering::greedy_modularity_communities<float, clustering::LazyMergeHeap>(graph)));
+
+    ograph::SharedMemorySegment::unlink(name);
+}
+
+TEST(OSigmaSharedMemoryGraph, SegmentsWithoutAdjacencyAreClusteredFromTheConnections)
+{
+
+    auto graph = create_shared_test_graph(60, 23);
+    std::string name = shared_test_segment_name("connections");
+
+    {
+        auto segment = ograph::publish_graph(name, graph);
+        auto view = ograph::SharedGraphView::attach(name);
+
+        EXPECT_FALSE(view.has_column("a"));
+        EXPECT_EQ((clustering::greedy_modularity_communities<float, int32_t, float>(view, 1.0f, 1, 1)),
+            clustering::greedy_modularity_communities<float>(graph));
+    }
+
+    ograph::SharedMemorySegment::unlink(name);
+}
+
+TEST(OSigmaSharedMemoryGraph, RejectsSegmentsWithoutMagicOrWithColumnsPastTheEnd)
+{
+
+    std::string name = shared_test_segment_name("invalid");
+    std::vector<int32_t> values = { 1, 2, 3 };
+
+    {
+        auto segment = ograph::SharedMemorySegment::create(name, 4096);
+
+        EXPECT_THROW(ograph::SharedGraphView::attach(name), std::runtime_error);
+    }
+
+    ograph::SharedMemorySegment::unlink(name);
+
+    {
+        auto segment = ograph::SharedGraphBuilder().add_column("values", values).publish(name);
+
+        EXPECT_EQ(ograph::SharedGraphView::attach(name).column<int32_t>("values")[2], 3);
+
+        ograph::SharedColumnEntry entry;
+        std::byte* table = segment.writable_data() + sizeof(ograph::SHARED_GRAPH_MAGIC) + sizeof(uint64_t);
+
+        std::memcpy(&entry, table, sizeof(entry));
+        entry.m_count = segment.size();
+        std::memcpy(table, &entry, sizeof(entry));
+
+        EXPECT_THROW(ograph::SharedGraphView::attach(name), std::runtime_error);
+    }
+
+    ograph::SharedMemorySegment::unlink(name);
+}
+
+TEST(OSigmaSharedMemoryGraph, RejectsCorruptedAdjacencyColumns)
+{
+
+    auto graph = create_shared_test_graph(40, 11);
+    std::string name = shared_test_segment_name("adjacency");
+
+    {
+        auto segment = clustering::publish_clustering_graph(name, graph, 1);
+        auto view = ograph::SharedGraphView::attach(name);
+
+        // Writes through the publisher's mapping at the place of a column of the view
+        auto overwrite = [&](const std::string& column, size_t index, auto value) {
+
+            auto span = view.column<decltype(value)>(column);
+            size_t offset = size_t((const std::byte*)(span.data() + index) - view.segment().data());
+            auto previous = span[index];
+
+            std::memcpy(segment.writable_data() + offset, &value, sizeof(value));
+
+            return previous;
+        };
+
+        size_t previous_offset = overwrite("adjacency_offsets", 20, size_t(0));
+
+        EXPECT_THROW((clustering::greedy_modularity_communities<float, int32_t, float>(view, 1.0f, 1, 1)), std::runtime_error);
+
+        overwrite("adjacency_offsets", 20, previous_offset);
+        int32_t previous_neighbour = overwrite("adjacency_neighbours", 3, int32_t(40));
+
+        EXPECT_THROW((clustering::greedy_modularity_communities<float, int32_t, float>(view, 1.0f, 1, 1)), std::runtime_error);
+
+        overwrite("adjacency_neighbours", 3, int32_t(-1));
+
+        EXPECT_THROW((clustering::greedy_modularity_communities<float, int32_t, float>(view, 1.0f, 1, 1)), std::runtime_error);
+
+        overwrite("adjacency_neighbours", 3, previous_neighbour);
+
+        EXPECT_EQ((clustering::greedy_modularity_communities<float, int32_t, float>(view, 1.0f, 1, 1)),
+            clustering::greedy_modularity_communities<float>(graph));
+    }
+
+    ograph::SharedMemorySegment::unlink(name);
+}
@@ -0,0 +1,69 @@
+#include <gtest/gtest.h>
+#include <osigma/snapshot_store.hpp>
+#include <cstdint>
+#include <vector>
+
+typedef ograph::OConnections<int32_t, float> SnapshotTestConnections;
+
+SnapshotTestConnections create_snapshot_test_connections(std::vector<int32_t> from, std::vector<int32_t> to, std::vector<float> values)
+{
+
+    return SnapshotTestConnections(std::move(from), std::move(to), std::move(values));
+}
+
+TEST(OsigmaSnapshotStore, MaterializesPeriodsFromTheBaseAndDeltas)
+{
+
+    auto base = create_snapshot_test_connections({ 2, 0, 1, 0 }, { 3, 1, 2, 1 }, { 4, 1, 2, 1 });
+    ograph::SnapshotStore<int32_t, float> store(4, base);
+
+    EXPECT_EQ((std::vector<int32_t> { 0, 1, 2 }), store.m_base.m_from);
+    EXPECT_EQ((std::vector<float> { 2, 2, 4 }), store.m_base.m_values);
+
+    store.add_period(base);
+    size_t second = store.add_period(create_snapshot_test_connections({ 0, 2, 3 }, { 1, 3, 0 }, { 2, 5, 1 }));
+
+    EXPECT_EQ(2u, store.period_count());
+    EXPECT_EQ(0u, store.delta_size(0));
+    EXPECT_EQ(3u, store.delta_size(1));
+
+    auto first_period = store.materialize(0);
+
+    EXPECT_EQ(store.m_base.m_from, first_period.m_from);
+    EXPECT_EQ(store.m_base.m_values, first_period.m_values);
+
+    auto second_period = store.materialize(second);
+
+    EXPECT_EQ((std::vector<int32_t> { 0, 2, 3 }), second_period.m_from);
+    EXPECT_EQ((std::vector<int32_t> { 1, 3, 0 }), second_period.m_to);
+    EXPECT_EQ((std::vector<float> { 2, 5, 1 }), second_period.m_values);
+
+    EXPECT_THROW(store.materialize(2), std::out_of_range);
+    EXPECT_THROW(store.add_period(create_snapshot_test_connections({ 4 }, { 0 }, { 1 })), std::out_of_range);
+}
+
+TEST(OsigmaSnapshotStore, SumsWindowsOverPeriods)
+{
+
+    ograph::SnapshotStore<int32_t, float> store(4, create_snapshot_test_connections({ 0, 1 }, { 1, 2 }, { 1, 1 }));
+
+    store.add_period(create_snapshot_test_connections({ 0, 1 }, { 1, 2 }, { 1, 1 }));
+    store.add_period(create_snapshot_test_connections({ 0, 2 }, { 1, 3 }, { 3, 1 }));
+    store.add_period(create_snapshot_test_connections({ 0, 1, 2 }, { 1, 2, 3 }, { 1, 1, 2 }));
+
+    auto window = store.materialize_window(0, 3);
+
+    EXPECT_EQ((std::vector<int32_t> { 0, 1, 2 }), window.m_from);
+    EXPECT_EQ((std::vector<float> { 5, 2, 3 }), window.m_values);
+
+    auto late_window = store.materialize_window(1, 3);
+
+    EXPECT_EQ((std::vector<float> { 4, 1, 3 }), late_window.m_values);
+
+    ograph::OSpatialNodes<float, uint8_t> nodes(std::vector<float>(4), std::vector<float>(4), std::vector<uint8_t>(4));
+    auto graph = store.materialize_graph(nodes, 1, 2);
+
+    EXPECT_EQ(4u, graph.node_count());
+    EXPECT_EQ((std::vector<int32_t> { 0, 2 }), graph.m_connections.m_from);
+    EXPECT_EQ((std::vector<uint8_t> { 0, 0 }), graph.m_connections.m_z_index);
+}
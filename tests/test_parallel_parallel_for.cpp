@@ -0,0 +1,49 @@
+#include <ginv/parallel/parallel_for.hpp>
+#include <gtest/gtest.h>
+#include <numeric>
+#include <stdexcept>
+#include <vector>
+
+TEST(ParallelParallelFor, VisitsEveryIndexOnce)
+{
+
+    std::vector<int> visits(1000, 0);
+
+    parallel::parallel_for(0, visits.size(), [&](size_t i) { visits[i]++; }, 4);
+
+    EXPECT_EQ(std::vector<int>(1000, 1), visits);
+}
+
+TEST(ParallelParallelFor, SplitsIntoContiguousRanges)
+{
+
+    std::vector<size_t> sums(4, 0);
+
+    parallel::parallel_for_ranges(
+        0, 100, [&](size_t begin, size_t end, size_t thread_id) {
+            for (size_t i = begin; i < end; i++) {
+
+                sums[thread_id] += i;
+            }
+        },
+        4);
+
+    EXPECT_EQ(4950, std::accumulate(sums.begin(), sums.end(), size_t(0)));
+}
+
+TEST(ParallelParallelFor, RethrowsWorkerExceptions)
+{
+
+    EXPECT_THROW(
+        {
+            parallel::parallel_for(
+                0, 100, [&](size_t i) {
+                    if (i == 77) {
+
+                        throw std::runtime_error("failed");
+                    }
+                },
+                4);
+        },
+        std::runtime_error);
+}
@@ -0,0 +1,79 @@
+#include <ginv/parallel/parallel_sort.hpp>
+#include <gtest/gtest.h>
+#include "random_test_graph.hpp"
+#include <algorithm>
+#include <cstdint>
+#include <tuple>
+#include <vector>
+
+TEST(ParallelParallelSort, SortsStablyWithAnyThreadCount)
+{
+
+    std::vector<std::tuple<int, int>> values;
+    TestRandom random(11);
+
+    for (int i = 0; i < 100003; i++) {
+
+        values.emplace_back(int(random.next() >> 20) % 100, i);
+    }
+
+    auto target = values;
+    auto compare = [](auto& a, auto& b) { return std::get<0>(a) < std::get<0>(b); };
+
+    std::stable_sort(target.begin(), target.end(), compare);
+
+    for (size_t thread_count : { 1, 2, 3, 7 }) {
+
+        auto sorted = values;
+        parallel::parallel_sort(sorted.begin(), sorted.end(), compare, thread_count, 1000);
+
+        EXPECT_EQ(target, sorted) << thread_count << " threads";
+    }
+
+    std::vector<int> empty;
+    parallel::parallel_sort(empty.begin(), empty.end());
+
+    EXPECT_TRUE(empty.empty());
+}
+
+TEST(ParallelParallelSort, RadixSortsKeysWithTheirPayloadsStably)
+{
+
+    std::vector<uint64_t> keys;
+    std::vector<uint32_t> payloads;
+    uint64_t seed = 5;
+
+    for (uint32_t i = 0; i < 50001; i++) {
+
+        seed = seed * 6364136223846793005ull + 1442695040888963407ull;
+        keys.push_back((seed >> 40) << 20);
+        payloads.push_back(i);
+    }
+
+    std::vector<std::tuple<uint64_t, uint32_t>> target;
+
+    for (size_t i = 0; i < keys.size(); i++) {
+
+        target.emplace_back(keys[i] & 0xff0000000ull, payloads[i]);
+    }
+
+    std::stable_sort(target.begin(), target.end(), [](auto& a, auto& b) { return std::get<0>(a) < std::get<0>(b); });
+
+    for (size_t thread_count : { 1, 2, 3 }) {
+
+        std::vector<uint64_t> sorted_keys = keys;
+        std::vector<uint32_t> sorted_payloads = payloads;
+
+        for (auto& key : sorted_keys) {
+
+            key &= 0xff0000000ull;
+        }
+
+        parallel::parallel_radix_sort(std::span<uint64_t>(sorted_keys), std::span<uint32_t>(sorted_payloads), thread_count, 1000);
+
+        for (size_t i = 0; i < target.size(); i++) {
+
+            ASSERT_EQ(target[i], std::make_tuple(sorted_keys[i], sorted_payloads[i])) << thread_count << " threads at " << i;
+        }
+    }
+}
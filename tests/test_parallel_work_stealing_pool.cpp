@@ -0,0 +1,71 @@
+#include <ginv/parallel/work_stealing_pool.hpp>
+#include <gtest/gtest.h>
+#include <atomic>
+#include <future>
+#include <numeric>
+#include <stdexcept>
+#include <vector>
+
+TEST(ParallelWorkStealingPool, RunsEverySubmittedTask)
+{
+
+    std::atomic<size_t> sum = 0;
+
+    {
+        parallel::WorkStealingPool pool(3);
+
+        for (size_t i = 0; i < 1000; i++) {
+
+            pool.submit([&sum, i]() { sum += i; });
+        }
+    }
+
+    EXPECT_EQ(499500u, sum.load());
+}
+
+// Sums a range by splitting it into tasks that wait for their halves
+size_t work_stealing_pool_test_sum(parallel::WorkStealingPool& pool, size_t begin, size_t end)
+{
+
+    if (end - begin <= 16) {
+
+        size_t result = 0;
+
+        for (size_t i = begin; i < end; i++) {
+
+            result += i;
+        }
+
+        return result;
+    }
+
+    size_t middle = begin + (end - begin) / 2;
+    auto left = pool.submit([&pool, begin, middle]() { return work_stealing_pool_test_sum(pool, begin, middle); });
+    size_t right = work_stealing_pool_test_sum(pool, middle, end);
+
+    return pool.wait(left) + right;
+}
+
+TEST(ParallelWorkStealingPool, RunsNestedTasksWithoutBlockingWorkers)
+{
+
+    for (size_t thread_count : { 1, 4 }) {
+
+        parallel::WorkStealingPool pool(thread_count);
+
+        auto result = pool.submit([&pool]() { return work_stealing_pool_test_sum(pool, 0, 10000); });
+
+        EXPECT_EQ(49995000u, pool.wait(result)) << thread_count << " threads";
+    }
+}
+
+TEST(ParallelWorkStealingPool, PassesExceptionsToFutures)
+{
+
+    parallel::WorkStealingPool pool(2);
+
+    auto result = pool.submit([]() -> int { throw std::runtime_error("failed task"); });
+
+    EXPECT_THROW(result.get(), std::runtime_error);
+    EXPECT_EQ(7, pool.submit([]() { return 7; }).get());
+}
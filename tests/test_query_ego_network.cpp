@@ -0,0 +1,110 @@
+#include <ginv/query/ego_network.hpp>
+#include <gtest/gtest.h>
+#include "random_test_graph.hpp"
+#include <cstdint>
+#include <vector>
+
+// Plain BFS over the connection columns as the reference for the direction-optimizing one
+std::vector<int32_t> reference_k_hop_neighbourhood(size_t node_count, const std::vector<int32_t>& from, const std::vector<int32_t>& to, int32_t node, size_t k)
+{
+
+    std::vector<size_t> hops(node_count, k + 1);
+    hops[node] = 0;
+
+    for (size_t hop = 0; hop < k; hop++) {
+        for (size_t i = 0; i < from.size(); i++) {
+
+            if (hops[from[i]] == hop && hops[to[i]] > hop + 1) {
+                hops[to[i]] = hop + 1;
+            }
+
+            if (hops[to[i]] == hop && hops[from[i]] > hop + 1) {
+                hops[from[i]] = hop + 1;
+            }
+        }
+    }
+
+    std::vector<int32_t> result;
+
+    for (size_t i = 0; i < node_count; i++) {
+
+        if (hops[i] <= k) {
+            result.push_back(int32_t(i));
+        }
+    }
+
+    return result;
+}
+
+TEST(QueryEgoNetwork, MatchesPlainBreadthFirstSearch)
+{
+
+    // A hub joined to a sparse random graph, so hops switch between top-down and bottom-up
+    size_t node_count = 3000;
+    std::vector<int32_t> from;
+    std::vector<int32_t> to;
+    TestRandom random(7);
+
+    for (size_t i = 1; i < node_count; i += 3) {
+
+        from.push_back(0);
+        to.push_back(int32_t(i));
+    }
+
+    add_random_test_connections(random, node_count, 2 * node_count, from, to);
+
+    auto index = ograph::create_connection_index<int32_t, int32_t>(
+        node_count, std::span<const int32_t>(from), std::span<const int32_t>(to), std::span<const int32_t>(from), ograph::ConnectionDirection::Both);
+
+    for (int32_t node : { 0, 5, 1234 }) {
+        for (size_t k : { 0, 1, 2, 3 }) {
+            for (size_t thread_count : { 1, 3 }) {
+
+                auto neighbourhood = query::k_hop_neighbourhood(index, node, k, std::numeric_limits<size_t>::max(), thread_count);
+
+                EXPECT_EQ(reference_k_hop_neighbourhood(node_count, from, to, node, k), neighbourhood.selected_ids<int32_t>())
+                    << node << " in " << k << " hops with " << thread_count << " threads";
+            }
+        }
+    }
+}
+
+TEST(QueryEgoNetwork, ExtractsTheNeighbourhoodWithItsFeatures)
+{
+
+    // 0 - 1 - 2 - 3 - 4 with an extra 1 - 3 connection
+    ograph::OGraph<int32_t, float, float, uint8_t, float> g(
+        ograph::OSpatialNodes<float, uint8_t, float>(
+            std::vector<float> { 0, 1, 2, 3, 4 },
+            std::vector<float>(5),
+            std::vector<uint8_t>(5),
+            std::vector<float> { 10, 11, 12, 13, 14 }),
+        ograph::OSpatialConnections<int32_t, float, uint8_t>(
+            std::vector<int32_t> { 0, 1, 2, 3, 1 },
+            std::vector<int32_t> { 1, 2, 3, 4, 3 },
+            std::vector<float> { 1, 2, 3, 4, 5 },
+            std::vector<uint8_t> { 1, 2, 3, 4, 5 }));
+
+    auto [ego, original_ids] = query::ego_network(g, 2, 1);
+
+    EXPECT_EQ((std::vector<int32_t> { 1, 2, 3 }), original_ids);
+    EXPECT_EQ((std::vector<float> { 11, 12, 13 }), std::get<0>(ego.m_nodes.m_features));
+    EXPECT_EQ((std::vector<int32_t> { 0, 1, 0 }), ego.m_connections.m_from);
+    EXPECT_EQ((std::vector<int32_t> { 1, 2, 2 }), ego.m_connections.m_to);
+    EXPECT_EQ((std::vector<uint8_t> { 2, 3, 5 }), ego.m_connections.m_z_index);
+
+    auto index = ograph::create_connection_id_index(g.node_count(), g.m_connections);
+    auto [limited, limited_ids] = query::ego_network(g, index, 0, 3, 3);
+
+    EXPECT_EQ((std::vector<int32_t> { 0, 1, 2 }), limited_ids);
+    EXPECT_EQ((std::vector<float> { 1, 2 }), limited.m_connections.m_values);
+
+    auto [empty, empty_ids] = query::ego_network(g, index, 0, 3, 0);
+
+    EXPECT_EQ(0u, query::k_hop_neighbourhood(index, 0, 3, 0).count());
+    EXPECT_TRUE(empty_ids.empty());
+    EXPECT_EQ(0u, empty.node_count());
+    EXPECT_TRUE(empty.m_connections.m_from.empty());
+
+    EXPECT_THROW(query::ego_network(g, index, 5, 1), std::out_of_range);
+}
@@ -0,0 +1,70 @@
+#include <ginv/clustering/clauset_newman_moore.hpp>
+#include <ginv/query/id_compaction.hpp>
+#include <gtest/gtest.h>
+#include <cstdint>
+#include <vector>
+
+TEST(QueryIdCompaction, MapsActiveIdsToADenseRange)
+{
+
+    std::vector<int32_t> from { 700, 3, 64, 700 };
+    std::vector<int32_t> to { 3, 129, 3, 64 };
+
+    query::IdCompaction<int32_t> compaction(
+        query::active_ids(1000, std::span<const int32_t>(from), std::span<const int32_t>(to), 2), 2);
+
+    EXPECT_EQ(1000u, compaction.id_space());
+    EXPECT_EQ((std::vector<int32_t> { 3, 64, 129, 700 }), compaction.m_original_ids);
+    EXPECT_EQ(2, compaction.dense_id(129));
+    EXPECT_EQ(700, compaction.original_id(3));
+    EXPECT_FALSE(compaction.is_active(4));
+    EXPECT_THROW(compaction.dense_id(4), std::out_of_range);
+
+    EXPECT_EQ((std::vector<int32_t> { 3, 0, 1, 3 }), query::compact_id_column(compaction, from));
+    EXPECT_EQ((std::vector<std::vector<int32_t>> { { 700, 3 }, { 129 } }), compaction.to_original({ { 3, 0 }, { 2 } }));
+
+    std::vector<int32_t> outside { 1000 };
+
+    EXPECT_THROW(query::active_ids(1000, std::span<const int32_t>(outside), std::span<const int32_t>(to)), std::out_of_range);
+}
+
+TEST(QueryIdCompaction, ClustersCompactedGraphsLikeTheWholeGraph)
+{
+
+    // Two triangles at sparse ids among 200 mostly isolated nodes
+    size_t node_count = 200;
+    std::vector<float> feature(node_count);
+
+    for (size_t i = 0; i < node_count; i++) {
+
+        feature[i] = float(i);
+    }
+
+    ograph::OGraph<int32_t, float, float, uint8_t, float> g(
+        ograph::OSpatialNodes<float, uint8_t, float>(
+            std::vector<float>(0 + node_count), std::vector<float>(node_count), std::vector<uint8_t>(node_count), feature),
+        ograph::OSpatialConnections<int32_t, float, uint8_t>(
+            std::vector<int32_t> { 10, 50, 90, 120, 150, 199, 10 },
+            std::vector<int32_t> { 50, 90, 10, 150, 199, 120, 120 },
+            std::vector<float>(7, 1),
+            std::vector<uint8_t>(7)));
+
+    auto [compacted, compaction] = query::compact_graph(g, 2);
+
+    EXPECT_EQ(6, compacted.node_count());
+    EXPECT_EQ((std::vector<float> { 10, 50, 90, 120, 150, 199 }), std::get<0>(compacted.m_nodes.m_features));
+    EXPECT_EQ((std::vector<int32_t> { 0, 1, 2, 3, 4, 5, 0 }), compacted.m_connections.m_from);
+
+    auto communities = compaction.to_original(clustering::greedy_modularity_communities<float>(compacted));
+    std::vector<std::vector<int32_t>> connected_communities;
+
+    for (auto& community : clustering::greedy_modularity_communities<float>(g)) {
+
+        if (compaction.is_active(community[0])) {
+
+            connected_communities.push_back(community);
+        }
+    }
+
+    EXPECT_EQ(connected_communities, communities);
+}
@@ -0,0 +1,44 @@
+#include <ginv/query/induced_subgraph.hpp>
+#include <gtest/gtest.h>
+#include <cstdint>
+#include <vector>
+
+TEST(QueryInducedSubgraph, KeepsSelectedNodesAndConnectionsBetweenThem)
+{
+
+    ograph::OGraph<int32_t, float, float, uint8_t, float, int32_t> g(
+        ograph::OSpatialNodes<float, uint8_t, float, int32_t>(
+            std::vector<float> { 0, 1, 2, 3, 4, 5 },
+            std::vector<float>(6),
+            std::vector<uint8_t> { 0, 1, 0, 1, 0, 1 },
+            std::vector<float> { 10, 20, 30, 40, 50, 60 },
+            std::vector<int32_t> { 5, 1, 5, 1, 5, 5 }),
+        ograph::OSpatialConnections<int32_t, float, uint8_t>(
+            std::vector<int32_t> { 0, 0, 2, 3, 4, 5 },
+            std::vector<int32_t> { 2, 1, 4, 4, 5, 0 },
+            std::vector<float> { 1, 2, 3, 4, 5, 6 },
+            std::vector<uint8_t> { 1, 2, 3, 4, 5, 6 }));
+
+    auto selection = query::select_nodes(g.m_nodes, query::column<1>() > 2 && query::column<0>() < 55.0f);
+
+    EXPECT_EQ((std::vector<int32_t> { 0, 2, 4 }), selection.selected_ids<int32_t>());
+
+    auto [subgraph, original_ids] = query::induced_subgraph(g, selection);
+
+    EXPECT_EQ((std::vector<int32_t> { 0, 2, 4 }), original_ids);
+    EXPECT_EQ(3, subgraph.node_count());
+    EXPECT_EQ((std::vector<float> { 0, 2, 4 }), subgraph.m_nodes.m_x_coordinates);
+    EXPECT_EQ((std::vector<float> { 10, 30, 50 }), std::get<0>(subgraph.m_nodes.m_features));
+    EXPECT_EQ((std::vector<int32_t> { 0, 1 }), subgraph.m_connections.m_from);
+    EXPECT_EQ((std::vector<int32_t> { 1, 2 }), subgraph.m_connections.m_to);
+    EXPECT_EQ((std::vector<float> { 1, 3 }), subgraph.m_connections.m_values);
+    EXPECT_EQ((std::vector<uint8_t> { 1, 3 }), subgraph.m_connections.m_z_index);
+
+    query::SelectionBitmap connection_selection(6, true);
+    connection_selection.set(0, false);
+
+    auto [filtered_subgraph, filtered_original_ids] = query::induced_subgraph(g, selection, &connection_selection);
+
+    EXPECT_EQ((std::vector<int32_t> { 1 }), filtered_subgraph.m_connections.m_from);
+    EXPECT_EQ((std::vector<int32_t> { 2 }), filtered_subgraph.m_connections.m_to);
+}
@@ -0,0 +1,167 @@
+#include <ginv/query/predicate_scan.hpp>
+#include <gtest/gtest.h>
+#include <cstdint>
+#include <stdexcept>
+#include <tuple>
+#include <vector>
+
+TEST(QueryPredicateScan, SelectsRowsOfConjunction)
+{
+
+    size_t row_count = 1000;
+
+    std::vector<int32_t> trades(row_count);
+    std::vector<float> profits(row_count);
+    std::vector<double> volume(row_count);
+
+    for (size_t i = 0; i < row_count; i++) {
+
+        trades[i] = int32_t(i % 17) - 8;
+        profits[i] = float(i % 13) * 0.5f;
+        volume[i] = double(i);
+    }
+
+    auto columns = std::make_tuple(trades, profits, volume);
+    auto selection = query::select_rows(columns, query::column<2>() > 100.0 && query::column<1>() < 2.5f && query::column<0>() >= 0, 4);
+
+    ASSERT_EQ(row_count, selection.size());
+
+    size_t count = 0;
+
+    for (size_t i = 0; i < row_count; i++) {
+
+        bool target = volume[i] > 100.0 && profits[i] < 2.5f && trades[i] >= 0;
+
+        EXPECT_EQ(target, selection.test(i)) << "row " << i;
+        count += target;
+    }
+
+    EXPECT_EQ(count, selection.count());
+    EXPECT_EQ(count, selection.selected_ids<int32_t>().size());
+}
+
+TEST(QueryPredicateScan, EvaluatesEveryComparisonOnFullAndPartialBlocks)
+{
+
+    size_t row_count = 130;
+
+    std::vector<int32_t> integers(row_count);
+    std::vector<float> floats(row_count);
+
+    for (size_t i = 0; i < row_count; i++) {
+
+        integers[i] = int32_t(i % 5);
+        floats[i] = float(i % 5);
+    }
+
+    auto columns = std::make_tuple(integers, floats);
+
+    auto check = [&](auto predicate, auto target) {
+        auto selection = query::select_rows(columns, predicate, 1);
+
+        for (size_t i = 0; i < row_count; i++) {
+
+            EXPECT_EQ(target(integers[i]), selection.test(i)) << predicate.describe() << " at row " << i;
+        }
+    };
+
+    check(query::column<0>() < 2, [](int32_t x) { return x < 2; });
+    check(query::column<0>() <= 2, [](int32_t x) { return x <= 2; });
+    check(query::column<0>() > 2, [](int32_t x) { return x > 2; });
+    check(query::column<0>() >= 2, [](int32_t x) { return x >= 2; });
+    check(query::column<0>() == 2, [](int32_t x) { return x == 2; });
+    check(query::column<0>() != 2, [](int32_t x) { return x != 2; });
+    check(query::column<1>() < 2.0f, [](int32_t x) { return x < 2; });
+    check(query::column<1>() <= 2.0f, [](int32_t x) { return x <= 2; });
+    check(query::column<1>() > 2.0f, [](int32_t x) { return x > 2; });
+    check(query::column<1>() >= 2.0f, [](int32_t x) { return x >= 2; });
+    check(query::column<1>() == 2.0f, [](int32_t x) { return x == 2; });
+    check(query::column<1>() != 2.0f, [](int32_t x) { return x != 2; });
+}
+
+TEST(QueryPredicateScan, RejectsColumnsOfDifferentSizes)
+{
+
+    auto columns = std::make_tuple(std::vector<int32_t>(10), std::vector<float>(9));
+
+    EXPECT_THROW(query::select_rows(columns, query::column<0>() > 0), std::invalid_argument);
+}
+
+TEST(QueryPredicateScan, ComparesConstantsOfOtherTypesExactly)
+{
+
+    std::vector<int32_t> integers = { 1, 2, 3 };
+    std::vector<uint8_t> bytes = { 0, 5, 255 };
+    std::vector<float> floats = { 0.1f, 1.0f, 16777216.0f };
+    auto columns = std::make_tuple(integers, bytes, floats);
+
+    EXPECT_EQ(2u, query::select_rows(columns, query::column<0>() < 2.5).count());
+    EXPECT_EQ(3u, query::select_rows(columns, query::column<1>() > -1).count());
+    EXPECT_EQ(0u, query::select_rows(columns, query::column<1>() < int64_t(-1)).count());
+    EXPECT_EQ(3u, query::select_rows(columns, query::column<1>() < 256).count());
+
+    auto check = [&](auto value) {
+        auto reference = [&](auto& column, query::Comparison comparison) {
+            size_t count = 0;
+
+            for (auto x : column) {
+
+                long double a = (long double)x;
+                long double b = (long double)value;
+
+                switch (comparison) {
+                case query::Comparison::Less:
+                    count += a < b;
+                    break;
+                case query::Comparison::LessEqual:
+                    count += a <= b;
+                    break;
+                case query::Comparison::Greater:
+                    count += a > b;
+                    break;
+                case query::Comparison::GreaterEqual:
+                    count += a >= b;
+                    break;
+                case query::Comparison::Equal:
+                    count += a == b;
+                    break;
+                case query::Comparison::NotEqual:
+                    count += a != b;
+                    break;
+                }
+            }
+
+            return count;
+        };
+
+        auto expect_column = [&]<size_t index>(std::integral_constant<size_t, index>) {
+            auto& column = std::get<index>(columns);
+
+            EXPECT_EQ(reference(column, query::Comparison::Less), query::select_rows(columns, query::column<index>() < value).count()) << index << " < " << value;
+            EXPECT_EQ(reference(column, query::Comparison::LessEqual), query::select_rows(columns, query::column<index>() <= value).count()) << index << " <= " << value;
+            EXPECT_EQ(reference(column, query::Comparison::Greater), query::select_rows(columns, query::column<index>() > value).count()) << index << " > " << value;
+            EXPECT_EQ(reference(column, query::Comparison::GreaterEqual), query::select_rows(columns, query::column<index>() >= value).count()) << index << " >= " << value;
+            EXPECT_EQ(reference(column, query::Comparison::Equal), query::select_rows(columns, query::column<index>() == value).count()) << index << " == " << value;
+            EXPECT_EQ(reference(column, query::Comparison::NotEqual), query::select_rows(columns, query::column<index>() != value).count()) << index << " != " << value;
+        };
+
+        expect_column(std::integral_constant<size_t, 0>());
+        expect_column(std::integral_constant<size_t, 1>());
+        expect_column(std::integral_constant<size_t, 2>());
+    };
+
+    for (double value : { -1.0, -0.5, 0.0, 0.1, 1.0, 2.5, 3.0, 5.0, 254.5, 255.0, 1e10, 16777217.0 }) {
+
+        check(value);
+    }
+
+    for (int64_t value : { int64_t(-1), int64_t(0), int64_t(2), int64_t(255), int64_t(256), int64_t(16777217), int64_t(1) << 40 }) {
+
+        check(value);
+    }
+
+    for (uint32_t value : { 0u, 3u, 4294967295u }) {
+
+        check(value);
+    }
+}
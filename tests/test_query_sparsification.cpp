@@ -0,0 +1,73 @@
+#include <ginv/query/sparsification.hpp>
+#include <gtest/gtest.h>
+#include "random_test_graph.hpp"
+#include <cmath>
+#include <cstdint>
+#include <vector>
+
+ograph::OGraph<int32_t, float, float, uint8_t, float> create_sparsification_test_graph()
+{
+
+    // A star around node 0 with one dominant connection, and a light triangle 1 - 2 - 3
+    auto g = create_test_graph(6, { 0, 0, 0, 0, 0, 1, 2, 3 }, { 1, 2, 3, 4, 5, 2, 3, 1 }, { 100, 1, 1, 1, 1, 2, 2, 2 }, std::vector<float> { 0, 1, 2, 3, 4, 5 });
+    g.m_connections.m_z_index = { 0, 1, 2, 3, 4, 5, 6, 7 };
+
+    return g;
+}
+
+TEST(QuerySparsification, SelectsConnectionsAboveAThreshold)
+{
+
+    auto g = create_sparsification_test_graph();
+    auto selection = query::weight_threshold_selection(g.m_connections, 2.0f, 2);
+
+    EXPECT_EQ((std::vector<uint32_t> { 0, 5, 6, 7 }), selection.selected_ids<uint32_t>());
+
+    auto sparse = query::sparsify(g, selection);
+
+    EXPECT_EQ(6, sparse.node_count());
+    EXPECT_EQ((std::vector<int32_t> { 0, 1, 2, 3 }), sparse.m_connections.m_from);
+    EXPECT_EQ((std::vector<uint8_t> { 0, 5, 6, 7 }), sparse.m_connections.m_z_index);
+}
+
+TEST(QuerySparsification, KeepsTheStrongestConnectionsOfEveryNode)
+{
+
+    auto g = create_sparsification_test_graph();
+
+    // Nodes 0 and 1 keep 0 - 1, nodes 4 and 5 their only connections, and nodes 2 and 3 the earlier
+    // of their two strongest, so the triangle loses 3 - 1
+    auto selection = query::top_k_selection(g.node_count(), g.m_connections, 1, 2);
+
+    EXPECT_EQ((std::vector<uint32_t> { 0, 3, 4, 5, 6 }), selection.selected_ids<uint32_t>());
+
+    // Only the star connection 0 - 2 is not among the two strongest of a node
+    auto pair_selection = query::top_k_selection(g.node_count(), g.m_connections, 2);
+
+    EXPECT_FALSE(pair_selection.test(2));
+    EXPECT_EQ(7u, pair_selection.count());
+}
+
+TEST(QuerySparsification, ExtractsTheDisparityBackbone)
+{
+
+    auto g = create_sparsification_test_graph();
+    auto significance = query::disparity_significance(g.node_count(), g.m_connections);
+
+    EXPECT_NEAR(std::pow(1 - 100.0 / 104.0, 4), significance[0], 1e-12);
+    EXPECT_NEAR(std::pow(1 - 1.0 / 104.0, 4), significance[3], 1e-12);
+    EXPECT_NEAR(0.36, significance[6], 1e-12);
+
+    auto selection = query::disparity_backbone_selection(g.node_count(), g.m_connections, 0.05);
+
+    EXPECT_EQ((std::vector<uint32_t> { 0 }), selection.selected_ids<uint32_t>());
+
+    ograph::OConnections<int32_t, float, int32_t> connections(
+        std::vector<int32_t> { 0, 1 }, std::vector<int32_t> { 1, 2 }, std::vector<float> { 1, 2 }, std::vector<int32_t> { 7, 8 });
+    query::SelectionBitmap second(2);
+    second.set(1);
+
+    auto filtered = query::filter_connections(connections, second);
+
+    EXPECT_EQ((std::vector<int32_t> { 8 }), std::get<0>(filtered.m_features));
+}